@@ -0,0 +1,717 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <array>
+#include <algorithm>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <chrono>
+#include <thread>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <sys/resource.h>
+
+#include "cfg.hpp"
+#include "bench-cmd.hpp"
+#include "cmd-error.hpp"
+#include "utils.hpp"
+#include "glob-pattern.hpp"
+#include "synth-trace-writer.hpp"
+#include "stats-cmd.hpp"
+#include "export-cmd.hpp"
+#include "verify-cmd.hpp"
+#include "list-pkts-cmd.hpp"
+#include "copy-pkts-cmd.hpp"
+#include "create-lttng-index-cmd.hpp"
+#include "trim-cmd.hpp"
+#include "data/trace.hpp"
+#include "data/ts.hpp"
+#include "data/ds-file.hpp"
+#include "data/pkt.hpp"
+#include "data/pkt-checkpoints-build-listener.hpp"
+
+#if defined(JACQUES_HAS_INSPECT_CMD) || defined(JACQUES_HAS_INSPECT_GUI_CMD)
+# include "inspect-common/app-state.hpp"
+# include "inspect-common/find-all-search.hpp"
+# include "inspect-common/search-query.hpp"
+# define JACQUES_BENCH_HAS_SEARCHES
+#endif
+
+namespace jacques {
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+// what a stage processed
+struct StageCounts
+{
+    Size pktCount;
+
+    // none: the stage doesn't decode event records
+    boost::optional<Size> erCount;
+
+    Size lenBytes;
+};
+
+// peak resident set size of this process so far (MiB)
+double peakRssMib()
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.;
+    }
+
+#ifdef __APPLE__
+    // bytes
+    return static_cast<double>(usage.ru_maxrss) / (1024. * 1024.);
+#else
+    // kibibytes
+    return static_cast<double>(usage.ru_maxrss) / 1024.;
+#endif
+}
+
+/*
+ * Runs the stage `name` by calling `func()`, which returns what it
+ * processed (StageCounts), and prints its duration, throughput, and the
+ * peak resident set size after it.
+ */
+template <typename FuncT>
+void runStage(const char * const name, FuncT&& func)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    const auto counts = func();
+    const auto secs = std::chrono::duration<double> {std::chrono::steady_clock::now() - begin}.count();
+    const auto perSec = [secs](const Size count) {
+        return secs > 0 ? static_cast<double>(count) / secs : 0.;
+    };
+
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed <<
+                 std::setprecision(3) << std::setw(10) << secs <<
+                 std::setprecision(0) << std::setw(14) << perSec(counts.pktCount);
+
+    if (counts.erCount) {
+        std::cout << std::setw(18) << perSec(*counts.erCount);
+    } else {
+        std::cout << std::setw(18) << "-";
+    }
+
+    std::cout << std::setprecision(1) << std::setw(10) << perSec(counts.lenBytes) / 1e6 <<
+                 std::setw(16) << peakRssMib() << std::endl;
+}
+
+/*
+ * Runs the micro-benchmark `name` by calling `func()`, which performs
+ * `opCount` operations and returns a value depending on all their
+ * results (so that the compiler can't drop them), and prints its
+ * duration and the mean duration of an operation.
+ */
+template <typename FuncT>
+void runMicroStage(const char * const name, const Size opCount, FuncT&& func)
+{
+    static volatile Size sink;
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    sink = func();
+
+    const auto secs = std::chrono::duration<double> {std::chrono::steady_clock::now() - begin}.count();
+
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed <<
+                 std::setprecision(3) << std::setw(10) << secs <<
+                 std::setprecision(0) << std::setw(14) <<
+                 (secs > 0 ? static_cast<double>(opCount) / secs : 0.) <<
+                 std::setprecision(1) << std::setw(14) <<
+                 secs * 1e9 / static_cast<double>(opCount) << std::endl;
+}
+
+/*
+ * Makes sure that a compiled GlobPattern agrees with utils::globMatch()
+ * on the patterns `patterns` and the candidates `candidates`, as well
+ * as on edge cases (escaped stars, trailing `\`, empty strings).
+ */
+void checkGlob(std::vector<std::string> candidates, std::vector<std::string> patterns)
+{
+    candidates.insert(candidates.end(), {"", "*", "\\", "a", "a*b", "a\\", "ab\\*"});
+    patterns.insert(patterns.end(), {
+        "", "\\", "a\\", "*\\", "a*\\", "\\*", "a\\*", "a\\*b", "*\\**", "\\\\",
+        "*\\\\", "ab\\\\*", "ab\\\\\\*", "**", "a**b",
+    });
+
+    for (const auto& pattern : patterns) {
+        const auto normPattern = utils::normalizeGlobPattern(pattern);
+        const GlobPattern globPattern {normPattern};
+
+        for (const auto& candidate : candidates) {
+            if (globPattern.matches(candidate) != utils::globMatch(normPattern, candidate)) {
+                std::ostringstream ss;
+
+                ss << "Compiled globbing pattern `" << normPattern << "` and " <<
+                      "utils::globMatch() disagree on `" << candidate << "`.";
+                throw CmdError {ss.str()};
+            }
+        }
+    }
+}
+
+// compares utils::globMatch() to a compiled GlobPattern
+void benchGlob()
+{
+    // event record type names and name patterns, like the ones of real traces
+    const std::vector<std::string> candidates {
+        "sched_switch", "sched_wakeup", "sched_process_fork", "irq_handler_entry",
+        "irq_handler_exit", "syscall_entry_openat", "syscall_exit_openat",
+        "lttng_ust_statedump:bin_info", "lttng_ust_statedump:build_id", "bench:event_17",
+    };
+    const std::vector<std::string> patterns {
+        "sched_switch", "sched_*", "*_exit", "*statedump*", "syscall_*_open*", "*:*_id", "*",
+    };
+    constexpr Size roundCount = 20'000;
+    const auto opCount = roundCount * patterns.size() * candidates.size();
+
+    checkGlob(candidates, patterns);
+
+    runMicroStage("glob-match", opCount, [&] {
+        Size matchCount = 0;
+
+        for (Index round = 0; round < roundCount; ++round) {
+            for (const auto& pattern : patterns) {
+                for (const auto& candidate : candidates) {
+                    matchCount += utils::globMatch(pattern, candidate);
+                }
+            }
+        }
+
+        return matchCount;
+    });
+
+    runMicroStage("glob-pattern", opCount, [&] {
+        // compiled once, like a search query or a table view does
+        std::vector<GlobPattern> globPatterns;
+        Size matchCount = 0;
+
+        for (const auto& pattern : patterns) {
+            globPatterns.emplace_back(pattern);
+        }
+
+        for (Index round = 0; round < roundCount; ++round) {
+            for (const auto& globPattern : globPatterns) {
+                for (const auto& candidate : candidates) {
+                    matchCount += globPattern.matches(candidate);
+                }
+            }
+        }
+
+        return matchCount;
+    });
+}
+
+/*
+ * The printf*() functions below are the former sprintf() and
+ * `std::string` based formatting functions, kept as references for the
+ * allocation-free ones of `utils` and Ts::format().
+ */
+std::string printfSepNumber(const long long val, const char sep, const char * const fmt = "%lld")
+{
+    std::array<char, 64> buf;
+    const auto count = std::sprintf(buf.data(), fmt, val < 0 ? -val : val);
+    Index i = 0;
+    std::string ret;
+
+    ret.reserve(count + count / 3 + 1);
+
+    for (auto at = count - 1; at >= 0; --at, ++i) {
+        if (i % 3 == 0 && i != 0) {
+            ret += sep;
+        }
+
+        ret += buf[at];
+    }
+
+    if (val < 0) {
+        ret += '-';
+    }
+
+    std::reverse(ret.begin(), ret.end());
+    return ret;
+}
+
+// `LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS` only
+std::pair<std::string, std::string> printfFormatLen(const Size lenBits)
+{
+    std::array<char, 64> buf;
+    const auto sizeBytes = lenBits / 8;
+    const auto extraBits = lenBits & 7;
+    const char *unit = "B";
+    auto val = static_cast<double>(sizeBytes);
+
+    if (sizeBytes >= 1024 * 1024 * 1024) {
+        val = static_cast<double>(sizeBytes) / (1024. * 1024 * 1024);
+        unit = "GiB";
+    } else if (sizeBytes >= 1024 * 1024) {
+        val = static_cast<double>(sizeBytes) / (1024. * 1024);
+        unit = "MiB";
+    } else if (sizeBytes >= 1024) {
+        val = static_cast<double>(sizeBytes) / 1024.;
+        unit = "KiB";
+    }
+
+    if (extraBits > 0) {
+        std::sprintf(buf.data(), "%.3f+%llu", val, extraBits);
+    } else {
+        std::sprintf(buf.data(), "%.3f", val);
+    }
+
+    return {buf.data(), unit};
+}
+
+std::pair<std::string, std::string> printfFormatNs(const long long ns, const char sep)
+{
+    constexpr auto nsInS = 1'000'000'000LL;
+    const auto absNs = std::abs(ns);
+    std::string sStr;
+
+    if (ns < 0) {
+        sStr = "-";
+    }
+
+    sStr += printfSepNumber(absNs / nsInS, sep);
+    return {sStr, printfSepNumber(absNs % nsInS, sep, "%09lld")};
+}
+
+// `TsFmtMode::LONG` only
+void printfFormatTs(char * const buf, const Size bufSize, const Ts& ts)
+{
+    const auto parts = ts.parts();
+
+    std::snprintf(buf, bufSize, "%d-%02u-%02u %02u:%02u:%02u.%09u", parts.year, parts.month,
+                  parts.day, parts.hour, parts.min, parts.sec, parts.ns);
+}
+
+/*
+ * Compares the allocation-free formatting functions, which table views
+ * use for each visible cell, to the former ones (printf*()).
+ */
+void benchFmt()
+{
+    constexpr Size opCount = 1'000'000;
+
+    // various magnitudes, so that all the units and digit counts show up
+    const auto val = [](const Index i) {
+        return static_cast<long long>(i * 104'729ULL);
+    };
+
+    const auto lenBits = [](const Index i) {
+        return static_cast<Size>(i * 8'191ULL);
+    };
+
+    const auto ns = [](const Index i) {
+        return 1'546'300'800'000'000'000LL + static_cast<long long>(i * 999'983ULL);
+    };
+
+    const auto ts = [](const Index i) {
+        return Ts {i * 999'983ULL, 1'000'000'000ULL, 1'546'300'800LL, 0};
+    };
+
+    runMicroStage("sepnum-printf", opCount, [&] {
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            len += printfSepNumber(val(i), ' ').size();
+        }
+
+        return len;
+    });
+
+    runMicroStage("sepnum-buf", opCount, [&] {
+        std::array<char, 32> buf;
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            len += utils::sepNumber(buf.data(), val(i));
+        }
+
+        return len;
+    });
+
+    runMicroStage("fmt-len-printf", opCount, [&] {
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            const auto parts = printfFormatLen(lenBits(i));
+
+            len += parts.first.size() + parts.second.size();
+        }
+
+        return len;
+    });
+
+    runMicroStage("fmt-len-buf", opCount, [&] {
+        std::array<char, 32> buf;
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            const auto unit = utils::formatLen(buf.data(), lenBits(i));
+
+            len += std::strlen(buf.data()) + std::strlen(unit);
+        }
+
+        return len;
+    });
+
+    runMicroStage("fmt-ns-printf", opCount, [&] {
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            const auto parts = printfFormatNs(ns(i), ' ');
+
+            len += parts.first.size() + parts.second.size();
+        }
+
+        return len;
+    });
+
+    runMicroStage("fmt-ns-buf", opCount, [&] {
+        std::array<char, 32> secsBuf;
+        std::array<char, 32> nsBuf;
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            const auto lens = utils::formatNs(secsBuf.data(), nsBuf.data(), ns(i), ' ');
+
+            len += lens.first + lens.second;
+        }
+
+        return len;
+    });
+
+    runMicroStage("ts-fmt-printf", opCount, [&] {
+        std::array<char, 64> buf;
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            printfFormatTs(buf.data(), buf.size(), ts(i));
+            len += std::strlen(buf.data());
+        }
+
+        return len;
+    });
+
+    runMicroStage("ts-fmt-buf", opCount, [&] {
+        std::array<char, 64> buf;
+        Size len = 0;
+
+        for (Index i = 0; i < opCount; ++i) {
+            ts(i).format(buf.data(), buf.size());
+            len += std::strlen(buf.data());
+        }
+
+        return len;
+    });
+}
+
+// discards everything
+class NullStreamBuf final :
+    public std::streambuf
+{
+protected:
+    int overflow(const int ch) override
+    {
+        return ch;
+    }
+
+    std::streamsize xsputn(const char *, const std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+// discards the standard output of a command while it exists
+class StdoutDiscarder final :
+    boost::noncopyable
+{
+public:
+    explicit StdoutDiscarder() :
+        _origBuf {std::cout.rdbuf(&_nullBuf)}
+    {
+    }
+
+    ~StdoutDiscarder()
+    {
+        std::cout.rdbuf(_origBuf);
+    }
+
+private:
+    NullStreamBuf _nullBuf;
+    std::streambuf *_origBuf;
+};
+
+// work directory, removed on destruction if temporary
+class WorkDir final :
+    boost::noncopyable
+{
+public:
+    explicit WorkDir(const boost::optional<bfs::path>& path) :
+        _isTmp {!path}
+    {
+        if (path) {
+            _path = *path;
+        } else {
+            _path = bfs::temp_directory_path() / bfs::unique_path("jacques-bench-%%%%-%%%%-%%%%");
+        }
+
+        bfs::create_directories(_path);
+    }
+
+    ~WorkDir()
+    {
+        if (_isTmp) {
+            boost::system::error_code ec;
+
+            bfs::remove_all(_path, ec);
+        }
+    }
+
+    const bfs::path& path() const noexcept
+    {
+        return _path;
+    }
+
+private:
+    bfs::path _path;
+    bool _isTmp;
+};
+
+class NullPktCheckpointsBuildListener final :
+    public PktCheckpointsBuildListener
+{
+};
+
+#ifdef JACQUES_BENCH_HAS_SEARCHES
+// runs a "find all" search for `query` to completion
+StageCounts findAll(const AppState& appState, const SearchQuery& query,
+                    const unsigned int threadCount, const StageCounts& traceCounts)
+{
+    FindAllSearch search {appState, query, threadCount};
+
+    while (!search.isDone()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds {1});
+    }
+
+    return {traceCounts.pktCount, search.resultCount(), traceCounts.lenBytes};
+}
+#endif
+
+} // namespace
+
+void benchCmd(const BenchCfg& cfg)
+{
+    // declared first: removed last, when nothing has an open file in it
+    const WorkDir workDir {cfg.workDir()};
+    const auto traceDir = workDir.path() / "trace";
+    const SynthTraceParams params {
+        cfg.dsFileCount(), cfg.pktCountPerDsFile(), cfg.pktLenBytes(),
+        cfg.ertCount(), cfg.erLenBytes(), cfg.corruptPktCount(),
+    };
+    std::vector<bfs::path> dsFilePaths;
+
+    for (Index i = 0; i < cfg.dsFileCount(); ++i) {
+        dsFilePaths.push_back(traceDir / ("stream_" + std::to_string(i)));
+    }
+
+    bfs::create_directories(traceDir);
+    std::cout << std::left << std::setw(20) << "Stage" << std::right <<
+                 std::setw(10) << "Time (s)" << std::setw(14) << "Packets/s" <<
+                 std::setw(18) << "Event records/s" << std::setw(10) << "MB/s" <<
+                 std::setw(16) << "Peak RSS (MiB)" << std::endl;
+
+    SynthTraceInfo traceInfo {};
+
+    runStage("generate", [&] {
+        traceInfo = writeSynthTrace(traceDir, params);
+        return StageCounts {traceInfo.pktCount, traceInfo.erCount, traceInfo.dsFilesLenBytes};
+    });
+
+    const StageCounts traceCounts {
+        traceInfo.pktCount, traceInfo.erCount, traceInfo.dsFilesLenBytes
+    };
+
+    {
+        std::unique_ptr<Trace> trace;
+
+        runStage("index", [&] {
+            trace = std::make_unique<Trace>(dsFilePaths);
+
+            for (auto& dsFile : trace->dsFiles()) {
+                dsFile->buildIndex();
+            }
+
+            return StageCounts {traceCounts.pktCount, boost::none, traceCounts.lenBytes};
+        });
+
+        NullPktCheckpointsBuildListener listener;
+
+        // creating a packet builds its checkpoints
+        runStage("checkpoints", [&] {
+            Size erCount = 0;
+
+            for (auto& dsFile : trace->dsFiles()) {
+                for (Index pktIndex = 0; pktIndex < dsFile->pktCount(); ++pktIndex) {
+                    erCount += dsFile->pktAtIndex(pktIndex, listener).erCount();
+                }
+            }
+
+            return StageCounts {traceCounts.pktCount, erCount, traceCounts.lenBytes};
+        });
+
+        // visit all the regions of all the packets, in order
+        runStage("regions", [&] {
+            Size erCount = 0;
+
+            for (auto& dsFile : trace->dsFiles()) {
+                for (Index pktIndex = 0; pktIndex < dsFile->pktCount(); ++pktIndex) {
+                    auto& pkt = dsFile->pktAtIndex(pktIndex, listener);
+                    const auto lenBits = pkt.indexEntry().effectiveTotalLen().bits();
+                    Index offsetInPktBits = 0;
+
+                    while (offsetInPktBits < lenBits) {
+                        const auto& region = pkt.regionAtOffsetInPktBits(offsetInPktBits);
+                        const auto endOffsetInPktBits = region.segment().endOffsetInPktBits();
+
+                        if (!endOffsetInPktBits) {
+                            break;
+                        }
+
+                        offsetInPktBits = *endOffsetInPktBits;
+                    }
+
+                    erCount += pkt.erCount();
+                }
+            }
+
+            return StageCounts {traceCounts.pktCount, erCount, traceCounts.lenBytes};
+        });
+    }
+
+#ifdef JACQUES_BENCH_HAS_SEARCHES
+    {
+        NullPktCheckpointsBuildListener listener;
+        AppState appState {dsFilePaths, listener};
+
+        for (auto& dsFileState : appState.dsFileStates()) {
+            dsFileState->dsFile().buildIndex();
+        }
+
+        runStage("find-all-name", [&] {
+            return findAll(appState, ErtNameSearchQuery {"bench:*"}, cfg.threadCount(),
+                           traceCounts);
+        });
+
+        runStage("find-all-id", [&] {
+            return findAll(appState, ErtIdSearchQuery {0}, cfg.threadCount(), traceCounts);
+        });
+    }
+#endif
+
+    runStage("stats", [&] {
+        const StdoutDiscarder discarder;
+
+        statsCmd(StatsCfg {dsFilePaths, StatsCfg::Fmt::CSV, 1000000000ULL, cfg.threadCount()});
+        return traceCounts;
+    });
+
+    const auto runExportStage = [&](const char * const name, const ExportCfg::Fmt fmt) {
+        runStage(name, [&] {
+            exportCmd(ExportCfg {
+                dsFilePaths, fmt, boost::none, boost::none, bfs::path {"/dev/null"},
+                cfg.threadCount()
+            });
+
+            return traceCounts;
+        });
+    };
+
+    runExportStage("export-csv", ExportCfg::Fmt::CSV);
+    runExportStage("export-jsonl", ExportCfg::Fmt::JSON_LINES);
+
+    runStage("verify", [&] {
+        const StdoutDiscarder discarder;
+
+        try {
+            verifyCmd(VerifyCfg {dsFilePaths, cfg.threadCount()});
+        } catch (const CmdError&) {
+            // expected with corrupt packets
+            if (cfg.corruptPktCount() == 0) {
+                throw;
+            }
+        }
+
+        return traceCounts;
+    });
+
+    // the commands below which work on a single data stream file use the first one
+    const auto& firstDsFilePath = dsFilePaths.front();
+    const StageCounts firstDsFileCounts {
+        cfg.pktCountPerDsFile(), boost::none, static_cast<Size>(bfs::file_size(firstDsFilePath))
+    };
+
+    runStage("list-packets", [&] {
+        const StdoutDiscarder discarder;
+
+        listPktsCmd(ListPktsCfg {firstDsFilePath, ListPktsCfg::Fmt::MACHINE, true});
+        return firstDsFileCounts;
+    });
+
+    runStage("copy-packets", [&] {
+        // all the packets, in order
+        copyPktsCmd(CopyPktsCfg {firstDsFilePath, "1..:1", workDir.path() / "copy"});
+        return firstDsFileCounts;
+    });
+
+    runStage("create-lttng-index", [&] {
+        createLttngIndexCmd(CreateLttngIndexCfg {dsFilePaths});
+        return StageCounts {traceCounts.pktCount, boost::none, traceCounts.lenBytes};
+    });
+
+    runStage("trim", [&] {
+        // whole time range: copies all the packets
+        trimCmd(TrimCfg {
+            traceDir, dsFilePaths, workDir.path() / "trim",
+            std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max(),
+            cfg.threadCount()
+        });
+
+        return StageCounts {traceCounts.pktCount, boost::none, traceCounts.lenBytes};
+    });
+
+    std::cout << std::endl << "Trace: " << cfg.dsFileCount() << " data stream file(s), " <<
+                 traceInfo.pktCount << " packet(s), " << traceInfo.erCount <<
+                 " event record(s), " << traceInfo.dsFilesLenBytes << " byte(s)";
+
+    if (cfg.workDir()) {
+        std::cout << " (`" << traceDir.string() << "`)";
+    }
+
+    std::cout << "." << std::endl << std::endl;
+    std::cout << std::left << std::setw(20) << "Micro-benchmark" << std::right <<
+                 std::setw(10) << "Time (s)" << std::setw(14) << "Operations/s" <<
+                 std::setw(14) << "ns/operation" << std::endl;
+    benchGlob();
+    benchFmt();
+}
+
+} // namespace jacques
@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_BENCH_CMD_HPP
+#define _JACQUES_BENCH_CMD_HPP
+
+#include "cfg.hpp"
+
+namespace jacques {
+
+void benchCmd(const BenchCfg& cfg);
+
+} // namespace jacques
+
+#endif // _JACQUES_BENCH_CMD_HPP
@@ -9,15 +9,19 @@
 #include <boost/filesystem.hpp>
 #include <boost/range/iterator_range.hpp>
 #include <sstream>
+#include <regex>
 #include <algorithm>
 #include <iterator>
 #include <cstdlib>
+#include <limits>
 #include <unordered_set>
 #include <iostream>
 #include <cassert>
+#include <cstdint>
 
 #include "cfg.hpp"
 #include "utils.hpp"
+#include "synth-trace-writer.hpp"
 
 namespace jacques {
 
@@ -63,6 +67,61 @@ CreateLttngIndexCfg::CreateLttngIndexCfg(std::vector<bfs::path> paths) :
 {
 }
 
+StatsCfg::StatsCfg(std::vector<bfs::path> paths, const Fmt fmt,
+                   const unsigned long long bucketDurationNs, const unsigned int threadCount) :
+    _paths {std::move(paths)},
+    _fmt {fmt},
+    _bucketDurationNs {bucketDurationNs},
+    _threadCount {threadCount}
+{
+}
+
+ExportCfg::ExportCfg(std::vector<bfs::path> paths, const Fmt fmt,
+                     boost::optional<std::string> ertNamePattern,
+                     boost::optional<unsigned long long> ertId,
+                     boost::optional<bfs::path> outputPath, const unsigned int threadCount) :
+    _paths {std::move(paths)},
+    _fmt {fmt},
+    _ertNamePattern {std::move(ertNamePattern)},
+    _ertId {std::move(ertId)},
+    _outputPath {std::move(outputPath)},
+    _threadCount {threadCount}
+{
+}
+
+TrimCfg::TrimCfg(bfs::path traceDir, std::vector<bfs::path> dsFilePaths, bfs::path outDir,
+                 const long long beginNsFromOrigin, const long long endNsFromOrigin,
+                 const unsigned int threadCount) :
+    _traceDir {std::move(traceDir)},
+    _dsFilePaths {std::move(dsFilePaths)},
+    _outDir {std::move(outDir)},
+    _beginNsFromOrigin {beginNsFromOrigin},
+    _endNsFromOrigin {endNsFromOrigin},
+    _threadCount {threadCount}
+{
+}
+
+VerifyCfg::VerifyCfg(std::vector<bfs::path> paths, const unsigned int threadCount) :
+    _paths {std::move(paths)},
+    _threadCount {threadCount}
+{
+}
+
+BenchCfg::BenchCfg(boost::optional<bfs::path> workDir, const Size dsFileCount,
+                   const Size pktCountPerDsFile, const Size pktLenBytes, const Size ertCount,
+                   const Size erLenBytes, const Size corruptPktCount,
+                   const unsigned int threadCount) :
+    _workDir {std::move(workDir)},
+    _dsFileCount {dsFileCount},
+    _pktCountPerDsFile {pktCountPerDsFile},
+    _pktLenBytes {pktLenBytes},
+    _ertCount {ertCount},
+    _erLenBytes {erLenBytes},
+    _corruptPktCount {corruptPktCount},
+    _threadCount {threadCount}
+{
+}
+
 namespace {
 
 void expandDir(std::list<bfs::path>& tmpFilePaths, const bfs::path& path)
@@ -342,6 +401,415 @@ std::unique_ptr<const Cfg> copyPktsCfgFromArgs(const std::vector<std::string>& a
                                          std::move(dstPath));
 }
 
+std::unique_ptr<const Cfg> statsCfgFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDescr {""};
+
+    optDescr.add_options()
+        ("format,f", bpo::value<std::string>(), "")
+        ("bucket-duration,b", bpo::value<unsigned long long>(), "")
+        ("threads,j", bpo::value<unsigned int>(), "")
+        ("paths", bpo::value<std::vector<std::string>>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("paths", -1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDescr).positional(posDesc).run(), vm);
+    } catch (const bpo::error& exc) {
+        throw CliError {exc.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    auto fmt = StatsCfg::Fmt::CSV;
+
+    if (vm.count("format") > 0) {
+        const auto& fmtStr = vm["format"].as<std::string>();
+
+        if (fmtStr == "json") {
+            fmt = StatsCfg::Fmt::JSON;
+        } else if (fmtStr != "csv") {
+            std::ostringstream ss;
+
+            ss << "Unknown output format `" << fmtStr << "` (expecting `csv` or `json`).";
+            throw CliError {ss.str()};
+        }
+    }
+
+    // one second
+    unsigned long long bucketDurationNs = 1000000000ULL;
+
+    if (vm.count("bucket-duration") > 0) {
+        bucketDurationNs = vm["bucket-duration"].as<unsigned long long>();
+
+        if (bucketDurationNs == 0 ||
+                bucketDurationNs > static_cast<unsigned long long>(std::numeric_limits<long long>::max())) {
+            throw CliError {"Invalid bucket duration."};
+        }
+    }
+
+    unsigned int threadCount = 0;
+
+    if (vm.count("threads") > 0) {
+        threadCount = vm["threads"].as<unsigned int>();
+    }
+
+    if (vm.count("paths") == 0) {
+        throw CliError {"Missing trace directory path or data stream file path."};
+    }
+
+    auto expandedPaths = getExpandedPaths(vm["paths"].as<std::vector<std::string>>());
+
+    if (expandedPaths.front().filename() == "metadata") {
+        throw CliError {"Cannot specify CTF metadata file."};
+    }
+
+    return std::make_unique<StatsCfg>(std::move(expandedPaths), fmt, bucketDurationNs,
+                                      threadCount);
+}
+
+std::unique_ptr<const Cfg> exportCfgFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDescr {""};
+
+    optDescr.add_options()
+        ("format,f", bpo::value<std::string>(), "")
+        ("name,n", bpo::value<std::string>(), "")
+        ("id,i", bpo::value<unsigned long long>(), "")
+        ("output,o", bpo::value<std::string>(), "")
+        ("threads,j", bpo::value<unsigned int>(), "")
+        ("paths", bpo::value<std::vector<std::string>>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("paths", -1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDescr).positional(posDesc).run(), vm);
+    } catch (const bpo::error& exc) {
+        throw CliError {exc.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    auto fmt = ExportCfg::Fmt::CSV;
+
+    if (vm.count("format") > 0) {
+        const auto& fmtStr = vm["format"].as<std::string>();
+
+        if (fmtStr == "jsonl") {
+            fmt = ExportCfg::Fmt::JSON_LINES;
+        } else if (fmtStr != "csv") {
+            std::ostringstream ss;
+
+            ss << "Unknown output format `" << fmtStr <<
+                  "` (expecting `csv` or `jsonl`).";
+            throw CliError {ss.str()};
+        }
+    }
+
+    boost::optional<std::string> ertNamePattern;
+    boost::optional<unsigned long long> ertId;
+    boost::optional<bfs::path> outputPath;
+    unsigned int threadCount = 0;
+
+    if (vm.count("name") > 0) {
+        ertNamePattern = vm["name"].as<std::string>();
+    }
+
+    if (vm.count("id") > 0) {
+        ertId = vm["id"].as<unsigned long long>();
+    }
+
+    if (vm.count("output") > 0) {
+        outputPath = bfs::path {vm["output"].as<std::string>()};
+    }
+
+    if (vm.count("threads") > 0) {
+        threadCount = vm["threads"].as<unsigned int>();
+    }
+
+    if (vm.count("paths") == 0) {
+        throw CliError {"Missing trace directory path or data stream file path."};
+    }
+
+    auto expandedPaths = getExpandedPaths(vm["paths"].as<std::vector<std::string>>());
+
+    if (expandedPaths.front().filename() == "metadata") {
+        throw CliError {"Cannot specify CTF metadata file."};
+    }
+
+    if (outputPath &&
+            std::find(expandedPaths.begin(), expandedPaths.end(), *outputPath) != expandedPaths.end()) {
+        std::ostringstream ss;
+
+        ss << "Output file is also an input data stream file: `" << outputPath->string() << "`.";
+        throw CliError {ss.str()};
+    }
+
+    return std::make_unique<ExportCfg>(std::move(expandedPaths), fmt, std::move(ertNamePattern),
+                                       std::move(ertId), std::move(outputPath), threadCount);
+}
+
+/*
+ * Parses a time from origin: nanoseconds if `str` is an integer, or
+ * seconds if it contains a fractional part (at most nine digits).
+ */
+long long parseNsFromOrigin(const std::string& str)
+{
+    const std::regex re {"^(-?)(\\d+)(\\.(\\d{0,9}))?$"};
+    std::smatch matchRes;
+
+    if (!std::regex_match(str, matchRes, re)) {
+        std::ostringstream ss;
+
+        ss << "Invalid time `" << str << "`.";
+        throw CliError {ss.str()};
+    }
+
+    try {
+        auto ns = std::stoll(matchRes[2]);
+
+        if (matchRes[3].matched) {
+            auto fracStr = matchRes[4].str();
+
+            fracStr.resize(9, '0');
+
+            if (ns > std::numeric_limits<long long>::max() / 1000000000LL - 1) {
+                throw std::out_of_range {"seconds"};
+            }
+
+            ns = ns * 1000000000LL + std::stoll(fracStr);
+        }
+
+        return matchRes[1].length() > 0 ? -ns : ns;
+    } catch (const std::out_of_range&) {
+        std::ostringstream ss;
+
+        ss << "Time `" << str << "` is out of range.";
+        throw CliError {ss.str()};
+    }
+}
+
+std::unique_ptr<const Cfg> trimCfgFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDescr {""};
+
+    optDescr.add_options()
+        ("begin,b", bpo::value<std::string>(), "")
+        ("end,e", bpo::value<std::string>(), "")
+        ("threads,j", bpo::value<unsigned int>(), "")
+        ("trace-dir", bpo::value<std::string>(), "")
+        ("out-dir", bpo::value<std::string>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("trace-dir", 1).add("out-dir", 1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDescr).positional(posDesc).run(), vm);
+    } catch (const bpo::error& exc) {
+        throw CliError {exc.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    auto beginNsFromOrigin = std::numeric_limits<long long>::min();
+    auto endNsFromOrigin = std::numeric_limits<long long>::max();
+    unsigned int threadCount = 0;
+
+    if (vm.count("begin") > 0) {
+        beginNsFromOrigin = parseNsFromOrigin(vm["begin"].as<std::string>());
+    }
+
+    if (vm.count("end") > 0) {
+        endNsFromOrigin = parseNsFromOrigin(vm["end"].as<std::string>());
+    }
+
+    if (beginNsFromOrigin > endNsFromOrigin) {
+        throw CliError {"Beginning time is greater than end time."};
+    }
+
+    if (vm.count("threads") > 0) {
+        threadCount = vm["threads"].as<unsigned int>();
+    }
+
+    if (vm.count("trace-dir") == 0) {
+        throw CliError {"Missing trace directory path."};
+    }
+
+    if (vm.count("out-dir") == 0) {
+        throw CliError {"Missing output directory path."};
+    }
+
+    auto traceDir = bfs::path {vm["trace-dir"].as<std::string>()};
+    auto outDir = bfs::path {vm["out-dir"].as<std::string>()};
+
+    if (!bfs::is_directory(traceDir)) {
+        std::ostringstream ss;
+
+        ss << "`" << traceDir.string() << "` is not a directory.";
+        throw CliError {ss.str()};
+    }
+
+    if (bfs::exists(outDir) && (!bfs::is_directory(outDir) || !bfs::is_empty(outDir))) {
+        std::ostringstream ss;
+
+        ss << "Output directory `" << outDir.string() << "` exists and is not empty.";
+        throw CliError {ss.str()};
+    }
+
+    auto dsFilePaths = getExpandedPaths({traceDir.string()});
+
+    return std::make_unique<TrimCfg>(std::move(traceDir), std::move(dsFilePaths),
+                                     std::move(outDir), beginNsFromOrigin, endNsFromOrigin,
+                                     threadCount);
+}
+
+std::unique_ptr<const Cfg> verifyCfgFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDescr {""};
+
+    optDescr.add_options()
+        ("threads,j", bpo::value<unsigned int>(), "")
+        ("paths", bpo::value<std::vector<std::string>>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("paths", -1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDescr).positional(posDesc).run(), vm);
+    } catch (const bpo::error& exc) {
+        throw CliError {exc.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    unsigned int threadCount = 0;
+
+    if (vm.count("threads") > 0) {
+        threadCount = vm["threads"].as<unsigned int>();
+    }
+
+    if (vm.count("paths") == 0) {
+        throw CliError {"Missing trace directory path or data stream file path."};
+    }
+
+    auto expandedPaths = getExpandedPaths(vm["paths"].as<std::vector<std::string>>());
+
+    if (expandedPaths.front().filename() == "metadata") {
+        throw CliError {"Cannot specify CTF metadata file."};
+    }
+
+    return std::make_unique<VerifyCfg>(std::move(expandedPaths), threadCount);
+}
+
+std::unique_ptr<const Cfg> benchCfgFromArgs(const std::vector<std::string>& args)
+{
+    bpo::options_description optDescr {""};
+
+    optDescr.add_options()
+        ("streams", bpo::value<unsigned long long>(), "")
+        ("packets", bpo::value<unsigned long long>(), "")
+        ("packet-size", bpo::value<unsigned long long>(), "")
+        ("ert-count", bpo::value<unsigned long long>(), "")
+        ("er-size", bpo::value<unsigned long long>(), "")
+        ("corrupt", bpo::value<unsigned long long>(), "")
+        ("threads,j", bpo::value<unsigned int>(), "")
+        ("work-dir", bpo::value<std::string>(), "");
+
+    bpo::positional_options_description posDesc;
+
+    posDesc.add("work-dir", 1);
+
+    bpo::variables_map vm;
+
+    try {
+        bpo::store(bpo::command_line_parser(args).options(optDescr).positional(posDesc).run(), vm);
+    } catch (const bpo::error& exc) {
+        throw CliError {exc.what()};
+    } catch (...) {
+        std::abort();
+    }
+
+    const auto optVal = [&vm](const char * const name, const unsigned long long defVal) {
+        return vm.count(name) > 0 ? vm[name].as<unsigned long long>() : defVal;
+    };
+
+    // 4 data stream files of 16 MiB
+    const auto dsFileCount = optVal("streams", 4);
+    const auto pktCountPerDsFile = optVal("packets", 256);
+    const auto pktLenBytes = optVal("packet-size", 65536);
+    const auto ertCount = optVal("ert-count", 16);
+    const auto erLenBytes = optVal("er-size", 64);
+    const auto corruptPktCount = optVal("corrupt", 0);
+    unsigned int threadCount = 0;
+
+    if (dsFileCount == 0) {
+        throw CliError {"Invalid data stream file count."};
+    }
+
+    if (pktCountPerDsFile == 0) {
+        throw CliError {"Invalid packet count."};
+    }
+
+    if (ertCount == 0 || ertCount > std::numeric_limits<std::uint32_t>::max()) {
+        throw CliError {"Invalid event record type count."};
+    }
+
+    if (erLenBytes < minSynthErLenBytes) {
+        std::ostringstream ss;
+
+        ss << "Event record size must be at least " << minSynthErLenBytes << " bytes.";
+        throw CliError {ss.str()};
+    }
+
+    if (pktLenBytes < synthPktPreambleLenBytes + erLenBytes) {
+        std::ostringstream ss;
+
+        ss << "Packet size must be at least " << synthPktPreambleLenBytes + erLenBytes <<
+              " bytes (one event record).";
+        throw CliError {ss.str()};
+    }
+
+    if (corruptPktCount > dsFileCount * pktCountPerDsFile) {
+        throw CliError {"Cannot corrupt more packets than the trace contains."};
+    }
+
+    if (vm.count("threads") > 0) {
+        threadCount = vm["threads"].as<unsigned int>();
+    }
+
+    boost::optional<bfs::path> workDir;
+
+    if (vm.count("work-dir") > 0) {
+        workDir = bfs::path {vm["work-dir"].as<std::string>()};
+
+        if (bfs::exists(*workDir) && (!bfs::is_directory(*workDir) ||
+                                      !bfs::is_empty(*workDir))) {
+            std::ostringstream ss;
+
+            ss << "Work directory `" << workDir->string() << "` exists and is not empty.";
+            throw CliError {ss.str()};
+        }
+    }
+
+    return std::make_unique<BenchCfg>(std::move(workDir), dsFileCount, pktCountPerDsFile,
+                                      pktLenBytes, ertCount, erLenBytes, corruptPktCount,
+                                      threadCount);
+}
+
 } // namespace
 
 std::unique_ptr<const Cfg> cfgFromArgs(const int argc, const char *argv[])
@@ -385,9 +853,17 @@ std::unique_ptr<const Cfg> cfgFromArgs(const int argc, const char *argv[])
         constexpr const char *listPktsCmdName = "list-packets";
         constexpr const char *copyPktsCmdName = "copy-packets";
         constexpr const char *createLttngIndexCmdName = "create-lttng-index";
+        constexpr const char *statsCmdName = "stats";
+        constexpr const char *exportCmdName = "export";
+        constexpr const char *trimCmdName = "trim";
+        constexpr const char *verifyCmdName = "verify";
+        constexpr const char *benchCmdName = "bench";
 
         if (args[0] == "inspect" || args[0] == listPktsCmdName ||
-                args[0] == copyPktsCmdName || args[0] == createLttngIndexCmdName) {
+                args[0] == copyPktsCmdName || args[0] == createLttngIndexCmdName ||
+                args[0] == statsCmdName || args[0] == exportCmdName ||
+                args[0] == trimCmdName || args[0] == verifyCmdName ||
+                args[0] == benchCmdName) {
             removeCmdName = true;
         }
 
@@ -404,6 +880,16 @@ std::unique_ptr<const Cfg> cfgFromArgs(const int argc, const char *argv[])
             return copyPktsCfgFromArgs(extraArgs);
         } else if (args[0] == createLttngIndexCmdName) {
             return createLttngIndexCfgFromArgs(extraArgs);
+        } else if (args[0] == statsCmdName) {
+            return statsCfgFromArgs(extraArgs);
+        } else if (args[0] == exportCmdName) {
+            return exportCfgFromArgs(extraArgs);
+        } else if (args[0] == trimCmdName) {
+            return trimCfgFromArgs(extraArgs);
+        } else if (args[0] == verifyCmdName) {
+            return verifyCfgFromArgs(extraArgs);
+        } else if (args[0] == benchCmdName) {
+            return benchCfgFromArgs(extraArgs);
         }
 
         // `inspect` command is the default
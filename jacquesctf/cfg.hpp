@@ -13,6 +13,9 @@
 #include <memory>
 #include <stdexcept>
 #include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include "aliases.hpp"
 
 namespace jacques {
 
@@ -146,6 +149,239 @@ private:
     const std::vector<boost::filesystem::path> _paths;
 };
 
+class StatsCfg final :
+    public Cfg
+{
+public:
+    enum class Fmt {
+        CSV,
+        JSON,
+    };
+
+public:
+    explicit StatsCfg(std::vector<boost::filesystem::path> paths, Fmt format,
+                      unsigned long long bucketDurationNs, unsigned int threadCount);
+
+    const std::vector<boost::filesystem::path>& paths() const noexcept
+    {
+        return _paths;
+    }
+
+    Fmt format() const noexcept
+    {
+        return _fmt;
+    }
+
+    unsigned long long bucketDurationNs() const noexcept
+    {
+        return _bucketDurationNs;
+    }
+
+    // 0 means the number of hardware threads
+    unsigned int threadCount() const noexcept
+    {
+        return _threadCount;
+    }
+
+private:
+    const std::vector<boost::filesystem::path> _paths;
+    Fmt _fmt;
+    unsigned long long _bucketDurationNs;
+    unsigned int _threadCount;
+};
+
+class ExportCfg final :
+    public Cfg
+{
+public:
+    enum class Fmt {
+        CSV,
+        JSON_LINES,
+    };
+
+public:
+    explicit ExportCfg(std::vector<boost::filesystem::path> paths, Fmt format,
+                       boost::optional<std::string> ertNamePattern,
+                       boost::optional<unsigned long long> ertId,
+                       boost::optional<boost::filesystem::path> outputPath,
+                       unsigned int threadCount);
+
+    const std::vector<boost::filesystem::path>& paths() const noexcept
+    {
+        return _paths;
+    }
+
+    Fmt format() const noexcept
+    {
+        return _fmt;
+    }
+
+    // only export the event records having a matching type name
+    const boost::optional<std::string>& ertNamePattern() const noexcept
+    {
+        return _ertNamePattern;
+    }
+
+    // only export the event records having this type ID
+    const boost::optional<unsigned long long>& ertId() const noexcept
+    {
+        return _ertId;
+    }
+
+    // standard output if not set
+    const boost::optional<boost::filesystem::path>& outputPath() const noexcept
+    {
+        return _outputPath;
+    }
+
+    // 0 means the number of hardware threads
+    unsigned int threadCount() const noexcept
+    {
+        return _threadCount;
+    }
+
+private:
+    const std::vector<boost::filesystem::path> _paths;
+    Fmt _fmt;
+    boost::optional<std::string> _ertNamePattern;
+    boost::optional<unsigned long long> _ertId;
+    boost::optional<boost::filesystem::path> _outputPath;
+    unsigned int _threadCount;
+};
+
+class TrimCfg final :
+    public Cfg
+{
+public:
+    explicit TrimCfg(boost::filesystem::path traceDir,
+                     std::vector<boost::filesystem::path> dsFilePaths,
+                     boost::filesystem::path outDir, long long beginNsFromOrigin,
+                     long long endNsFromOrigin, unsigned int threadCount);
+
+    const boost::filesystem::path& traceDir() const noexcept
+    {
+        return _traceDir;
+    }
+
+    // all the data stream files found recursively in traceDir()
+    const std::vector<boost::filesystem::path>& dsFilePaths() const noexcept
+    {
+        return _dsFilePaths;
+    }
+
+    const boost::filesystem::path& outDir() const noexcept
+    {
+        return _outDir;
+    }
+
+    long long beginNsFromOrigin() const noexcept
+    {
+        return _beginNsFromOrigin;
+    }
+
+    long long endNsFromOrigin() const noexcept
+    {
+        return _endNsFromOrigin;
+    }
+
+    // 0 means the number of hardware threads
+    unsigned int threadCount() const noexcept
+    {
+        return _threadCount;
+    }
+
+private:
+    const boost::filesystem::path _traceDir;
+    const std::vector<boost::filesystem::path> _dsFilePaths;
+    const boost::filesystem::path _outDir;
+    long long _beginNsFromOrigin;
+    long long _endNsFromOrigin;
+    unsigned int _threadCount;
+};
+
+class VerifyCfg final :
+    public Cfg
+{
+public:
+    explicit VerifyCfg(std::vector<boost::filesystem::path> paths, unsigned int threadCount);
+
+    const std::vector<boost::filesystem::path>& paths() const noexcept
+    {
+        return _paths;
+    }
+
+    // 0 means the number of hardware threads
+    unsigned int threadCount() const noexcept
+    {
+        return _threadCount;
+    }
+
+private:
+    const std::vector<boost::filesystem::path> _paths;
+    unsigned int _threadCount;
+};
+
+class BenchCfg final :
+    public Cfg
+{
+public:
+    explicit BenchCfg(boost::optional<boost::filesystem::path> workDir, Size dsFileCount,
+                      Size pktCountPerDsFile, Size pktLenBytes, Size ertCount,
+                      Size erLenBytes, Size corruptPktCount, unsigned int threadCount);
+
+    // directory in which to write the synthetic trace (none: temporary)
+    const boost::optional<boost::filesystem::path>& workDir() const noexcept
+    {
+        return _workDir;
+    }
+
+    Size dsFileCount() const noexcept
+    {
+        return _dsFileCount;
+    }
+
+    Size pktCountPerDsFile() const noexcept
+    {
+        return _pktCountPerDsFile;
+    }
+
+    Size pktLenBytes() const noexcept
+    {
+        return _pktLenBytes;
+    }
+
+    Size ertCount() const noexcept
+    {
+        return _ertCount;
+    }
+
+    Size erLenBytes() const noexcept
+    {
+        return _erLenBytes;
+    }
+
+    Size corruptPktCount() const noexcept
+    {
+        return _corruptPktCount;
+    }
+
+    // 0 means the number of hardware threads
+    unsigned int threadCount() const noexcept
+    {
+        return _threadCount;
+    }
+
+private:
+    const boost::optional<boost::filesystem::path> _workDir;
+    Size _dsFileCount;
+    Size _pktCountPerDsFile;
+    Size _pktLenBytes;
+    Size _ertCount;
+    Size _erLenBytes;
+    Size _corruptPktCount;
+    unsigned int _threadCount;
+};
+
 class PrintCliUsageCfg final :
     public Cfg
 {
@@ -147,6 +147,10 @@ void copyPktsCmd(const CopyPktsCfg& cfg)
     Trace trace {{cfg.srcPath()}};
     auto& dsf = *trace.dsFiles().front();
 
+    if (dsf.isCompressed()) {
+        throw CmdError {"Cannot copy packets of a compressed data stream file."};
+    }
+
     dsf.buildIndex();
 
     if (dsf.pktCount() == 0) {
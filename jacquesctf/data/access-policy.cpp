@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "access-policy.hpp"
+
+namespace jacques {
+namespace {
+
+// consecutive moves to neighbouring granules to make a pattern
+constexpr long long seqStreakLen = 3;
+
+// consecutive jumps to make the pattern random
+constexpr Size randomStreakLen = 2;
+
+} // namespace
+
+AccessPolicy::AccessPolicy(const Size fileLenBytes, const Size granuleLenBytes,
+                           const Size minPrefetchLenBytes, const Size maxPrefetchLenBytes,
+                           const Size keepLenBytes) :
+    _fileLenBytes {fileLenBytes},
+    _granuleLenBytes {granuleLenBytes},
+    _minPrefetchLenBytes {minPrefetchLenBytes},
+    _maxPrefetchLenBytes {maxPrefetchLenBytes},
+    _keepLenBytes {keepLenBytes},
+    _prefetchLenBytes {minPrefetchLenBytes}
+{
+    assert(granuleLenBytes > 0);
+    assert(minPrefetchLenBytes <= maxPrefetchLenBytes);
+}
+
+void AccessPolicy::access(const Index offsetBytes, const Size lenBytes, Hints& hints)
+{
+    const auto granule = offsetBytes / _granuleLenBytes;
+
+    if (!_hasLastAccess) {
+        _hasLastAccess = true;
+        _lastGranule = granule;
+        return;
+    }
+
+    if (granule == _lastGranule) {
+        // same neighbourhood: nothing new
+        return;
+    }
+
+    // a move within the prefetch distance is a step, not a jump
+    const auto maxStepGranules = std::max(_maxPrefetchLenBytes / _granuleLenBytes, 1ULL);
+
+    if (granule > _lastGranule && granule - _lastGranule <= maxStepGranules) {
+        _streak = std::max(_streak, 0LL) + 1;
+        _randomStreak = 0;
+    } else if (granule < _lastGranule && _lastGranule - granule <= maxStepGranules) {
+        _streak = std::min(_streak, 0LL) - 1;
+        _randomStreak = 0;
+    } else {
+        _streak = 0;
+        ++_randomStreak;
+    }
+
+    _lastGranule = granule;
+
+    const auto endOffsetBytes = std::min(offsetBytes + lenBytes, _fileLenBytes);
+
+    if (_streak == seqStreakLen || _streak == -seqStreakLen) {
+        // new run: start from here
+        _prefetchLenBytes = _minPrefetchLenBytes;
+
+        if (_streak > 0) {
+            _prefetchEdgeOffsetBytes = endOffsetBytes;
+            _releaseEdgeOffsetBytes = offsetBytes;
+            this->_setPattern(Pattern::SEQUENTIAL, hints);
+        } else {
+            _prefetchEdgeOffsetBytes = offsetBytes;
+            _releaseEdgeOffsetBytes = endOffsetBytes;
+            this->_setPattern(Pattern::BACKWARD, hints);
+        }
+    }
+
+    if (_streak >= seqStreakLen) {
+        this->_prefetchForward(endOffsetBytes, hints);
+        this->_releaseBehind(offsetBytes, hints);
+    } else if (_streak <= -seqStreakLen) {
+        this->_prefetchBackward(offsetBytes, hints);
+        this->_releaseAhead(endOffsetBytes, hints);
+    } else if (_randomStreak >= randomStreakLen) {
+        _prefetchLenBytes = _minPrefetchLenBytes;
+        this->_setPattern(Pattern::RANDOM, hints);
+    }
+}
+
+void AccessPolicy::expect(const Index offsetBytes, const Size lenBytes, Hints& hints)
+{
+    if (offsetBytes >= _fileLenBytes) {
+        return;
+    }
+
+    // don't prefetch more than what we'd keep
+    const auto prefetchLenBytes = std::min({lenBytes, _keepLenBytes,
+                                            _fileLenBytes - offsetBytes});
+
+    if (prefetchLenBytes > 0) {
+        hints.push_back({Hint::Kind::PREFETCH, offsetBytes, prefetchLenBytes, _pattern});
+    }
+}
+
+void AccessPolicy::_setPattern(const Pattern pattern, Hints& hints)
+{
+    if (pattern == _pattern) {
+        return;
+    }
+
+    _pattern = pattern;
+    hints.push_back({Hint::Kind::PATTERN, 0, 0, pattern});
+}
+
+void AccessPolicy::_prefetchForward(const Index endOffsetBytes, Hints& hints)
+{
+    if (endOffsetBytes + _prefetchLenBytes / 2 <= _prefetchEdgeOffsetBytes) {
+        // still far enough from the prefetched edge
+        return;
+    }
+
+    const auto beginOffsetBytes = std::max(_prefetchEdgeOffsetBytes, endOffsetBytes);
+    const auto edgeOffsetBytes = std::min(endOffsetBytes + _prefetchLenBytes, _fileLenBytes);
+
+    if (edgeOffsetBytes > beginOffsetBytes) {
+        hints.push_back({
+            Hint::Kind::PREFETCH, beginOffsetBytes, edgeOffsetBytes - beginOffsetBytes, _pattern
+        });
+        _prefetchEdgeOffsetBytes = edgeOffsetBytes;
+    }
+
+    _prefetchLenBytes = std::min(_prefetchLenBytes * 2, _maxPrefetchLenBytes);
+}
+
+void AccessPolicy::_prefetchBackward(const Index offsetBytes, Hints& hints)
+{
+    if (offsetBytes >= _prefetchEdgeOffsetBytes + _prefetchLenBytes / 2) {
+        // still far enough from the prefetched edge
+        return;
+    }
+
+    const auto endOffsetBytes = std::min(_prefetchEdgeOffsetBytes, offsetBytes);
+    const auto edgeOffsetBytes = offsetBytes - std::min(offsetBytes, _prefetchLenBytes);
+
+    if (endOffsetBytes > edgeOffsetBytes) {
+        hints.push_back({
+            Hint::Kind::PREFETCH, edgeOffsetBytes, endOffsetBytes - edgeOffsetBytes, _pattern
+        });
+        _prefetchEdgeOffsetBytes = edgeOffsetBytes;
+    }
+
+    _prefetchLenBytes = std::min(_prefetchLenBytes * 2, _maxPrefetchLenBytes);
+}
+
+void AccessPolicy::_releaseBehind(const Index offsetBytes, Hints& hints)
+{
+    // release by large ranges
+    if (offsetBytes < _releaseEdgeOffsetBytes + _keepLenBytes + _maxPrefetchLenBytes) {
+        return;
+    }
+
+    const auto edgeOffsetBytes = offsetBytes - _keepLenBytes;
+
+    hints.push_back({
+        Hint::Kind::RELEASE, _releaseEdgeOffsetBytes,
+        edgeOffsetBytes - _releaseEdgeOffsetBytes, _pattern
+    });
+    _releaseEdgeOffsetBytes = edgeOffsetBytes;
+}
+
+void AccessPolicy::_releaseAhead(const Index endOffsetBytes, Hints& hints)
+{
+    if (endOffsetBytes + _keepLenBytes + _maxPrefetchLenBytes > _releaseEdgeOffsetBytes) {
+        return;
+    }
+
+    const auto edgeOffsetBytes = endOffsetBytes + _keepLenBytes;
+
+    hints.push_back({
+        Hint::Kind::RELEASE, edgeOffsetBytes,
+        _releaseEdgeOffsetBytes - edgeOffsetBytes, _pattern
+    });
+    _releaseEdgeOffsetBytes = edgeOffsetBytes;
+}
+
+} // namespace jacques
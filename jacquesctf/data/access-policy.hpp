@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_ACCESS_POLICY_HPP
+#define _JACQUES_DATA_ACCESS_POLICY_HPP
+
+#include <vector>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * File access policy.
+ *
+ * An access policy watches the accesses to a file and tells what to
+ * advise the kernel, as hints, without doing any system call itself
+ * (see MemMappedFile).
+ *
+ * It considers the accesses by granules of `granuleLenBytes` so that
+ * the many small accesses of a single page of a packet data view don't
+ * look like a sequential scan. After a few consecutive moves to the
+ * next granules (scrolling down, sequential decoding), the pattern is
+ * sequential: the policy asks to prefetch ahead, doubling the prefetch
+ * length up to `maxPrefetchLenBytes` as long as the pattern holds, and
+ * to release, by large ranges, what's more than `keepLenBytes` behind.
+ * Moving backward (scrolling up) is the mirror image. Jumps (searches,
+ * going to another packet) make the pattern random, which resets the
+ * prefetch length.
+ *
+ * expect() asks to prefetch a range which is about to be read anyway,
+ * for example a packet of which to build the checkpoints.
+ */
+class AccessPolicy final
+{
+public:
+    enum class Pattern
+    {
+        UNKNOWN,
+        SEQUENTIAL,
+        BACKWARD,
+        RANDOM,
+    };
+
+    struct Hint
+    {
+        enum class Kind
+        {
+            // prefetch the range
+            PREFETCH,
+
+            // the range won't be needed soon
+            RELEASE,
+
+            // the access pattern is now `pattern`
+            PATTERN,
+        };
+
+        Kind kind;
+        Index offsetBytes;
+        Size lenBytes;
+        Pattern pattern;
+    };
+
+    using Hints = std::vector<Hint>;
+
+public:
+    explicit AccessPolicy(Size fileLenBytes, Size granuleLenBytes = 64 << 10,
+                          Size minPrefetchLenBytes = 1 << 20,
+                          Size maxPrefetchLenBytes = 32 << 20,
+                          Size keepLenBytes = 64 << 20);
+
+    // records an access, appending the resulting hints to `hints`
+    void access(Index offsetBytes, Size lenBytes, Hints& hints);
+
+    /*
+     * Records that the range at `offsetBytes` will be read soon,
+     * appending the resulting hints to `hints`.
+     */
+    void expect(Index offsetBytes, Size lenBytes, Hints& hints);
+
+    Pattern pattern() const noexcept
+    {
+        return _pattern;
+    }
+
+private:
+    void _setPattern(Pattern pattern, Hints& hints);
+    void _prefetchForward(Index endOffsetBytes, Hints& hints);
+    void _prefetchBackward(Index offsetBytes, Hints& hints);
+    void _releaseBehind(Index offsetBytes, Hints& hints);
+    void _releaseAhead(Index endOffsetBytes, Hints& hints);
+
+private:
+    const Size _fileLenBytes;
+    const Size _granuleLenBytes;
+    const Size _minPrefetchLenBytes;
+    const Size _maxPrefetchLenBytes;
+    const Size _keepLenBytes;
+    Pattern _pattern = Pattern::UNKNOWN;
+    bool _hasLastAccess = false;
+    Index _lastGranule = 0;
+
+    // consecutive forward (positive) or backward (negative) moves
+    long long _streak = 0;
+
+    Size _randomStreak = 0;
+    Size _prefetchLenBytes;
+
+    // prefetched up to (sequential) or from (backward) there
+    Index _prefetchEdgeOffsetBytes = 0;
+
+    // released up to (sequential) or from (backward) there
+    Index _releaseEdgeOffsetBytes = 0;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_ACCESS_POLICY_HPP
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cstdlib>
+#include <boost/optional.hpp>
+
+#include "data-src-factory.hpp"
+
+#ifdef JACQUES_HAS_IO_URING
+# include "io-uring-data-src-factory.hpp"
+#endif
+
+namespace jacques {
+
+#ifdef JACQUES_HAS_IO_URING
+namespace {
+
+// value of the environment variable `name`, if it's a positive integer
+boost::optional<Size> envVarSize(const char * const name)
+{
+    const auto str = std::getenv(name);
+
+    if (!str) {
+        return boost::none;
+    }
+
+    char *end;
+    const auto val = std::strtoull(str, &end, 0);
+
+    if (end == str || *end != '\0' || val == 0) {
+        return boost::none;
+    }
+
+    return static_cast<Size>(val);
+}
+
+} // namespace
+#endif
+
+std::unique_ptr<yactfr::DataSourceFactory> tryCreateIoUringDataSrcFactory(const boost::filesystem::path& path,
+                                                                          const int fd,
+                                                                          const Size fileLenBytes)
+{
+#ifdef JACQUES_HAS_IO_URING
+    if (std::getenv("JACQUES_NO_IO_URING") || !IoUringDataSrcFactory::isSupported()) {
+        return nullptr;
+    }
+
+    static const auto queueDepth = envVarSize("JACQUES_IO_URING_QUEUE_DEPTH").value_or(8);
+    static const auto blockLenBytes = envVarSize("JACQUES_IO_URING_BLOCK_SIZE").value_or(1 << 20);
+
+    return std::make_unique<IoUringDataSrcFactory>(path, fd, fileLenBytes, queueDepth,
+                                                   blockLenBytes);
+#else
+    static_cast<void>(path);
+    static_cast<void>(fd);
+    static_cast<void>(fileLenBytes);
+    return nullptr;
+#endif
+}
+
+} // namespace jacques
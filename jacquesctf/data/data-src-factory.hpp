@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_DATA_SRC_FACTORY_HPP
+#define _JACQUES_DATA_DATA_SRC_FACTORY_HPP
+
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Creates an io_uring data source factory (see IoUringDataSrcFactory)
+ * to scan the file `path` (opened as `fd`, `fileLenBytes` bytes long)
+ * sequentially, or returns `nullptr` if Jacques CTF isn't built with
+ * liburing, if the running kernel doesn't support io_uring, or if the
+ * `JACQUES_NO_IO_URING` environment variable is set.
+ *
+ * The `JACQUES_IO_URING_QUEUE_DEPTH` and `JACQUES_IO_URING_BLOCK_SIZE`
+ * (bytes) environment variables, if set, override the default queue
+ * depth and block length of the factory.
+ *
+ * Only use this for a long sequential scan with long-lived data
+ * sources, like building a packet index or analyzing whole data stream
+ * files with PktUnitScanner.
+ *
+ * `fd` must remain open as long as the returned factory's data sources
+ * exist.
+ */
+std::unique_ptr<yactfr::DataSourceFactory> tryCreateIoUringDataSrcFactory(const boost::filesystem::path& path,
+                                                                          int fd,
+                                                                          Size fileLenBytes);
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_DATA_SRC_FACTORY_HPP
@@ -14,32 +14,72 @@
 #include <fcntl.h>
 
 #include "ds-file.hpp"
+#include "data-src-factory.hpp"
+#include "mem-mapped-file-data-src-factory.hpp"
+#include "pread-data-src-factory.hpp"
+#include "zstd-seekable-data-src-factory.hpp"
 #include "io-error.hpp"
 
 namespace jacques {
 
+DsFile::_Fd::_Fd(const boost::filesystem::path& path) :
+    _fd {open(path.string().c_str(), O_RDONLY)}
+{
+    if (_fd < 0) {
+        throw IOError {path, "Cannot open file."};
+    }
+}
+
+DsFile::_Fd::~_Fd()
+{
+    static_cast<void>(close(_fd));
+}
+
 DsFile::DsFile(Trace& trace, boost::filesystem::path path) :
     _trace {&trace},
     _path {std::move(path)},
-    _factory {
-        std::make_unique<yactfr::MemoryMappedFileViewFactory>(_path.string(), 8 << 20,
-                                                              yactfr::MemoryMappedFileViewFactory::AccessPattern::SEQUENTIAL)
-    },
-    _seq {trace.metadata().traceType(), *_factory}
+    _fd {_path},
+    _zstdFile {ZstdSeekableFile::tryCreate(_path, _fd.fd())},
+    _fileLen {
+        _zstdFile ? _zstdFile->contentLen() :
+        DataLen::fromBytes(boost::filesystem::file_size(_path))
+    }
 {
-    _fileLen = DataLen::fromBytes(boost::filesystem::file_size(_path));
-    _fd = open(_path.string().c_str(), O_RDONLY);
+    if (_zstdFile) {
+        _mmapFile = std::make_unique<MemMappedFile>(_zstdFile);
 
-    if (_fd < 0) {
-        throw IOError {_path, "Cannot open file."};
+        // frames are already shared: don't copy them into views
+        _pktDataSrcFactory = std::make_unique<ZstdSeekableDataSrcFactory>(_zstdFile);
+    } else {
+        _mmapFile = std::make_unique<MemMappedFile>(_path, _fd.fd());
+        _pktDataSrcFactory = std::make_unique<MemMappedFileDataSrcFactory>(*_mmapFile);
     }
+
+    _pktSeq = std::make_unique<yactfr::ElementSequence>(_trace->metadata().traceType(),
+                                                        *_pktDataSrcFactory);
 }
 
 DsFile::~DsFile()
 {
-    if (_fd >= 0) {
-        static_cast<void>(close(_fd));
+    /*
+     * Packets own iterators of `_pktSeq` of which the data sources
+     * could still read through `_fd`.
+     */
+    _pkts.clear();
+}
+
+std::unique_ptr<yactfr::DataSourceFactory> DsFile::createSeqScanDataSrcFactory() const
+{
+    if (_zstdFile) {
+        return std::make_unique<ZstdSeekableDataSrcFactory>(_zstdFile);
     }
+
+    if (auto factory = tryCreateIoUringDataSrcFactory(_path, _fd.fd(), _fileLen.bytes())) {
+        return factory;
+    }
+
+    return std::make_unique<yactfr::MemoryMappedFileViewFactory>(_path.string(), 8 << 20,
+                                                                 yactfr::MemoryMappedFileViewFactory::AccessPattern::SEQUENTIAL);
 }
 
 void DsFile::buildIndex()
@@ -58,17 +98,14 @@ void DsFile::buildIndex(const BuildIndexProgressFunc& progressFunc, const Size s
         return;
     }
 
-    const auto oldExpectedAccessPattern = _factory->expectedAccessPattern();
-
-    _factory->expectedAccessPattern(yactfr::MemoryMappedFileViewFactory::AccessPattern::RANDOM);
     this->_buildIndex(progressFunc, step);
-    _factory->expectedAccessPattern(oldExpectedAccessPattern);
+    _pktIndexStore.seal();
     _isIndexBuilt = true;
-    _pkts.resize(_index.size());
 }
 
-void DsFile::_addPktIndexEntry(const Index offsetInDsFileBytes, const Index offsetInDsFileBits,
-                               const _IndexBuildingState& state, bool isInvalid)
+PktIndexEntry DsFile::_addPktIndexEntry(const Index offsetInDsFileBytes,
+                                        const Index offsetInDsFileBits,
+                                        const _IndexBuildingState& state, bool isInvalid)
 {
     auto expectedTotalLen = state.expectedTotalLen;
     auto expectedContentLen = state.expectedContentLen;
@@ -116,15 +153,31 @@ void DsFile::_addPktIndexEntry(const Index offsetInDsFileBytes, const Index offs
         _hasError = true;
     }
 
-    _index.push_back(PktIndexEntry {
-        _index.size(), offsetInDsFileBytes,
+    PktIndexEntry entry {
+        _pktIndexStore.size(), offsetInDsFileBytes,
         state.pktCtxOffsetInPktBits,
         state.preambleLen,
         expectedTotalLen, expectedContentLen,
         effectiveTotalLen, effectiveContentLen,
         state.dst, state.dsId, state.beginTs, state.endTs, state.seqNum,
         state.discErCounterSnap, isInvalid,
-    });
+    };
+
+    _pktIndexStore.append(entry);
+    _maxPktTotalLen = std::max(_maxPktTotalLen, effectiveTotalLen);
+    return entry;
+}
+
+PktIndexEntry& DsFile::_materializedPktIndexEntry(const Index index) const
+{
+    std::lock_guard<std::mutex> lock {_pktIndexEntriesMutex};
+    auto& entry = _pktIndexEntries[index];
+
+    if (!entry) {
+        entry = std::make_unique<PktIndexEntry>(_pktIndexStore.entry(index));
+    }
+
+    return *entry;
 }
 
 void DsFile::_IndexBuildingState::reset()
@@ -144,8 +197,30 @@ void DsFile::_IndexBuildingState::reset()
 
 void DsFile::_buildIndex(const BuildIndexProgressFunc& progressFunc, const Size step)
 {
-    auto it = _seq.begin();
-    const auto endIt = _seq.end();
+    /*
+     * We only decode the preamble of each packet: read only that
+     * instead of mapping windows of the file. A compressed file only
+     * decompresses the frames containing preambles.
+     *
+     * The single iterator below scans the whole file: an io_uring data
+     * source reads the preambles of large packets with small reads, like
+     * a pread(2) one, and reads ahead through small packets.
+     */
+    std::unique_ptr<yactfr::DataSourceFactory> factory;
+
+    if (_zstdFile) {
+        factory = std::make_unique<ZstdSeekableDataSrcFactory>(_zstdFile);
+    } else {
+        factory = tryCreateIoUringDataSrcFactory(_path, _fd.fd(), _fileLen.bytes());
+
+        if (!factory) {
+            factory = std::make_unique<PreadDataSrcFactory>(_path, _fd.fd(), _fileLen.bytes());
+        }
+    }
+
+    const yactfr::ElementSequence seq {_trace->metadata().traceType(), *factory};
+    auto it = seq.begin();
+    const auto endIt = seq.end();
     Index offsetBytes = 0;
     _IndexBuildingState state;
     bool pktStarted = false;
@@ -177,10 +252,11 @@ void DsFile::_buildIndex(const BuildIndexProgressFunc& progressFunc, const Size
             {
                 state.preambleLen = it.offset() - offsetBytes * 8;
                 state.inPktCtxScope = false;
-                this->_addPktIndexEntry(offsetBytes, it.offset(), state, false);
+                const auto entry = this->_addPktIndexEntry(offsetBytes, it.offset(), state,
+                                                           false);
 
-                if (_index.size() % step == 0) {
-                    progressFunc(_index.back());
+                if (_pktIndexStore.size() % step == 0) {
+                    progressFunc(entry);
                 }
 
                 state.reset();
@@ -191,8 +267,7 @@ void DsFile::_buildIndex(const BuildIndexProgressFunc& progressFunc, const Size
                  * so `nextOffsetBytes` below will be equal to
                  * _fileLen.bytes().
                  */
-                const auto nextOffsetBytes = offsetBytes +
-                                             _index.back().effectiveTotalLen().bytes();
+                const auto nextOffsetBytes = offsetBytes + entry.effectiveTotalLen().bytes();
 
                 if (nextOffsetBytes >= _fileLen.bytes()) {
                     it = endIt;
@@ -286,7 +361,7 @@ void DsFile::_buildIndex(const BuildIndexProgressFunc& progressFunc, const Size
     }
 }
 
-bool DsFile::hasOffsetBits(const Index offsetBits) const noexcept
+bool DsFile::hasOffsetBits(const Index offsetBits) const
 {
     assert(_isIndexBuilt);
 
@@ -294,29 +369,30 @@ bool DsFile::hasOffsetBits(const Index offsetBits) const noexcept
         return false;
     }
 
-    assert(!_index.empty());
+    assert(_pktIndexStore.size() > 0);
 
-    return offsetBits < _index.back().endOffsetInDsFileBits();
+    return offsetBits <
+           _pktIndexStore.entry(_pktIndexStore.size() - 1).endOffsetInDsFileBits();
 }
 
-const PktIndexEntry& DsFile::pktIndexEntryContainingOffsetBits(const Index offsetBits) const noexcept
+const PktIndexEntry& DsFile::pktIndexEntryContainingOffsetBits(const Index offsetBits) const
 {
     assert(this->hasOffsetBits(offsetBits));
 
-    auto it = std::upper_bound(_index.begin(), _index.end(), offsetBits,
-                               [](const auto offsetBits, const auto& entry) {
-        return offsetBits < entry.offsetInDsFileBits() + entry.effectiveTotalLen();
+    const auto index = this->_pktIndexEntryPartitionPoint([offsetBits](const auto& entry) {
+        return offsetBits >= entry.endOffsetInDsFileBits();
     });
 
-    assert(it != _index.end());
-    assert(offsetBits >= it->offsetInDsFileBits() &&
-           offsetBits < it->offsetInDsFileBits() + it->effectiveTotalLen());
+    assert(index < _pktIndexStore.size());
 
+    const auto& entry = this->_materializedPktIndexEntry(index);
 
-    return *it;
+    assert(offsetBits >= entry.offsetInDsFileBits() &&
+           offsetBits < entry.endOffsetInDsFileBits());
+    return entry;
 }
 
-const PktIndexEntry *DsFile::pktIndexEntryContainingNsFromOrigin(const long long nsFromOrigin) const noexcept
+const PktIndexEntry *DsFile::pktIndexEntryContainingNsFromOrigin(const long long nsFromOrigin) const
 {
     const auto tsLtCompFunc = [](const Ts& ts, const long long nsFromOrigin) -> bool {
         return ts.nsFromOrigin() < nsFromOrigin;
@@ -330,7 +406,7 @@ const PktIndexEntry *DsFile::pktIndexEntryContainingNsFromOrigin(const long long
     return this->_pktIndexEntryContainingVal(tsLtCompFunc, valInTsFunc, nsFromOrigin);
 }
 
-const PktIndexEntry *DsFile::pktIndexEntryContainingCycles(const unsigned long long cycles) const noexcept
+const PktIndexEntry *DsFile::pktIndexEntryContainingCycles(const unsigned long long cycles) const
 {
     const auto tsLtCompFunc = [](const Ts& ts, const unsigned long long cycles) -> bool {
         return ts.cycles() < cycles;
@@ -345,62 +421,134 @@ const PktIndexEntry *DsFile::pktIndexEntryContainingCycles(const unsigned long l
     return this->_pktIndexEntryContainingVal(tsLtCompFunc, valInTsFunc, cycles);
 }
 
-const PktIndexEntry *DsFile::pktIndexEntryWithSeqNum(const Index seqNum) const noexcept
+std::pair<Index, Index> DsFile::pktIndexRangeOverlappingNsFromOrigin(const long long beginNsFromOrigin,
+                                                                      const long long endNsFromOrigin) const
+{
+    assert(_isIndexBuilt);
+
+    if (!_trace->metadata().isCorrelatable() || beginNsFromOrigin > endNsFromOrigin) {
+        return {0, 0};
+    }
+
+    // first packet which ends at or after `beginNsFromOrigin`
+    const auto first = this->_pktIndexEntryPartitionPoint([beginNsFromOrigin](const auto& entry) {
+        return entry.endTs() && entry.endTs()->nsFromOrigin() < beginNsFromOrigin;
+    });
+
+    // first packet which begins after `endNsFromOrigin`
+    const auto last = this->_pktIndexEntryPartitionPoint([endNsFromOrigin](const auto& entry) {
+        return entry.beginTs() && entry.beginTs()->nsFromOrigin() <= endNsFromOrigin;
+    });
+
+    return {first, std::max(first, last)};
+}
+
+const PktIndexEntry *DsFile::pktIndexEntryWithSeqNum(const Index seqNum) const
 {
     assert(_isIndexBuilt);
 
-    if (_index.empty()) {
+    if (_pktIndexStore.size() == 0) {
         return nullptr;
     }
 
-    auto it = std::upper_bound(_index.begin(), _index.end(), seqNum,
-                               [](const auto seqNum, const auto& entry) {
+    // first entry of which the sequence number is greater than `seqNum`
+    const auto index = this->_pktIndexEntryPartitionPoint([seqNum](const auto& entry) {
         if (entry.seqNum()) {
-            return seqNum < *entry.seqNum();
+            return *entry.seqNum() <= seqNum;
         }
 
-        return true;
+        return false;
     });
 
-    --it;
-
-    if (!it->seqNum()) {
+    if (index == 0) {
         return nullptr;
     }
 
-    if (*it->seqNum() != seqNum) {
+    const auto entry = _pktIndexStore.entry(index - 1);
+
+    if (!entry.seqNum() || *entry.seqNum() != seqNum) {
         return nullptr;
     }
 
-    return &(*it);
+    return &this->_materializedPktIndexEntry(index - 1);
 }
 
-Pkt& DsFile::pktAtIndex(const Index index, PktCheckpointsBuildListener& buildListener)
+DsFile::PktBuild::PktBuild(DsFile& dsFile, PktIndexEntry& pktIndexEntry) :
+    _pktIndexEntry {&pktIndexEntry},
+    _metadata {&dsFile.metadata()},
+    _seq {dsFile._pktSeq.get()},
+    _dataWindow {
+        dsFile._mmapFile->window(pktIndexEntry.offsetInDsFileBytes(),
+                                 pktIndexEntry.effectiveTotalLen())
+    }
+{
+}
+
+void DsFile::PktBuild::create(PktCheckpointsBuildListener& buildListener)
+{
+    assert(!_pkt);
+    _pkt = std::make_unique<Pkt>(*_pktIndexEntry, *_seq, *_metadata, std::move(_dataWindow),
+                                 buildListener);
+}
+
+bool DsFile::hasPktAtIndex(const Index index) const
+{
+    return _pkts.find(index) != _pkts.end();
+}
+
+std::unique_ptr<DsFile::PktBuild> DsFile::pktBuild(const Index index)
 {
     assert(_isIndexBuilt);
-    assert(index < _index.size());
+    assert(index < _pktIndexStore.size());
+    assert(!this->hasPktAtIndex(index));
 
-    if (!_pkts[index]) {
-        auto& pktIndexEntry = _index[index];
-        auto mmapFile = std::make_unique<MemMappedFile>(_path, _fd);
+    auto& pktIndexEntry = this->_materializedPktIndexEntry(index);
 
-        buildListener.startBuild(*this, pktIndexEntry);
+    // building the checkpoints reads the whole packet
+    _mmapFile->expect(pktIndexEntry.offsetInDsFileBytes(), pktIndexEntry.effectiveTotalLen());
 
-        auto pkt = std::make_unique<Pkt>(pktIndexEntry, _seq, _trace->metadata(),
-                                         _factory->createDataSource(), std::move(mmapFile),
-                                         buildListener);
+    // creates the data window from this thread
+    return std::unique_ptr<PktBuild> {new PktBuild {*this, pktIndexEntry}};
+}
 
-        buildListener.endBuild();
+Pkt& DsFile::addPkt(std::unique_ptr<PktBuild> build)
+{
+    assert(build->hasPkt());
 
-        if (pkt->error()) {
-            pktIndexEntry.isInvalid(true);
-        }
+    auto& pktIndexEntry = *build->_pktIndexEntry;
+    const auto index = pktIndexEntry.indexInDsFile();
+
+    assert(!this->hasPktAtIndex(index));
+
+    if (build->_pkt->error()) {
+        pktIndexEntry.isInvalid(true);
+    }
+
+    pktIndexEntry.erCount(build->_pkt->erCount());
 
-        pktIndexEntry.erCount(pkt->erCount());
-        _pkts[index] = std::move(pkt);
+    auto& pkt = *build->_pkt;
+
+    _pkts[index] = std::move(build);
+    return pkt;
+}
+
+Pkt& DsFile::pktAtIndex(const Index index, PktCheckpointsBuildListener& buildListener)
+{
+    assert(_isIndexBuilt);
+    assert(index < _pktIndexStore.size());
+
+    const auto it = _pkts.find(index);
+
+    if (it != _pkts.end()) {
+        return *it->second->_pkt;
     }
 
-    return *_pkts[index];
+    auto build = this->pktBuild(index);
+
+    buildListener.startBuild(*this, build->pktIndexEntry());
+    build->create(buildListener);
+    buildListener.endBuild();
+    return this->addPkt(std::move(build));
 }
 
 } // namespace jacques
@@ -10,7 +10,11 @@
 
 #include <cassert>
 #include <vector>
+#include <memory>
 #include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <utility>
 #include <boost/filesystem.hpp>
 #include <boost/core/noncopyable.hpp>
 #include <yactfr/yactfr.hpp>
@@ -18,10 +22,12 @@
 #include "aliases.hpp"
 #include "pkt.hpp"
 #include "pkt-index-entry.hpp"
+#include "pkt-index-store.hpp"
 #include "metadata.hpp"
 #include "data-len.hpp"
 #include "pkt-checkpoints-build-listener.hpp"
 #include "trace.hpp"
+#include "zstd-seekable-file.hpp"
 
 namespace jacques {
 
@@ -35,6 +41,54 @@ class DsFile final :
 public:
     using BuildIndexProgressFunc = std::function<void (const PktIndexEntry&)>;
 
+    /*
+     * Creation of a packet which can run on another thread.
+     *
+     * Get a packet build with pktBuild(), call its create() method from
+     * any thread, and then pass it to addPkt() from the thread which
+     * uses the data stream file.
+     *
+     * A packet build uses the packet element sequence and the
+     * memory-mapped file of the data stream file, which are both
+     * thread-safe: while it creates its packet, it shares nothing else
+     * with the data stream file or with its other packets.
+     */
+    class PktBuild final :
+        boost::noncopyable
+    {
+        friend class DsFile;
+
+    private:
+        explicit PktBuild(DsFile& dsFile, PktIndexEntry& pktIndexEntry);
+
+    public:
+        /*
+         * Creates the packet, calling `buildListener.update()` for each
+         * event record.
+         *
+         * If this method throws, for example because `buildListener`
+         * cancels the build, the build has no packet.
+         */
+        void create(PktCheckpointsBuildListener& buildListener);
+
+        const PktIndexEntry& pktIndexEntry() const noexcept
+        {
+            return *_pktIndexEntry;
+        }
+
+        bool hasPkt() const noexcept
+        {
+            return static_cast<bool>(_pkt);
+        }
+
+    private:
+        PktIndexEntry * const _pktIndexEntry;
+        const Metadata * const _metadata;
+        yactfr::ElementSequence * const _seq;
+        MemMappedFile::Window _dataWindow;
+        std::unique_ptr<Pkt> _pkt;
+    };
+
 private:
     explicit DsFile(Trace& trace, boost::filesystem::path path);
 
@@ -42,43 +96,132 @@ public:
     ~DsFile();
     void buildIndex();
     void buildIndex(const BuildIndexProgressFunc& progressFunc, Size step = 1);
-    bool hasOffsetBits(Index offsetBits) const noexcept;
+    bool hasOffsetBits(Index offsetBits) const;
     Pkt& pktAtIndex(Index index, PktCheckpointsBuildListener& buildListener);
-    const PktIndexEntry& pktIndexEntryContainingOffsetBits(Index offsetBits) const noexcept;
-    const PktIndexEntry *pktIndexEntryWithSeqNum(Index seqNum) const noexcept;
-    const PktIndexEntry *pktIndexEntryContainingNsFromOrigin(long long nsFromOrigin) const noexcept;
-    const PktIndexEntry *pktIndexEntryContainingCycles(unsigned long long cycles) const noexcept;
+    bool hasPktAtIndex(Index index) const;
+
+    /*
+     * Prepares the creation of the packet at index `index`, which
+     * doesn't exist yet, for another thread (see PktBuild).
+     */
+    std::unique_ptr<PktBuild> pktBuild(Index index);
+
+    /*
+     * Adds the packet which `build` created and returns it, as
+     * pktAtIndex() would.
+     */
+    Pkt& addPkt(std::unique_ptr<PktBuild> build);
+
+    const PktIndexEntry& pktIndexEntryContainingOffsetBits(Index offsetBits) const;
+    const PktIndexEntry *pktIndexEntryWithSeqNum(Index seqNum) const;
+    const PktIndexEntry *pktIndexEntryContainingNsFromOrigin(long long nsFromOrigin) const;
+    const PktIndexEntry *pktIndexEntryContainingCycles(unsigned long long cycles) const;
+
+    /*
+     * Range, as a pair of first and past-the-end indexes, of the
+     * packets which overlap the time range from `beginNsFromOrigin` to
+     * `endNsFromOrigin` (inclusive), found by bisection.
+     *
+     * The range is empty if the metadata isn't correlatable.
+     *
+     * Like decodedPktIndexEntry(), this method is thread-safe.
+     */
+    std::pair<Index, Index> pktIndexRangeOverlappingNsFromOrigin(long long beginNsFromOrigin,
+                                                                 long long endNsFromOrigin) const;
+
+    /*
+     * Creates a data source factory to scan the content of this data
+     * stream file sequentially from another thread, with a few
+     * long-lived iterators (see PktUnitScanner).
+     *
+     * Packets don't use this: they share a single data source factory.
+     */
+    std::unique_ptr<yactfr::DataSourceFactory> createSeqScanDataSrcFactory() const;
 
     Size pktCount() const noexcept
     {
         assert(_isIndexBuilt);
-        return _index.size();
+        return _pktIndexStore.size();
+    }
+
+    /*
+     * Packet index entry at index `index`.
+     *
+     * The index itself lives in `_pktIndexStore`: this materializes the
+     * entry on first access, and the returned reference remains valid
+     * as long as this data stream file exists.
+     *
+     * Materializing is thread-safe, but pktAtIndex() updates the
+     * returned entry.
+     */
+    const PktIndexEntry& pktIndexEntry(const Index index) const
+    {
+        assert(_isIndexBuilt);
+        assert(index < _pktIndexStore.size());
+        return this->_materializedPktIndexEntry(index);
     }
 
-    const PktIndexEntry& pktIndexEntry(const Index index) const noexcept
+    PktIndexEntry& pktIndexEntry(const Index index)
     {
         assert(_isIndexBuilt);
-        assert(index < _index.size());
-        return _index[index];
+        assert(index < _pktIndexStore.size());
+        return this->_materializedPktIndexEntry(index);
     }
 
-    PktIndexEntry& pktIndexEntry(const Index index) noexcept
+    /*
+     * Decoded copy of the packet index entry at index `index`, without
+     * materializing it.
+     *
+     * The returned entry doesn't reflect what pktAtIndex() learns about
+     * the packet (event record count, decoding error).
+     */
+    PktIndexEntry decodedPktIndexEntry(const Index index) const
     {
         assert(_isIndexBuilt);
-        assert(index < _index.size());
-        return _index[index];
+        assert(index < _pktIndexStore.size());
+        return _pktIndexStore.entry(index);
     }
 
-    const std::vector<PktIndexEntry>& pktIndexEntries() const noexcept
+    /*
+     * Calls `func` with each packet index entry, in order.
+     *
+     * `func` receives the materialized entry if it exists, or a
+     * temporary decoded entry otherwise: this doesn't materialize any
+     * entry.
+     */
+    template <typename FuncT>
+    void forEachPktIndexEntry(FuncT&& func) const
     {
         assert(_isIndexBuilt);
-        return _index;
+
+        for (Index index = 0; index < _pktIndexStore.size(); ++index) {
+            const PktIndexEntry *matEntry = nullptr;
+
+            {
+                // don't hold the lock while calling `func`
+                std::lock_guard<std::mutex> lock {_pktIndexEntriesMutex};
+                const auto it = _pktIndexEntries.find(index);
+
+                if (it != _pktIndexEntries.end()) {
+                    matEntry = it->second.get();
+                }
+            }
+
+            if (matEntry) {
+                func(*matEntry);
+            } else {
+                const auto entry = _pktIndexStore.entry(index);
+
+                func(entry);
+            }
+        }
     }
 
-    std::vector<PktIndexEntry>& pktIndexEntries() noexcept
+    // maximum effective total length of a packet
+    const DataLen& maxPktTotalLen() const noexcept
     {
         assert(_isIndexBuilt);
-        return _index;
+        return _maxPktTotalLen;
     }
 
     const boost::filesystem::path& path() const noexcept
@@ -86,11 +229,18 @@ public:
         return _path;
     }
 
+    // content length (decompressed length if the file is compressed)
     const DataLen& fileLen() const noexcept
     {
         return _fileLen;
     }
 
+    // whether or not the file is a Zstandard seekable file
+    bool isCompressed() const noexcept
+    {
+        return static_cast<bool>(_zstdFile);
+    }
+
     bool hasError() const noexcept
     {
         return _hasError;
@@ -129,70 +279,147 @@ private:
         bool inPktCtxScope = false;
     };
 
+    // read-only file descriptor, closed on destruction
+    class _Fd final :
+        boost::noncopyable
+    {
+    public:
+        explicit _Fd(const boost::filesystem::path& path);
+        ~_Fd();
+
+        int fd() const noexcept
+        {
+            return _fd;
+        }
+
+    private:
+        int _fd;
+    };
+
 private:
     void _buildIndex(const BuildIndexProgressFunc& progressFunc, Size step);
 
-    void _addPktIndexEntry(Index offsetInDsFileBytes, Index offsetInDsFileBits,
-                           const _IndexBuildingState& state, bool isInvalid);
+    PktIndexEntry _addPktIndexEntry(Index offsetInDsFileBytes, Index offsetInDsFileBits,
+                                    const _IndexBuildingState& state, bool isInvalid);
+    PktIndexEntry& _materializedPktIndexEntry(Index index) const;
+
+    /*
+     * Index of the first packet index entry for which `predFunc` is
+     * false (entries for which it's true must precede the others), or
+     * pktCount() if there's none.
+     */
+    template <typename PredFuncT>
+    Index _pktIndexEntryPartitionPoint(PredFuncT&& predFunc) const
+    {
+        Index begin = 0;
+        Index end = _pktIndexStore.size();
+
+        while (begin < end) {
+            const auto mid = begin + (end - begin) / 2;
+
+            if (predFunc(_pktIndexStore.entry(mid))) {
+                begin = mid + 1;
+            } else {
+                end = mid;
+            }
+        }
+
+        return begin;
+    }
 
     template <typename TsLtCompFuncT, typename ValInTsFuncT, typename ValT>
     const PktIndexEntry *_pktIndexEntryContainingVal(TsLtCompFuncT&& tsLtCompFunc,
                                                      ValInTsFuncT&& valInTsFunc,
-                                                     const ValT val) const noexcept
+                                                     const ValT val) const
     {
         if (!_trace->metadata().isCorrelatable()) {
             return nullptr;
         }
 
-        if (_index.empty()) {
+        if (_pktIndexStore.size() == 0) {
             return nullptr;
         }
 
-        auto it = std::lower_bound(_index.begin(), _index.end(), val,
-                                   [tsLtCompFunc](const auto& entry, const auto val) {
+        auto index = this->_pktIndexEntryPartitionPoint([&tsLtCompFunc, val](const auto& entry) {
             if (!entry.beginTs()) {
                 return false;
             }
 
-            return std::forward<TsLtCompFuncT>(tsLtCompFunc)(*entry.beginTs(), val);
+            return tsLtCompFunc(*entry.beginTs(), val);
         });
 
-        if (it == _index.end()) {
-            --it;
+        if (index == _pktIndexStore.size()) {
+            --index;
         }
 
-        if (!it->beginTs() || !it->endTs()) {
+        auto entry = _pktIndexStore.entry(index);
+
+        if (!entry.beginTs() || !entry.endTs()) {
             return nullptr;
         }
 
-        if (!std::forward<ValInTsFuncT>(valInTsFunc)(val, *it)) {
-            if (it == _index.begin()) {
+        if (!std::forward<ValInTsFuncT>(valInTsFunc)(val, entry)) {
+            if (index == 0) {
                 return nullptr;
             }
 
-            --it;
+            --index;
 
-            if (!it->beginTs() || !it->endTs()) {
+            const auto prevEntry = _pktIndexStore.entry(index);
+
+            if (!prevEntry.beginTs() || !prevEntry.endTs()) {
                 return nullptr;
             }
 
-            if (!std::forward<ValInTsFuncT>(valInTsFunc)(val, *it)) {
+            if (!std::forward<ValInTsFuncT>(valInTsFunc)(val, prevEntry)) {
                 return nullptr;
             }
         }
 
-        return &*it;
+        return &this->_materializedPktIndexEntry(index);
     }
 
 private:
     Trace * const _trace;
     const boost::filesystem::path _path;
-    std::unique_ptr<yactfr::MemoryMappedFileViewFactory> _factory;
-    yactfr::ElementSequence _seq;
-    DataLen _fileLen;
-    std::vector<PktIndexEntry> _index;
-    std::vector<std::unique_ptr<Pkt>> _pkts;
-    int _fd;
+
+    /*
+     * Data source factories (see createSeqScanDataSrcFactory()) may use
+     * it.
+     *
+     * Declared before everything which uses it: if the constructor
+     * throws after opening the file, the file is still closed.
+     */
+    const _Fd _fd;
+
+    // Zstandard seekable file, if the file is compressed
+    const std::shared_ptr<ZstdSeekableFile> _zstdFile;
+
+    const DataLen _fileLen;
+    PktIndexStore _pktIndexStore;
+
+    // materialized packet index entries (sparse)
+    mutable std::unordered_map<Index, std::unique_ptr<PktIndexEntry>> _pktIndexEntries;
+
+    // protects `_pktIndexEntries`, which const methods fill
+    mutable std::mutex _pktIndexEntriesMutex;
+
+    DataLen _maxPktTotalLen;
+
+    // builds of the created packets (sparse)
+    std::unordered_map<Index, std::unique_ptr<PktBuild>> _pkts;
+
+    /*
+     * Shared by the packets, including the data sources of their
+     * element sequence iterators: the number of mappings depends on the
+     * file length, not on the number of packets.
+     */
+    std::unique_ptr<MemMappedFile> _mmapFile;
+
+    // data source factory and element sequence of the packets
+    std::unique_ptr<yactfr::DataSourceFactory> _pktDataSrcFactory;
+    std::unique_ptr<yactfr::ElementSequence> _pktSeq;
+
     bool _isIndexBuilt = false;
     bool _hasError = false;
 };
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_DT_ORDINAL_MAP_HPP
+#define _JACQUES_DATA_DT_ORDINAL_MAP_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Data type to ordinal map.
+ *
+ * A flat, open-addressing hash table (linear probing) of which the
+ * slots are contiguous: a lookup usually touches a single cache line,
+ * whereas a node-based map chases at least one more pointer.
+ *
+ * Entries can't be removed.
+ */
+class DtOrdinalMap final
+{
+public:
+    using Ordinal = std::uint32_t;
+
+    static constexpr Ordinal noOrdinal = ~static_cast<Ordinal>(0);
+
+public:
+    explicit DtOrdinalMap()
+    {
+        this->_resize(16);
+    }
+
+    Size size() const noexcept
+    {
+        return _size;
+    }
+
+    // ordinal of `dt`, or `noOrdinal` if there's none
+    Ordinal find(const yactfr::DataType& dt) const noexcept
+    {
+        for (auto index = this->_slotIndex(dt); ; index = (index + 1) & _mask) {
+            const auto& slot = _slots[index];
+
+            if (slot.dt == &dt) {
+                return slot.ordinal;
+            }
+
+            if (!slot.dt) {
+                return noOrdinal;
+            }
+        }
+    }
+
+    // maps `dt` to `ordinal`, returning false if `dt` is already mapped
+    bool insert(const yactfr::DataType& dt, const Ordinal ordinal)
+    {
+        assert(ordinal != noOrdinal);
+
+        if ((_size + 1) * 2 > _slots.size()) {
+            // keep the load factor at most 1/2
+            this->_resize(_slots.size() * 2);
+        }
+
+        for (auto index = this->_slotIndex(dt); ; index = (index + 1) & _mask) {
+            auto& slot = _slots[index];
+
+            if (slot.dt == &dt) {
+                return false;
+            }
+
+            if (!slot.dt) {
+                slot.dt = &dt;
+                slot.ordinal = ordinal;
+                ++_size;
+                return true;
+            }
+        }
+    }
+
+private:
+    struct _Slot
+    {
+        const yactfr::DataType *dt = nullptr;
+        Ordinal ordinal = noOrdinal;
+    };
+
+private:
+    Index _slotIndex(const yactfr::DataType& dt) const noexcept
+    {
+        // Fibonacci hashing: the top bits of the product are well mixed
+        const auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&dt)) *
+                          11'400'714'819'323'198'485ULL;
+
+        return static_cast<Index>(hash >> _shift);
+    }
+
+    void _resize(const Size slotCount)
+    {
+        assert((slotCount & (slotCount - 1)) == 0);
+
+        auto oldSlots = std::move(_slots);
+
+        _slots.assign(slotCount, _Slot {});
+        _mask = slotCount - 1;
+        _shift = 64;
+
+        for (auto count = slotCount; count > 1; count >>= 1) {
+            --_shift;
+        }
+
+        _size = 0;
+
+        for (const auto& slot : oldSlots) {
+            if (slot.dt) {
+                this->insert(*slot.dt, slot.ordinal);
+            }
+        }
+    }
+
+private:
+    std::vector<_Slot> _slots;
+    Index _mask = 0;
+    unsigned int _shift = 64;
+    Size _size = 0;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_DT_ORDINAL_MAP_HPP
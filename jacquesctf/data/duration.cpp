@@ -5,6 +5,9 @@
  * prohibited. Proprietary and confidential.
  */
 
+#include <cstring>
+#include <algorithm>
+
 #include "duration.hpp"
 #include "utils.hpp"
 
@@ -27,26 +30,39 @@ Duration::Parts Duration::parts() const noexcept
     return {hPart, mPart, sPart, nsPart};
 }
 
-// TODO: use the second parameter
-void Duration::format(char * const buf, const Size) const
+void Duration::format(char * const buf, const Size bufSize) const
 {
-    auto bufAt = buf;
+    if (bufSize == 0) {
+        return;
+    }
+
+    // long enough for any duration; truncated to `bufSize` like snprintf()
+    std::array<char, 48> fmtBuf;
+    auto fmtBufAt = fmtBuf.data();
     const auto parts = this->parts();
 
     if (parts.hours > 0) {
-        bufAt += std::sprintf(bufAt, "%llu:", parts.hours);
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.hours);
+        *fmtBufAt++ = ':';
     }
 
     if (parts.mins > 0 || parts.hours > 0) {
-        bufAt += std::sprintf(bufAt, (parts.hours > 0) ? "%02llu:" : "%llu:", parts.mins);
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.mins, (parts.hours > 0) ? 2 : 0);
+        *fmtBufAt++ = ':';
     }
 
     if (parts.secs > 0 || parts.mins > 0 || parts.hours > 0) {
-        bufAt += std::sprintf(bufAt, (parts.mins > 0 || parts.hours > 0) ? "%02llu" : "%llu",
-                              parts.secs);
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.secs,
+                                      (parts.mins > 0 || parts.hours > 0) ? 2 : 0);
     }
 
-    std::sprintf(bufAt, ".%09llu", parts.ns);
+    *fmtBufAt++ = '.';
+    fmtBufAt += utils::formatUInt(fmtBufAt, parts.ns, 9);
+
+    const auto len = std::min(static_cast<Size>(fmtBufAt - fmtBuf.data()), bufSize - 1);
+
+    std::memcpy(buf, fmtBuf.data(), len);
+    buf[len] = '\0';
 }
 
 std::string Duration::format() const
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "global-ts-index.hpp"
+
+namespace jacques {
+
+GlobalTsIndex::GlobalTsIndex(const std::vector<const DsFile *>& dsFiles)
+{
+    for (Index dsFileIndex = 0; dsFileIndex < dsFiles.size(); ++dsFileIndex) {
+        const auto dsFile = dsFiles[dsFileIndex];
+
+        assert(dsFile);
+
+        if (!dsFile->metadata().isCorrelatable()) {
+            continue;
+        }
+
+        dsFile->forEachPktIndexEntry([this, dsFile, dsFileIndex](const auto& pktIndexEntry) {
+            if (!pktIndexEntry.beginTs() || !pktIndexEntry.endTs()) {
+                return;
+            }
+
+            _entries.push_back({
+                pktIndexEntry.beginTs()->nsFromOrigin(),
+                pktIndexEntry.endTs()->nsFromOrigin(),
+                dsFile,
+                dsFileIndex,
+                pktIndexEntry.indexInDsFile(),
+            });
+        });
+    }
+
+    std::stable_sort(_entries.begin(), _entries.end(), [](const auto& a, const auto& b) {
+        return a.beginNsFromOrigin < b.beginNsFromOrigin;
+    });
+
+    _maxEndNsFromOrigin.reserve(_entries.size());
+
+    for (const auto& entry : _entries) {
+        if (_maxEndNsFromOrigin.empty()) {
+            _maxEndNsFromOrigin.push_back(entry.endNsFromOrigin);
+        } else {
+            _maxEndNsFromOrigin.push_back(std::max(_maxEndNsFromOrigin.back(),
+                                                   entry.endNsFromOrigin));
+        }
+    }
+}
+
+template <typename FuncT>
+void GlobalTsIndex::_forEachEntryContainingNsFromOrigin(const long long nsFromOrigin,
+                                                        FuncT&& func) const
+{
+    // first entry which begins after `nsFromOrigin`: end of candidates
+    const auto endIt = std::upper_bound(_entries.begin(), _entries.end(), nsFromOrigin,
+                                        [](const auto val, const auto& entry) {
+        return val < entry.beginNsFromOrigin;
+    });
+
+    // all the entries before this one end at or before `nsFromOrigin`
+    const auto maxEndIt = std::upper_bound(_maxEndNsFromOrigin.begin(),
+                                           _maxEndNsFromOrigin.end(), nsFromOrigin);
+    auto it = _entries.begin() + (maxEndIt - _maxEndNsFromOrigin.begin());
+
+    for (; it < endIt; ++it) {
+        if (it->endNsFromOrigin > nsFromOrigin) {
+            if (!std::forward<FuncT>(func)(*it)) {
+                return;
+            }
+        }
+    }
+}
+
+void GlobalTsIndex::entriesContainingNsFromOrigin(const long long nsFromOrigin,
+                                                  std::vector<const Entry *>& entries) const
+{
+    this->_forEachEntryContainingNsFromOrigin(nsFromOrigin, [&entries](const auto& entry) {
+        entries.push_back(&entry);
+        return true;
+    });
+}
+
+const GlobalTsIndex::Entry *GlobalTsIndex::entryContainingNsFromOrigin(const DsFile& dsFile,
+                                                                       const long long nsFromOrigin) const noexcept
+{
+    const Entry *foundEntry = nullptr;
+
+    this->_forEachEntryContainingNsFromOrigin(nsFromOrigin,
+                                              [&dsFile, &foundEntry](const auto& entry) {
+        if (entry.dsFile == &dsFile) {
+            foundEntry = &entry;
+            return false;
+        }
+
+        return true;
+    });
+
+    return foundEntry;
+}
+
+} // namespace jacques
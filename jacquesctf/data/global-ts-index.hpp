@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_GLOBAL_TS_INDEX_HPP
+#define _JACQUES_DATA_GLOBAL_TS_INDEX_HPP
+
+#include <vector>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+#include "ds-file.hpp"
+#include "pkt-index-entry.hpp"
+
+namespace jacques {
+
+/*
+ * Timestamp index across many data stream files.
+ *
+ * A global timestamp index contains one entry for each packet, having
+ * both a beginning and an end timestamp, of each correlatable data
+ * stream file given to the constructor. It answers "which packets of
+ * which data stream files contain the time T?" in O(log n + m), where
+ * n is the total number of packets and m is the number of packets
+ * which begin at or before T, counting from the first one which ends
+ * after T.
+ *
+ * Entries are sorted by beginning timestamp. We also keep, for each
+ * entry, the maximum end timestamp of all the entries up to and
+ * including it. This prefix maximum is monotonic, therefore we can
+ * binary search it to skip, in one go, all the entries which precede
+ * the first one ending after T. The remaining entries which begin at
+ * or before T may still end before T, so that m isn't the number of
+ * matching packets: a single long packet which begins early makes m
+ * close to n. When the packets of all the data stream files have
+ * similar durations, m is about the number of packets which begin
+ * within one packet duration before T.
+ *
+ * All the data stream files must have a built index when you build a
+ * global timestamp index, and they must outlive it.
+ */
+class GlobalTsIndex final :
+    boost::noncopyable
+{
+public:
+    struct Entry
+    {
+        long long beginNsFromOrigin;
+        long long endNsFromOrigin;
+        const DsFile *dsFile;
+
+        // index of `dsFile` within the data stream files of the index
+        Index dsFileIndex;
+
+        Index pktIndexInDsFile;
+
+        const PktIndexEntry& pktIndexEntry() const
+        {
+            return dsFile->pktIndexEntry(pktIndexInDsFile);
+        }
+    };
+
+public:
+    explicit GlobalTsIndex(const std::vector<const DsFile *>& dsFiles);
+
+    /*
+     * Appends to `entries` the entries of all the packets which contain
+     * the time `nsFromOrigin`, sorted by beginning timestamp.
+     *
+     * Like DsFile::pktIndexEntryContainingNsFromOrigin(), a packet
+     * contains `nsFromOrigin` if its beginning timestamp is less than
+     * or equal to it and its end timestamp is greater than it.
+     */
+    void entriesContainingNsFromOrigin(long long nsFromOrigin,
+                                       std::vector<const Entry *>& entries) const;
+
+    /*
+     * Returns the entry of the packet of `dsFile` which contains the
+     * time `nsFromOrigin`, or `nullptr` if there's none.
+     */
+    const Entry *entryContainingNsFromOrigin(const DsFile& dsFile,
+                                             long long nsFromOrigin) const noexcept;
+
+    Size size() const noexcept
+    {
+        return _entries.size();
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return _entries.empty();
+    }
+
+private:
+    template <typename FuncT>
+    void _forEachEntryContainingNsFromOrigin(long long nsFromOrigin, FuncT&& func) const;
+
+private:
+    std::vector<Entry> _entries;
+
+    // maximum end timestamp of `_entries[0]` to `_entries[i]`
+    std::vector<long long> _maxEndNsFromOrigin;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_GLOBAL_TS_INDEX_HPP
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
+#include <liburing.h>
+
+#include "io-uring-data-src-factory.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+namespace {
+
+/*
+ * Length of a read which isn't sequential: typically the preamble of a
+ * packet when building a packet index.
+ */
+constexpr Size seekReadLenBytes = 4096;
+
+class IoUringDataSrc final :
+    public yactfr::DataSource
+{
+public:
+    explicit IoUringDataSrc(const boost::filesystem::path& path, const int fd,
+                            const Size fileLenBytes, const Size queueDepth,
+                            const Size blockLenBytes) :
+        _path {&path},
+        _fd {fd},
+        _fileLenBytes {fileLenBytes},
+        _blockLenBytes {blockLenBytes},
+        _slots(queueDepth)
+    {
+    }
+
+    ~IoUringDataSrc()
+    {
+        if (_ringState != _RingState::OK) {
+            return;
+        }
+
+        // the kernel could still write to our buffers: wait for it
+        static_cast<void>(io_uring_submit(&_ring));
+
+        for (auto& slot : _slots) {
+            while (slot.inFlight) {
+                this->_reap();
+            }
+        }
+
+        io_uring_queue_exit(&_ring);
+    }
+
+private:
+    enum class _RingState {
+        NONE,
+        OK,
+        FAILED,
+    };
+
+    struct _Slot
+    {
+        // allocated on the first read
+        std::unique_ptr<std::uint8_t[]> buf;
+        Index offset = 0;
+
+        // read result: length (bytes) or negative error number
+        long long res = 0;
+
+        bool inFlight = false;
+        bool isValid = false;
+    };
+
+private:
+    boost::optional<yactfr::DataBlock> _data(const Index offset, const Size minSize) override
+    {
+        if (offset >= _fileLenBytes) {
+            return boost::none;
+        }
+
+        /*
+         * The decoder reads on from around the previous request: read
+         * by blocks, ahead of it. Otherwise it seeks (to the next
+         * packet's preamble when building a packet index, for
+         * example): only read what it probably needs.
+         */
+        const auto isSequential = _prevOffset && offset >= *_prevOffset &&
+                                  offset - *_prevOffset < 2 * _blockLenBytes;
+
+        _prevOffset = offset;
+
+        if (!isSequential) {
+            return this->_readContig(offset, std::max(minSize, seekReadLenBytes));
+        }
+
+        const auto blockOffset = offset - offset % _blockLenBytes;
+        const auto blockEndOffset = std::min(blockOffset + _blockLenBytes, _fileLenBytes);
+
+        if (offset + minSize > blockEndOffset && blockEndOffset < _fileLenBytes) {
+            // crossing a block boundary: needs a contiguous buffer
+            return this->_readContig(offset, std::max(minSize, _blockLenBytes));
+        }
+
+        if (!this->_tryInitRing()) {
+            return this->_readContig(offset, _blockLenBytes);
+        }
+
+        auto& slot = this->_slotForBlock(blockOffset, blockOffset);
+
+        this->_readAhead(blockOffset);
+        static_cast<void>(io_uring_submit(&_ring));
+        this->_wait(slot);
+
+        // reading ahead must never recycle the slot of the current block
+        assert(slot.offset == blockOffset);
+
+        const auto offsetInBlock = offset - blockOffset;
+
+        if (static_cast<Size>(slot.res) <= offsetInBlock) {
+            // file is shorter than expected
+            return boost::none;
+        }
+
+        return yactfr::DataBlock {
+            slot.buf.get() + offsetInBlock,
+            static_cast<Size>(slot.res) - offsetInBlock
+        };
+    }
+
+    // synchronously reads up to `lenBytes` bytes at `offset` into `_contigBuf`
+    yactfr::DataBlock _readContig(const Index offset, Size lenBytes)
+    {
+        lenBytes = std::min(lenBytes, _fileLenBytes - offset);
+        _contigBuf.resize(lenBytes);
+        _contigBuf.resize(this->_pread(_contigBuf.data(), lenBytes, offset));
+        return yactfr::DataBlock {_contigBuf.data(), _contigBuf.size()};
+    }
+
+    /*
+     * Creates the io_uring instance on the first sequential read, so
+     * that a data source which only seeks doesn't need one.
+     *
+     * Returns false if it's not possible (too many open files, for
+     * example): then the data source keeps reading synchronously.
+     */
+    bool _tryInitRing()
+    {
+        if (_ringState == _RingState::NONE) {
+            const auto ret = io_uring_queue_init(static_cast<unsigned int>(_slots.size()),
+                                                 &_ring, 0);
+
+            _ringState = ret < 0 ? _RingState::FAILED : _RingState::OK;
+        }
+
+        return _ringState == _RingState::OK;
+    }
+
+    bool _isInReadAheadWindow(const _Slot& slot, const Index blockOffset) const noexcept
+    {
+        return slot.offset >= blockOffset &&
+               slot.offset < blockOffset + _slots.size() * _blockLenBytes;
+    }
+
+    _Slot *_findSlot(const Index blockOffset) noexcept
+    {
+        for (auto& slot : _slots) {
+            if ((slot.inFlight || slot.isValid) && slot.offset == blockOffset) {
+                return &slot;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /*
+     * Returns the slot of the block at `blockOffset`, which must be
+     * within the readahead window of the current block at
+     * `curBlockOffset`, preparing its read if needed.
+     */
+    _Slot& _slotForBlock(const Index blockOffset, const Index curBlockOffset)
+    {
+        assert(blockOffset >= curBlockOffset);
+
+        if (const auto slot = this->_findSlot(blockOffset)) {
+            return *slot;
+        }
+
+        /*
+         * Recycle a slot which is outside the readahead window of the
+         * current block (never the slot of the current block nor of a
+         * block between it and `blockOffset`), preferably one which
+         * isn't in flight. There's always one as the window and the
+         * slot array have the same size, and the block at `blockOffset`
+         * is in the window without having a slot.
+         */
+        _Slot *victim = nullptr;
+
+        for (auto& slot : _slots) {
+            if ((slot.inFlight || slot.isValid) &&
+                    this->_isInReadAheadWindow(slot, curBlockOffset)) {
+                continue;
+            }
+
+            if (!victim || (victim->inFlight && !slot.inFlight)) {
+                victim = &slot;
+            }
+        }
+
+        assert(victim);
+
+        if (victim->inFlight) {
+            static_cast<void>(io_uring_submit(&_ring));
+
+            while (victim->inFlight) {
+                this->_reap();
+            }
+        }
+
+        this->_prepRead(*victim, blockOffset);
+        return *victim;
+    }
+
+    void _readAhead(const Index blockOffset)
+    {
+        for (Index i = 1; i < _slots.size(); ++i) {
+            const auto aheadBlockOffset = blockOffset + i * _blockLenBytes;
+
+            if (aheadBlockOffset >= _fileLenBytes) {
+                break;
+            }
+
+            if (!this->_findSlot(aheadBlockOffset)) {
+                static_cast<void>(this->_slotForBlock(aheadBlockOffset, blockOffset));
+            }
+        }
+    }
+
+    void _prepRead(_Slot& slot, const Index blockOffset)
+    {
+        if (!slot.buf) {
+            // not value-initialized: the kernel overwrites it anyway
+            slot.buf.reset(new std::uint8_t[_blockLenBytes]);
+        }
+
+        const auto sqe = io_uring_get_sqe(&_ring);
+
+        assert(sqe);
+        io_uring_prep_read(sqe, _fd, slot.buf.get(),
+                           static_cast<unsigned int>(std::min(_blockLenBytes,
+                                                              _fileLenBytes - blockOffset)),
+                           static_cast<__u64>(blockOffset));
+        io_uring_sqe_set_data(sqe, &slot);
+        slot.offset = blockOffset;
+        slot.inFlight = true;
+        slot.isValid = false;
+    }
+
+    void _reap()
+    {
+        io_uring_cqe *cqe;
+        auto ret = io_uring_wait_cqe(&_ring, &cqe);
+
+        while (ret == -EINTR) {
+            ret = io_uring_wait_cqe(&_ring, &cqe);
+        }
+
+        if (ret < 0) {
+            throw IOError {*_path, "Cannot wait for io_uring completion."};
+        }
+
+        auto& slot = *static_cast<_Slot *>(io_uring_cqe_get_data(cqe));
+
+        slot.res = cqe->res;
+        slot.inFlight = false;
+        slot.isValid = true;
+        io_uring_cqe_seen(&_ring, cqe);
+    }
+
+    void _wait(_Slot& slot)
+    {
+        while (slot.inFlight) {
+            this->_reap();
+        }
+
+        const auto expectedLenBytes = std::min(_blockLenBytes, _fileLenBytes - slot.offset);
+
+        if (slot.res < 0) {
+            // failed asynchronous read: retry synchronously
+            slot.res = 0;
+        }
+
+        if (static_cast<Size>(slot.res) < expectedLenBytes) {
+            // short read: complete it
+            slot.res += this->_pread(slot.buf.get() + slot.res, expectedLenBytes - slot.res,
+                                     slot.offset + slot.res);
+        }
+    }
+
+    Size _pread(std::uint8_t * const buf, const Size lenBytes, const Index offset)
+    {
+        Size doneLenBytes = 0;
+
+        while (doneLenBytes < lenBytes) {
+            const auto ret = pread(_fd, buf + doneLenBytes, lenBytes - doneLenBytes,
+                                   static_cast<off_t>(offset + doneLenBytes));
+
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                std::ostringstream ss;
+
+                ss << "Cannot read " << (lenBytes - doneLenBytes) << " bytes at offset " <<
+                      (offset + doneLenBytes) << " of file `" << _path->string() << "`.";
+                throw IOError {*_path, ss.str()};
+            }
+
+            if (ret == 0) {
+                break;
+            }
+
+            doneLenBytes += static_cast<Size>(ret);
+        }
+
+        return doneLenBytes;
+    }
+
+private:
+    const boost::filesystem::path *_path;
+    const int _fd;
+    const Size _fileLenBytes;
+    const Size _blockLenBytes;
+    io_uring _ring;
+    _RingState _ringState = _RingState::NONE;
+    std::vector<_Slot> _slots;
+    std::vector<std::uint8_t> _contigBuf;
+    boost::optional<Index> _prevOffset;
+};
+
+} // namespace
+
+IoUringDataSrcFactory::IoUringDataSrcFactory(boost::filesystem::path path, const int fd,
+                                             const Size fileLenBytes, const Size queueDepth,
+                                             const Size blockLenBytes) :
+    _path {std::move(path)},
+    _fd {fd},
+    _fileLenBytes {fileLenBytes},
+    _queueDepth {std::max(queueDepth, 1ULL)},
+
+    // io_uring_prep_read() takes an `unsigned int` length
+    _blockLenBytes {std::min(blockLenBytes, static_cast<Size>(1U << 30))}
+{
+    assert(_blockLenBytes > 0);
+}
+
+bool IoUringDataSrcFactory::isSupported()
+{
+    static const auto isSupported = [] {
+        io_uring ring;
+
+        if (io_uring_queue_init(1, &ring, 0) < 0) {
+            // old kernel, seccomp policy, or disabled by sysctl
+            return false;
+        }
+
+        io_uring_queue_exit(&ring);
+        return true;
+    }();
+
+    return isSupported;
+}
+
+yactfr::DataSource::UP IoUringDataSrcFactory::_createDataSource()
+{
+    return std::make_unique<IoUringDataSrc>(_path, _fd, _fileLenBytes, _queueDepth,
+                                            _blockLenBytes);
+}
+
+} // namespace jacques
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_IO_URING_DATA_SRC_FACTORY_HPP
+#define _JACQUES_DATA_IO_URING_DATA_SRC_FACTORY_HPP
+
+#include <boost/filesystem.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Data source factory of which the data sources read a file with
+ * io_uring, keeping up to `queueDepth` block reads in flight ahead of
+ * the decoder.
+ *
+ * A data source reads the file by aligned blocks of `blockLenBytes`
+ * while the decoder reads on sequentially. When the decoder asks for
+ * data within block B, the data source makes sure that the reads of
+ * blocks B + 1 to B + `queueDepth` - 1 are submitted, so that a
+ * sequential decoder (analyzing a whole data stream file) rarely waits,
+ * and the device sees many concurrent requests instead of one page
+ * fault at a time.
+ *
+ * A request after a seek (to the preamble of the next packet when
+ * building a packet index, for example), or crossing a block boundary,
+ * gets a synchronous pread(2) into a contiguous buffer instead: a data
+ * source which only seeks reads about as much as a
+ * PreadDataSrcFactory one.
+ *
+ * A data source only creates its io_uring instance and its block
+ * buffers on its first sequential read, and falls back to synchronous
+ * reads if it can't create the instance. Still, an io_uring instance is
+ * a file descriptor and each buffer is a block: this is meant for a few
+ * long sequential scans with long-lived data sources, not for many
+ * short-lived iterators.
+ *
+ * Only available if Jacques CTF is built with liburing
+ * (`JACQUES_HAS_IO_URING` defined); use tryCreateIoUringDataSrcFactory()
+ * to get this factory when the running kernel supports io_uring.
+ *
+ * The file descriptor must remain open as long as data sources exist.
+ */
+class IoUringDataSrcFactory final :
+    public yactfr::DataSourceFactory
+{
+public:
+    explicit IoUringDataSrcFactory(boost::filesystem::path path, int fd, Size fileLenBytes,
+                                   Size queueDepth, Size blockLenBytes);
+
+    // whether or not the running kernel supports io_uring
+    static bool isSupported();
+
+private:
+    yactfr::DataSource::UP _createDataSource() override;
+
+private:
+    const boost::filesystem::path _path;
+    const int _fd;
+    const Size _fileLenBytes;
+    const Size _queueDepth;
+    const Size _blockLenBytes;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_IO_URING_DATA_SRC_FACTORY_HPP
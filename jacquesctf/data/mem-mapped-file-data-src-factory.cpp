@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "mem-mapped-file-data-src-factory.hpp"
+
+namespace jacques {
+namespace {
+
+class MemMappedFileDataSrc final :
+    public yactfr::DataSource
+{
+public:
+    explicit MemMappedFileDataSrc(MemMappedFile& file, const Size viewLenBytes) :
+        _file {&file},
+        _viewLenBytes {viewLenBytes}
+    {
+    }
+
+private:
+    boost::optional<yactfr::DataBlock> _data(const Index offset, const Size minSize) override
+    {
+        const auto fileLenBytes = _file->fileLen().bytes();
+
+        if (offset >= fileLenBytes) {
+            return boost::none;
+        }
+
+        // the last block of the file may be shorter than `minSize`
+        const auto endOffset = std::min(offset + minSize, fileLenBytes);
+
+        if (!_view.addr() || offset < _view.offsetBytes() ||
+                endOffset > _view.offsetBytes() + _view.len().bytes()) {
+            // drop the current view first: only one at a time
+            _view = MemMappedFile::View {};
+            _view = _file->view(offset, DataLen::fromBytes(std::max(minSize, _viewLenBytes)));
+        }
+
+        const auto offsetInViewBytes = offset - _view.offsetBytes();
+
+        return yactfr::DataBlock {
+            _view.addr() + offsetInViewBytes, _view.len().bytes() - offsetInViewBytes
+        };
+    }
+
+private:
+    MemMappedFile * const _file;
+    const Size _viewLenBytes;
+    MemMappedFile::View _view;
+};
+
+} // namespace
+
+MemMappedFileDataSrcFactory::MemMappedFileDataSrcFactory(MemMappedFile& file,
+                                                         const Size viewLenBytes) :
+    _file {&file},
+    _viewLenBytes {viewLenBytes}
+{
+    assert(_viewLenBytes > 0);
+}
+
+yactfr::DataSource::UP MemMappedFileDataSrcFactory::_createDataSource()
+{
+    return std::make_unique<MemMappedFileDataSrc>(*_file, _viewLenBytes);
+}
+
+} // namespace jacques
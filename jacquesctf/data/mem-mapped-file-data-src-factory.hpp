@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_MEM_MAPPED_FILE_DATA_SRC_FACTORY_HPP
+#define _JACQUES_DATA_MEM_MAPPED_FILE_DATA_SRC_FACTORY_HPP
+
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+#include "mem-mapped-file.hpp"
+
+namespace jacques {
+
+/*
+ * Data source factory of which the data sources hand the decoder views
+ * of a memory-mapped file.
+ *
+ * A data source keeps a single view of at least `viewLenBytes` (or of
+ * the minimum size which the decoder asks for, if it's greater) from
+ * the requested offset, and only creates another one when the decoder
+ * asks for data outside of it. As the views share the mappings of the
+ * memory-mapped file, the data sources don't add any mapping, whatever
+ * their number: the number of mappings remains the one of the
+ * memory-mapped file.
+ *
+ * Creating a data source is thread-safe, and so is using different
+ * data sources from different threads.
+ *
+ * The memory-mapped file must outlive the factory and its data sources.
+ */
+class MemMappedFileDataSrcFactory final :
+    public yactfr::DataSourceFactory
+{
+public:
+    explicit MemMappedFileDataSrcFactory(MemMappedFile& file, Size viewLenBytes = 8 << 20);
+
+private:
+    yactfr::DataSource::UP _createDataSource() override;
+
+private:
+    MemMappedFile * const _file;
+    const Size _viewLenBytes;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_MEM_MAPPED_FILE_DATA_SRC_FACTORY_HPP
@@ -6,10 +6,15 @@
  */
 
 #include <cassert>
+#include <cerrno>
+#include <algorithm>
+#include <numeric>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 #include <fcntl.h>
 #include <sstream>
 
@@ -20,7 +25,94 @@ namespace jacques {
 
 namespace bfs = boost::filesystem;
 
-MemMappedFile::MemMappedFile(bfs::path path, const boost::optional<int>& fd) :
+struct MemMappedFile::_Mapping final :
+    boost::noncopyable
+{
+    explicit _Mapping(void * const addr, const Size lenBytes, const Index offsetBytes) noexcept :
+        addr {addr},
+        lenBytes {lenBytes},
+        offsetBytes {offsetBytes}
+    {
+    }
+
+    ~_Mapping()
+    {
+        static_cast<void>(munmap(addr, static_cast<size_t>(lenBytes)));
+    }
+
+    void * const addr;
+    const Size lenBytes;
+    const Index offsetBytes;
+};
+
+MemMappedFile::View::View(std::shared_ptr<const void> owner, const std::uint8_t * const addr,
+                          const Index offsetBytes, const DataLen& len) noexcept :
+    _owner {std::move(owner)},
+    _addr {addr},
+    _offsetBytes {offsetBytes},
+    _len {len}
+{
+}
+
+namespace {
+
+// default chunk length when we can't map the whole file
+constexpr Size defChunkLenBytes = 64 << 20;
+
+// minor and major page fault counts of the process
+std::pair<Size, Size> pageFaultCounts() noexcept
+{
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return {0, 0};
+    }
+
+    return {static_cast<Size>(usage.ru_minflt), static_cast<Size>(usage.ru_majflt)};
+}
+
+} // namespace
+
+MemMappedFile::Window::Window(MemMappedFile& file, const Index offsetBytes, const DataLen& len,
+                              const Size viewLenBytes) noexcept :
+    _file {&file},
+    _offsetBytes {offsetBytes},
+    _len {len},
+    _viewLenBytes {viewLenBytes}
+{
+}
+
+const std::uint8_t *MemMappedFile::Window::addr(const Index offsetInRegionBytes,
+                                                const Size lenBytes)
+{
+    assert(_file);
+    assert(offsetInRegionBytes + lenBytes <= _len.bytes());
+
+    const auto offsetBytes = _offsetBytes + offsetInRegionBytes;
+
+    _file->_access(offsetBytes, lenBytes);
+
+    if (!_view.addr() || offsetBytes < _view.offsetBytes() ||
+            offsetBytes + lenBytes > _view.offsetBytes() + _view.len().bytes()) {
+        const auto viewLenBytes = std::min(std::max(_viewLenBytes, lenBytes), _len.bytes());
+        const auto centerInRegionBytes = offsetInRegionBytes + lenBytes / 2;
+        auto viewOffsetInRegionBytes = centerInRegionBytes - std::min(centerInRegionBytes,
+                                                                      viewLenBytes / 2);
+
+        viewOffsetInRegionBytes = std::min(viewOffsetInRegionBytes, _len.bytes() - viewLenBytes);
+
+        // drop the current view first: only one at a time
+        _view = View {};
+        _view = _file->view(_offsetBytes + viewOffsetInRegionBytes,
+                            DataLen::fromBytes(viewLenBytes));
+        ++_viewCount;
+    }
+
+    return _view.addr() + (offsetBytes - _view.offsetBytes());
+}
+
+MemMappedFile::MemMappedFile(bfs::path path, const boost::optional<int>& fd,
+                             const boost::optional<Size>& chunkLenBytes) :
     _path {std::move(path)}
 {
     if (fd) {
@@ -38,82 +130,338 @@ MemMappedFile::MemMappedFile(bfs::path path, const boost::optional<int>& fd) :
     _fileLen = DataLen::fromBytes(bfs::file_size(_path));
     _mmapOffsetGranularityBytes = sysconf(_SC_PAGE_SIZE);
     assert(_mmapOffsetGranularityBytes >= 1);
+
+    if (chunkLenBytes) {
+        _chunkLenBytes = *chunkLenBytes;
+        _isChunkLenFixed = true;
+    } else {
+        _chunkLenBytes = sizeof(void *) >= 8 ? _fileLen.bytes() : defChunkLenBytes;
+        _isChunkLenFixed = false;
+    }
+
+    // chunks must begin on a mapping offset boundary
+    _chunkLenBytes = std::max(_chunkLenBytes, _mmapOffsetGranularityBytes);
+    _chunkLenBytes = (_chunkLenBytes + _mmapOffsetGranularityBytes - 1) &
+                     ~(_mmapOffsetGranularityBytes - 1);
+    _accessPolicy.emplace(_fileLen.bytes());
+
+    const auto faultCounts = pageFaultCounts();
+
+    _baseMinorPageFaultCount = faultCounts.first;
+    _baseMajorPageFaultCount = faultCounts.second;
+}
+
+MemMappedFile::MemMappedFile(std::shared_ptr<ZstdSeekableFile> zstdFile) :
+    _path {zstdFile->path()},
+    _fileLen {zstdFile->contentLen()},
+    _mmapOffsetGranularityBytes {1},
+    _chunkLenBytes {zstdFile->contentLen().bytes()},
+    _isChunkLenFixed {true},
+    _zstdFile {std::move(zstdFile)}
+{
 }
 
 MemMappedFile::~MemMappedFile()
 {
+    // existing views keep their mappings alive: they don't need the file
     if (_fd >= 0 && _closeFd) {
         static_cast<void>(close(_fd));
     }
 }
 
-void MemMappedFile::_unmap()
+std::shared_ptr<MemMappedFile::_Mapping> MemMappedFile::_map(const Index offsetBytes,
+                                                             const Size lenBytes)
 {
-    if (_mmapAddr) {
-        munmap(_mmapAddr, static_cast<size_t>(_mmapLen.bytes()));
-        _mmapAddr = nullptr;
-        _mmapLen = 0;
-        _mapAddr = nullptr;
-        _mapLen = 0;
-        _mapOffsetBytes = 0;
+    assert((offsetBytes & (_mmapOffsetGranularityBytes - 1)) == 0);
+    assert(lenBytes > 0);
+
+    const auto addr = mmap(NULL, static_cast<size_t>(lenBytes), PROT_READ, MAP_PRIVATE, _fd,
+                           static_cast<off_t>(offsetBytes));
+
+    if (addr == MAP_FAILED) {
+        return nullptr;
     }
+
+    auto mapping = std::make_shared<_Mapping>(addr, lenBytes, offsetBytes);
+
+    this->_advice(*mapping);
+    return mapping;
 }
 
-void MemMappedFile::map(const Index offsetBytes, const DataLen& len)
+std::shared_ptr<MemMappedFile::_Mapping> MemMappedFile::_chunkMapping(const Index chunkIndex)
 {
-    this->_unmap();
+    auto& weakMapping = _chunkMappings[chunkIndex];
+    auto mapping = weakMapping.lock();
+
+    if (mapping) {
+        return mapping;
+    }
 
-    const auto mmapOffsetBytes = offsetBytes & ~(_mmapOffsetGranularityBytes - 1);
-    const auto lenBetweenOffsetsBytes = offsetBytes - mmapOffsetBytes;
+    const auto offsetBytes = chunkIndex * _chunkLenBytes;
 
-    _mmapLen = DataLen::fromBytes(std::min(_fileLen.bytes() - mmapOffsetBytes,
-                                           len.bytes() + lenBetweenOffsetsBytes));
+    mapping = this->_map(offsetBytes, std::min(_chunkLenBytes, _fileLen.bytes() - offsetBytes));
+    weakMapping = mapping;
+    return mapping;
+}
 
-    if (_mmapLen == 0) {
-        return;
+MemMappedFile::View MemMappedFile::view(const Index offsetBytes, const DataLen& len)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return this->_view(offsetBytes, len);
+}
+
+MemMappedFile::View MemMappedFile::_view(const Index offsetBytes, const DataLen& len)
+{
+    if (offsetBytes >= _fileLen.bytes() || len == 0) {
+        return View {};
+    }
+
+    const auto lenBytes = std::min(_fileLen.bytes() - offsetBytes, len.bytes());
+
+    if (_zstdFile) {
+        auto region = _zstdFile->region(offsetBytes, lenBytes);
+        const auto addr = region.get();
+
+        return View {std::move(region), addr, offsetBytes, DataLen::fromBytes(lenBytes)};
     }
 
-    _mmapAddr = mmap(NULL, static_cast<size_t>(_mmapLen.bytes()), PROT_READ, MAP_PRIVATE, _fd,
-                     static_cast<off_t>(mmapOffsetBytes));
+    const auto firstChunkIndex = offsetBytes / _chunkLenBytes;
+    const auto lastChunkIndex = (offsetBytes + lenBytes - 1) / _chunkLenBytes;
+    std::shared_ptr<_Mapping> mapping;
+
+    if (firstChunkIndex == lastChunkIndex) {
+        mapping = this->_chunkMapping(firstChunkIndex);
+
+        if (!mapping && !_isChunkLenFixed && _chunkLenBytes > defChunkLenBytes &&
+                errno == ENOMEM) {
+            /*
+             * Not enough virtual address space for the whole file: fall
+             * back to smaller chunks. Existing views keep their
+             * mappings.
+             */
+            _chunkLenBytes = defChunkLenBytes;
+            _chunkMappings.clear();
+            return this->_view(offsetBytes, len);
+        }
+    } else {
+        const auto mmapOffsetBytes = offsetBytes & ~(_mmapOffsetGranularityBytes - 1);
+
+        // sliding windows leave many expired entries behind
+        for (auto it = _crossingMappings.begin(); it != _crossingMappings.end();) {
+            if (it->second.expired() && it->first != mmapOffsetBytes) {
+                it = _crossingMappings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto& weakMapping = _crossingMappings[mmapOffsetBytes];
+
+        mapping = weakMapping.lock();
 
-    if (_mmapAddr == MAP_FAILED) {
+        if (!mapping || mapping->offsetBytes + mapping->lenBytes < offsetBytes + lenBytes) {
+            mapping = this->_map(mmapOffsetBytes, offsetBytes + lenBytes - mmapOffsetBytes);
+            weakMapping = mapping;
+        }
+    }
+
+    if (!mapping) {
         std::ostringstream ss;
 
-        ss << "Cannot memory-map region [" << mmapOffsetBytes << ", " <<
-              (mmapOffsetBytes + _mmapLen.bytes() - 1) << "] of file `" <<
-              _path.string() << "`.";
-        _mmapAddr = nullptr;
-        _mmapLen = 0;
+        ss << "Cannot memory-map region [" << offsetBytes << ", " <<
+              (offsetBytes + lenBytes - 1) << "] of file `" << _path.string() << "`.";
         throw IOError {_path, ss.str()};
     }
 
-    _mapAddr = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(_mmapAddr) +
-                                        lenBetweenOffsetsBytes);
-    _mapLen = DataLen::fromBytes(std::min(_fileLen.bytes() - mmapOffsetBytes, len.bytes()));
-    _mapOffsetBytes = offsetBytes;
-    this->_advice();
+    const auto addr = static_cast<const std::uint8_t *>(mapping->addr) +
+                      (offsetBytes - mapping->offsetBytes);
+
+    return View {std::move(mapping), addr, offsetBytes, DataLen::fromBytes(lenBytes)};
 }
 
-void MemMappedFile::_advice()
+MemMappedFile::Window MemMappedFile::window(const Index offsetBytes, const DataLen& len,
+                                           const Size viewLenBytes)
 {
-    if (_mmapAddr && _mmapLen > 0) {
-        static_cast<void>(madvise(_mmapAddr, static_cast<size_t>(_mmapLen.bytes()), _mmapAdvice));
-    }
+    const auto lenBytes = offsetBytes >= _fileLen.bytes() ? 0 :
+                          std::min(_fileLen.bytes() - offsetBytes, len.bytes());
+
+    return Window {*this, offsetBytes, DataLen::fromBytes(lenBytes), viewLenBytes};
+}
+
+Size MemMappedFile::mappingCount() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+    const auto accOp = [](const auto count, const auto& pair) {
+        return count + (pair.second.expired() ? 0 : 1);
+    };
+
+    return std::accumulate(_chunkMappings.begin(), _chunkMappings.end(), 0ULL, accOp) +
+           std::accumulate(_crossingMappings.begin(), _crossingMappings.end(), 0ULL, accOp);
+}
+
+void MemMappedFile::_advice(const _Mapping& mapping) const
+{
+    static_cast<void>(madvise(mapping.addr, static_cast<size_t>(mapping.lenBytes), _mmapAdvice));
 }
 
 void MemMappedFile::advice(const Advice advice)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    this->_setAdvice(advice);
+}
+
+void MemMappedFile::_setAdvice(const Advice advice)
 {
     switch (advice) {
     case Advice::NORMAL:
         _mmapAdvice = MADV_NORMAL;
         break;
 
+    case Advice::SEQUENTIAL:
+        _mmapAdvice = MADV_SEQUENTIAL;
+        break;
+
     case Advice::RANDOM:
         _mmapAdvice = MADV_RANDOM;
         break;
     }
 
-    this->_advice();
+    for (const auto& weakMappings : {&_chunkMappings, &_crossingMappings}) {
+        for (const auto& pair : *weakMappings) {
+            if (const auto mapping = pair.second.lock()) {
+                this->_advice(*mapping);
+            }
+        }
+    }
+}
+
+void MemMappedFile::_access(const Index offsetBytes, const Size lenBytes)
+{
+    if (!_accessPolicy) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    ++_stats.accessCount;
+    _accessPolicy->access(offsetBytes, lenBytes, _hints);
+    this->_applyHints();
+}
+
+void MemMappedFile::expect(const Index offsetBytes, const DataLen& len)
+{
+    if (!_accessPolicy) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    _accessPolicy->expect(offsetBytes, len.bytes(), _hints);
+    this->_applyHints();
+}
+
+void MemMappedFile::_applyHints()
+{
+    for (const auto& hint : _hints) {
+        switch (hint.kind) {
+        case AccessPolicy::Hint::Kind::PREFETCH:
+            this->_prefetch(hint.offsetBytes, hint.lenBytes);
+            break;
+
+        case AccessPolicy::Hint::Kind::RELEASE:
+            this->_release(hint.offsetBytes, hint.lenBytes);
+            break;
+
+        case AccessPolicy::Hint::Kind::PATTERN:
+            switch (hint.pattern) {
+            case AccessPolicy::Pattern::SEQUENTIAL:
+                this->_setAdvice(Advice::SEQUENTIAL);
+                break;
+
+            case AccessPolicy::Pattern::RANDOM:
+                this->_setAdvice(Advice::RANDOM);
+                break;
+
+            default:
+                // the kernel's readahead only goes forward
+                this->_setAdvice(Advice::NORMAL);
+                break;
+            }
+
+            break;
+        }
+    }
+
+    _hints.clear();
+}
+
+void MemMappedFile::_prefetch(const Index offsetBytes, const Size lenBytes)
+{
+    // advise the file rather than a mapping: the range doesn't need to be mapped yet
+    static_cast<void>(posix_fadvise(_fd, static_cast<off_t>(offsetBytes),
+                                    static_cast<off_t>(lenBytes), POSIX_FADV_WILLNEED));
+    ++_stats.prefetchCount;
+    _stats.prefetchLenBytes += lenBytes;
+}
+
+void MemMappedFile::_release(const Index offsetBytes, const Size lenBytes)
+{
+    /*
+     * MADV_DONTNEED on a private, read-only file mapping only drops
+     * our page table entries: the pages remain in the page cache, and
+     * an access simply faults them in again with the same content.
+     */
+    const auto endOffsetBytes = offsetBytes + lenBytes;
+
+    for (const auto& weakMappings : {&_chunkMappings, &_crossingMappings}) {
+        for (const auto& pair : *weakMappings) {
+            const auto mapping = pair.second.lock();
+
+            if (!mapping || endOffsetBytes <= mapping->offsetBytes ||
+                    offsetBytes >= mapping->offsetBytes + mapping->lenBytes) {
+                continue;
+            }
+
+            // whole pages within both the range and the mapping
+            auto beginOffsetInMappingBytes = std::max(offsetBytes, mapping->offsetBytes) -
+                                             mapping->offsetBytes;
+            const auto endOffsetInMappingBytes = (std::min(endOffsetBytes,
+                                                           mapping->offsetBytes +
+                                                           mapping->lenBytes) -
+                                                  mapping->offsetBytes) &
+                                                 ~(_mmapOffsetGranularityBytes - 1);
+
+            beginOffsetInMappingBytes = (beginOffsetInMappingBytes +
+                                         _mmapOffsetGranularityBytes - 1) &
+                                        ~(_mmapOffsetGranularityBytes - 1);
+
+            if (beginOffsetInMappingBytes >= endOffsetInMappingBytes) {
+                continue;
+            }
+
+            static_cast<void>(madvise(static_cast<std::uint8_t *>(mapping->addr) +
+                                      beginOffsetInMappingBytes,
+                                      static_cast<size_t>(endOffsetInMappingBytes -
+                                                          beginOffsetInMappingBytes),
+                                      MADV_DONTNEED));
+            _stats.releaseLenBytes += endOffsetInMappingBytes - beginOffsetInMappingBytes;
+        }
+    }
+
+    ++_stats.releaseCount;
+}
+
+MemMappedFile::Stats MemMappedFile::stats() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+    auto stats = _stats;
+    const auto faultCounts = pageFaultCounts();
+
+    stats.minorPageFaultCount = faultCounts.first - _baseMinorPageFaultCount;
+    stats.majorPageFaultCount = faultCounts.second - _baseMajorPageFaultCount;
+    return stats;
 }
 
 } // namespace jacques
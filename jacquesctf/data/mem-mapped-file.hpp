@@ -10,6 +10,10 @@
 
 #include <string>
 #include <cstdlib>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <boost/core/noncopyable.hpp>
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
@@ -17,41 +21,224 @@
 
 #include "aliases.hpp"
 #include "data-len.hpp"
+#include "access-policy.hpp"
+#include "zstd-seekable-file.hpp"
 
 namespace jacques {
 
+/*
+ * Memory-mapped file.
+ *
+ * A memory-mapped file hands out views of regions of a file (one per
+ * packet, typically) which share a few large memory mappings instead
+ * of having one mapping each: the number of mappings remains bounded
+ * whatever the number of views.
+ *
+ * The file is split into chunks of a given length. A view which is
+ * completely within a chunk shares the mapping of this chunk with all
+ * the other views within it. A view which crosses a chunk boundary has
+ * its own mapping; as views of packets don't overlap, there's at most
+ * one such view per chunk boundary.
+ *
+ * On a 64-bit system, where the virtual address space isn't an issue,
+ * the default chunk length is the file length: all the views share a
+ * single whole-file mapping. If this mapping fails, the memory-mapped
+ * file falls back to the 32-bit default chunk length.
+ *
+ * A mapping is reference-counted: it remains alive as long as a view
+ * refers to it, even if the memory-mapped file itself is destroyed.
+ *
+ * A memory-mapped file can also stand for the decompressed content of a
+ * Zstandard seekable file: then there's no actual memory mapping, and a
+ * view refers to a decompressed frame (or to a copy of the frames it
+ * crosses) instead.
+ *
+ * All the public methods are thread-safe, as well as using different
+ * windows from different threads: the packets of a data stream file,
+ * whatever the thread which creates them, share its memory-mapped file.
+ */
 class MemMappedFile final :
     boost::noncopyable
 {
+private:
+    struct _Mapping;
+
 public:
-    explicit MemMappedFile(boost::filesystem::path path,
-                           const boost::optional<int>& fd = boost::none);
-    ~MemMappedFile();
+    class View final
+    {
+        friend class MemMappedFile;
+
+    public:
+        View() = default;
+
+    private:
+        explicit View(std::shared_ptr<const void> owner, const std::uint8_t *addr,
+                      Index offsetBytes, const DataLen& len) noexcept;
+
+    public:
+        const std::uint8_t *addr() const noexcept
+        {
+            return _addr;
+        }
+
+        Index offsetBytes() const noexcept
+        {
+            return _offsetBytes;
+        }
+
+        const DataLen& len() const noexcept
+        {
+            return _len;
+        }
+
+    private:
+        // keeps the underlying mapping (or decompressed data) alive
+        std::shared_ptr<const void> _owner;
+
+        const std::uint8_t *_addr = nullptr;
+        Index _offsetBytes = 0;
+        DataLen _len = 0;
+    };
+
+    /*
+     * Sliding window over a region of a memory-mapped file.
+     *
+     * A window only keeps a view of at most `viewLenBytes` (or of the
+     * length of the last request, if it's greater) of its region,
+     * creating it on the first access: a region which is shorter than
+     * this is viewed at once, and its view never moves, while a huge
+     * region (a multi-gigabyte packet) only has the part around the
+     * last access mapped.
+     *
+     * When an access is outside the current view, the new view is
+     * centered on it: the accesses must then move about half the view
+     * length away before the window moves again, so that going back
+     * and forth around a view boundary doesn't remap each time.
+     *
+     * The memory-mapped file must outlive the window.
+     */
+    class Window final
+    {
+        friend class MemMappedFile;
+
+    public:
+        Window() = default;
+
+    private:
+        explicit Window(MemMappedFile& file, Index offsetBytes, const DataLen& len,
+                        Size viewLenBytes) noexcept;
+
+    public:
+        /*
+         * Returns the address of the byte at `offsetInRegionBytes`,
+         * making sure that the `lenBytes` bytes from there are
+         * addressable.
+         *
+         * The returned address remains valid until the window moves,
+         * that is, until a call to this method with a region which
+         * isn't within the current view.
+         */
+        const std::uint8_t *addr(Index offsetInRegionBytes, Size lenBytes = 1);
+
+        // whether or not the region is larger than the view length
+        bool isSliding() const noexcept
+        {
+            return _len.bytes() > _viewLenBytes;
+        }
+
+        // number of times this window created a view
+        Size viewCount() const noexcept
+        {
+            return _viewCount;
+        }
+
+        const DataLen& len() const noexcept
+        {
+            return _len;
+        }
+
+    private:
+        MemMappedFile *_file = nullptr;
+        Index _offsetBytes = 0;
+        DataLen _len = 0;
+        Size _viewLenBytes = 0;
+        View _view;
+        Size _viewCount = 0;
+    };
 
 public:
     enum class Advice {
         NORMAL,
+        SEQUENTIAL,
         RANDOM,
     };
 
+    // access policy statistics
+    struct Stats
+    {
+        // accesses through windows
+        Size accessCount = 0;
+
+        Size prefetchCount = 0;
+        Size prefetchLenBytes = 0;
+        Size releaseCount = 0;
+        Size releaseLenBytes = 0;
+
+        // page faults of the whole process since this object exists
+        Size minorPageFaultCount = 0;
+        Size majorPageFaultCount = 0;
+    };
+
 public:
-    void map(Index offsetBytes, const DataLen& len);
+    /*
+     * Builds a memory-mapped file for the file `path`, using the open
+     * file descriptor `fd` if set (not closed by this object).
+     *
+     * `chunkLenBytes`, if set, overrides the default chunk length.
+     */
+    explicit MemMappedFile(boost::filesystem::path path,
+                           const boost::optional<int>& fd = boost::none,
+                           const boost::optional<Size>& chunkLenBytes = boost::none);
+
+    /*
+     * Builds a memory-mapped file of which the views are regions of
+     * the decompressed content of `zstdFile`.
+     */
+    explicit MemMappedFile(std::shared_ptr<ZstdSeekableFile> zstdFile);
+
+    ~MemMappedFile();
+
+    /*
+     * Returns a view of the region of `len` (truncated to the file
+     * length) at `offsetBytes`, mapping it if needed.
+     */
+    View view(Index offsetBytes, const DataLen& len);
+
+    /*
+     * Returns a sliding window over the region of `len` (truncated to
+     * the file length) at `offsetBytes`, not mapping anything yet.
+     */
+    Window window(Index offsetBytes, const DataLen& len, Size viewLenBytes = 16 << 20);
+
+    /*
+     * Applies `advice` to the current and future mappings.
+     *
+     * The access policy of this memory-mapped file also calls this
+     * when the access pattern through windows changes.
+     */
     void advice(Advice advice);
 
-    const std::uint8_t *addr() const noexcept
-    {
-        return static_cast<std::uint8_t *>(_mapAddr);
-    }
+    /*
+     * Tells that the region of `len` at `offsetBytes` will be read
+     * soon (through any mapping of the file), so that the kernel can
+     * start reading it.
+     */
+    void expect(Index offsetBytes, const DataLen& len);
 
-    Index offsetBytes() const noexcept
-    {
-        return _mapOffsetBytes;
-    }
+    Stats stats() const;
 
-    const DataLen& len() const noexcept
-    {
-        return _mapLen;
-    }
+    // number of mappings which still exist (always 0 when decompressing)
+    Size mappingCount() const;
 
     const DataLen& fileLen() const noexcept
     {
@@ -64,21 +251,46 @@ public:
     }
 
 private:
-    void _unmap();
-    void _advice();
+    View _view(Index offsetBytes, const DataLen& len);
+    void _setAdvice(Advice advice);
+    void _access(Index offsetBytes, Size lenBytes);
+    void _applyHints();
+    void _prefetch(Index offsetBytes, Size lenBytes);
+    void _release(Index offsetBytes, Size lenBytes);
+    std::shared_ptr<_Mapping> _map(Index offsetBytes, Size lenBytes);
+    std::shared_ptr<_Mapping> _chunkMapping(Index chunkIndex);
+    void _advice(const _Mapping& mapping) const;
 
 private:
     const boost::filesystem::path _path;
-    void *_mmapAddr = nullptr;
-    DataLen _mmapLen = 0;
-    int _mmapAdvice = MADV_NORMAL;
     int _fd = -1;
     bool _closeFd = false;
     DataLen _fileLen;
     Index _mmapOffsetGranularityBytes;
-    void *_mapAddr = nullptr;
-    DataLen _mapLen = 0;
-    Index _mapOffsetBytes = 0;
+
+    // protects everything below
+    mutable std::mutex _mutex;
+
+    Size _chunkLenBytes;
+    bool _isChunkLenFixed;
+    int _mmapAdvice = MADV_NORMAL;
+
+    // shared chunk mappings (chunk index -> mapping)
+    std::map<Index, std::weak_ptr<_Mapping>> _chunkMappings;
+
+    // own mappings of views crossing a chunk boundary (offset -> mapping)
+    std::map<Index, std::weak_ptr<_Mapping>> _crossingMappings;
+
+    // decompressed content source, if any
+    std::shared_ptr<ZstdSeekableFile> _zstdFile;
+
+    // access policy (not with decompressed content) and its hints
+    boost::optional<AccessPolicy> _accessPolicy;
+    AccessPolicy::Hints _hints;
+
+    Stats _stats;
+    Size _baseMinorPageFaultCount = 0;
+    Size _baseMajorPageFaultCount = 0;
 };
 
 } // namespace jacques
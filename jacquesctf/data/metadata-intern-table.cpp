@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <yactfr/yactfr.hpp>
+
+#include "metadata-intern-table.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+namespace {
+
+namespace bfs = boost::filesystem;
+
+std::string readFile(const bfs::path& path)
+{
+    std::ifstream stream {path.string().c_str(), std::ios::in | std::ios::binary};
+
+    if (!stream) {
+        throw IOError {path, "Cannot open file."};
+    }
+
+    return std::string {
+        std::istreambuf_iterator<char> {stream}, std::istreambuf_iterator<char> {}
+    };
+}
+
+// 64-bit FNV-1a
+std::uint64_t contentHash(const std::string& content) noexcept
+{
+    std::uint64_t hash = 14'695'981'039'346'656'037ULL;
+
+    for (const auto ch : content) {
+        hash ^= static_cast<std::uint8_t>(ch);
+        hash *= 1'099'511'628'211ULL;
+    }
+
+    return hash;
+}
+
+std::shared_ptr<const Metadata> parseMetadata(const bfs::path& path, const std::string& content)
+{
+    std::istringstream contentStream {content};
+
+    try {
+        auto metadataStream = yactfr::createMetadataStream(contentStream);
+        auto traceTypeMetadataStreamUuidPair = yactfr::fromMetadataText(metadataStream->text());
+
+        return std::make_shared<const Metadata>(path,
+                                                std::move(traceTypeMetadataStreamUuidPair.first),
+                                                std::move(metadataStream),
+                                                std::move(traceTypeMetadataStreamUuidPair.second));
+    } catch (const yactfr::InvalidMetadataStream& exc) {
+        throw MetadataError<yactfr::InvalidMetadataStream> {path, exc};
+    } catch (const yactfr::TextParseError& exc) {
+        throw MetadataError<yactfr::TextParseError> {path, exc};
+    }
+}
+
+} // namespace
+
+MetadataInternTable& MetadataInternTable::instance()
+{
+    static MetadataInternTable table;
+
+    return table;
+}
+
+std::shared_ptr<const Metadata> MetadataInternTable::_find(const std::uint64_t hash,
+                                                           const std::string& content) const
+{
+    const auto range = _entries.equal_range(hash);
+
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.content == content) {
+            return it->second.metadata;
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<const Metadata> MetadataInternTable::_intern(const std::uint64_t hash,
+                                                             std::string content,
+                                                             std::shared_ptr<const Metadata> metadata)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    // another thread could have interned the same content meanwhile
+    if (auto existingMetadata = this->_find(hash, content)) {
+        return existingMetadata;
+    }
+
+    _entries.insert({hash, _Entry {std::move(content), metadata}});
+    return metadata;
+}
+
+std::shared_ptr<const Metadata> MetadataInternTable::metadata(const bfs::path& path)
+{
+    assert(bfs::is_regular_file(path));
+
+    auto content = readFile(path);
+    const auto hash = contentHash(content);
+
+    {
+        std::lock_guard<std::mutex> lock {_mutex};
+
+        if (auto metadata = this->_find(hash, content)) {
+            return metadata;
+        }
+    }
+
+    auto metadata = parseMetadata(path, content);
+
+    return this->_intern(hash, std::move(content), std::move(metadata));
+}
+
+void MetadataInternTable::preload(const std::vector<bfs::path>& paths, Size threadCount)
+{
+    struct Job
+    {
+        const bfs::path *path;
+        std::uint64_t hash;
+        std::string content;
+    };
+
+    std::vector<Job> jobs;
+
+    // read and hash everything first: only parse distinct contents
+    for (const auto& path : paths) {
+        std::string content;
+
+        try {
+            content = readFile(path);
+        } catch (const IOError&) {
+            continue;
+        }
+
+        const auto hash = contentHash(content);
+        const auto isKnown = [&] {
+            std::lock_guard<std::mutex> lock {_mutex};
+
+            return static_cast<bool>(this->_find(hash, content));
+        }();
+
+        const auto isDup = std::any_of(jobs.begin(), jobs.end(), [hash, &content](const auto& job) {
+            return job.hash == hash && job.content == content;
+        });
+
+        if (!isKnown && !isDup) {
+            jobs.push_back({&path, hash, std::move(content)});
+        }
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    threadCount = std::min(threadCount, static_cast<Size>(jobs.size()));
+
+    std::atomic<Index> nextJobIndex {0};
+    std::vector<std::thread> threads;
+
+    for (Index i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, &jobs, &nextJobIndex] {
+            while (true) {
+                const auto jobIndex = nextJobIndex++;
+
+                if (jobIndex >= jobs.size()) {
+                    break;
+                }
+
+                auto& job = jobs[jobIndex];
+
+                try {
+                    auto metadata = parseMetadata(*job.path, job.content);
+
+                    this->_intern(job.hash, std::move(job.content), std::move(metadata));
+                } catch (...) {
+                    // metadata() reports it
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace jacques
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_METADATA_INTERN_TABLE_HPP
+#define _JACQUES_DATA_METADATA_INTERN_TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <boost/filesystem.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+#include "metadata.hpp"
+
+namespace jacques {
+
+/*
+ * Process-wide metadata intern table.
+ *
+ * A collection of traces from many hosts usually contains a lot of
+ * byte-identical metadata files (same tracer version, same event
+ * record types). This table keeps one Metadata object per distinct
+ * metadata file content, keyed by a hash of the content, so that the
+ * traces of such files share the same trace type and data type maps
+ * instead of parsing the same text again.
+ *
+ * All the methods are thread-safe.
+ */
+class MetadataInternTable final :
+    boost::noncopyable
+{
+public:
+    static MetadataInternTable& instance();
+
+    /*
+     * Returns the metadata of the file `path`, only parsing it if no
+     * interned metadata has the same content.
+     *
+     * Throws MetadataError if the file isn't valid metadata, or
+     * IOError if it can't be read.
+     */
+    std::shared_ptr<const Metadata> metadata(const boost::filesystem::path& path);
+
+    /*
+     * Interns the metadata of the files `paths`, parsing the distinct
+     * contents in parallel with `threadCount` threads (0 means the
+     * number of hardware threads).
+     *
+     * This method ignores invalid metadata files: metadata() reports
+     * their errors later.
+     */
+    void preload(const std::vector<boost::filesystem::path>& paths, Size threadCount = 0);
+
+private:
+    struct _Entry
+    {
+        // file content, to confirm a hash match
+        std::string content;
+
+        std::shared_ptr<const Metadata> metadata;
+    };
+
+private:
+    explicit MetadataInternTable() = default;
+    std::shared_ptr<const Metadata> _find(std::uint64_t hash, const std::string& content) const;
+    std::shared_ptr<const Metadata> _intern(std::uint64_t hash, std::string content,
+                                            std::shared_ptr<const Metadata> metadata);
+
+private:
+    mutable std::mutex _mutex;
+    std::unordered_multimap<std::uint64_t, _Entry> _entries;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_METADATA_INTERN_TABLE_HPP
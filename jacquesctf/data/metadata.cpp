@@ -6,6 +6,7 @@
  */
 
 #include <memory>
+#include <functional>
 #include <fstream>
 #include <numeric>
 #include <yactfr/yactfr.hpp>
@@ -26,7 +27,6 @@ Metadata::Metadata(boost::filesystem::path path, yactfr::TraceType::UP traceType
     _stream {std::move(stream)},
     _streamUuid {std::move(streamUuid)}
 {
-    this->_setDtParents();
     this->_setIsCorrelatable();
 }
 
@@ -51,14 +51,23 @@ void Metadata::_setIsCorrelatable()
     _isCorrelatable = true;
 }
 
+/*
+ * Calls the parent function with each visited data type and its parent
+ * (`nullptr` for a root), and/or the path function with each visited
+ * data type and its path, as long as the corresponding function is
+ * set.
+ */
 class SetDtParentsPathsVisitor final :
     public yactfr::DataTypeVisitor
 {
 public:
-    explicit SetDtParentsPathsVisitor(Metadata::DtParentMap& dtParentMap,
-                                      Metadata::DtPathMap& dtPathMap) noexcept :
-        _dtParentMap {&dtParentMap},
-        _dtPathMap {&dtPathMap}
+    using ParentFunc = std::function<void (const yactfr::DataType&, const yactfr::DataType *)>;
+    using PathFunc = std::function<void (const yactfr::DataType&, DtPath)>;
+
+public:
+    explicit SetDtParentsPathsVisitor(ParentFunc parentFunc, PathFunc pathFunc) :
+        _parentFunc {std::move(parentFunc)},
+        _pathFunc {std::move(pathFunc)}
     {
     }
 
@@ -218,18 +227,13 @@ private:
 
     void _setParentAndPath(const yactfr::DataType& dt)
     {
-        this->_setParent(dt);
-        this->_setPath(dt);
-    }
-
-    void _setParent(const yactfr::DataType& dt)
-    {
-        if (_stack.empty()) {
-            // root
-            return;
+        if (_parentFunc) {
+            _parentFunc(dt, _stack.empty() ? nullptr : _stack.back().parentDt);
         }
 
-        (*_dtParentMap)[&dt] = _stack.back().parentDt;
+        if (_pathFunc) {
+            this->_setPath(dt);
+        }
     }
 
     void _setPath(const yactfr::DataType& dt)
@@ -241,7 +245,7 @@ private:
             return entry.pathItem;
         });
 
-        _dtPathMap->insert(std::make_pair(&dt, DtPath {_scope, std::move(items)}));
+        _pathFunc(dt, DtPath {_scope, std::move(items)});
     }
 
 private:
@@ -253,99 +257,175 @@ private:
 
 private:
     yactfr::Scope _scope;
-    Metadata::DtParentMap * const _dtParentMap;
-    Metadata::DtPathMap * const _dtPathMap;
+    const ParentFunc _parentFunc;
+    const PathFunc _pathFunc;
     std::vector<_StackEntry> _stack;
 };
 
 namespace {
 
-void setScopeDtParentsPaths(SetDtParentsPathsVisitor& visitor, Metadata::DtScopeMap& dtScopes,
-                            const yactfr::DataType *dt)
+void setScopeDtParentsPaths(SetDtParentsPathsVisitor& visitor, const yactfr::DataType * const dt)
 {
     if (!dt) {
         return;
     }
 
-    dtScopes[dt] = visitor.scope();
     dt->accept(visitor);
 }
 
+/*
+ * Calls `func` with the scope and root data type of each scope of the
+ * data stream type `dst`, or of the packet header if `dst` is
+ * `nullptr`.
+ */
+template <typename FuncT>
+void forEachScopeDt(const yactfr::TraceType& traceType, const yactfr::DataStreamType * const dst,
+                    FuncT&& func)
+{
+    if (!dst) {
+        func(yactfr::Scope::PACKET_HEADER, traceType.packetHeaderType());
+        return;
+    }
+
+    func(yactfr::Scope::PACKET_CONTEXT, dst->packetContextType());
+    func(yactfr::Scope::EVENT_RECORD_HEADER, dst->eventRecordHeaderType());
+    func(yactfr::Scope::EVENT_RECORD_COMMON_CONTEXT, dst->eventRecordCommonContextType());
+
+    for (auto& ert : dst->eventRecordTypes()) {
+        func(yactfr::Scope::EVENT_RECORD_SPECIFIC_CONTEXT, ert->specificContextType());
+        func(yactfr::Scope::EVENT_RECORD_PAYLOAD, ert->payloadType());
+    }
+}
+
 } // namespace
 
-void Metadata::_setDtParents()
+void Metadata::_ensureDtParents() const
 {
-    SetDtParentsPathsVisitor visitor {_dtParents, _dtPaths};
+    std::call_once(_dtParentsOnceFlag, [this] {
+        this->_setDtParents();
+    });
+}
+
+void Metadata::_setDtParents() const
+{
+    yactfr::Scope curScope;
+    const yactfr::DataStreamType *curDst = nullptr;
+
+    // assign ordinals in visiting order
+    SetDtParentsPathsVisitor visitor {
+        [this, &curScope, &curDst](const auto& dt, const auto parentDt) {
+            const auto ordinal = static_cast<DtOrdinalMap::Ordinal>(_dtParents.size());
+
+            if (!_dtOrdinals.insert(dt, ordinal)) {
+                // already visited
+                return;
+            }
+
+            _dtParents.push_back(parentDt);
+            _dtScopes.push_back(curScope);
+            _dtDsts.push_back(curDst);
+        },
+        nullptr
+    };
+
+    const auto setDstDtParents = [this, &visitor, &curScope,
+                                  &curDst](const yactfr::DataStreamType * const dst) {
+        curDst = dst;
+        forEachScopeDt(*_traceType, dst, [&visitor, &curScope](const auto scope, const auto dt) {
+            curScope = scope;
+            setScopeDtParentsPaths(visitor, dt);
+        });
+    };
 
-    visitor.scope(yactfr::Scope::PACKET_HEADER);
-    setScopeDtParentsPaths(visitor, _dtScopes, _traceType->packetHeaderType());
+    setDstDtParents(nullptr);
 
     for (auto& dst : _traceType->dataStreamTypes()) {
-        visitor.scope(yactfr::Scope::PACKET_CONTEXT);
-        setScopeDtParentsPaths(visitor, _dtScopes, dst->packetContextType());
-        visitor.scope(yactfr::Scope::EVENT_RECORD_HEADER);
-        setScopeDtParentsPaths(visitor, _dtScopes, dst->eventRecordHeaderType());
-        visitor.scope(yactfr::Scope::EVENT_RECORD_COMMON_CONTEXT);
-        setScopeDtParentsPaths(visitor, _dtScopes, dst->eventRecordCommonContextType());
-
-        for (auto& ert : dst->eventRecordTypes()) {
-            visitor.scope(yactfr::Scope::EVENT_RECORD_SPECIFIC_CONTEXT);
-            setScopeDtParentsPaths(visitor, _dtScopes, ert->specificContextType());
-            visitor.scope(yactfr::Scope::EVENT_RECORD_PAYLOAD);
-            setScopeDtParentsPaths(visitor, _dtScopes, ert->payloadType());
-        }
+        setDstDtParents(dst.get());
     }
 
-#if 0
-    const auto accFunc = [](const auto total, const auto& str) {
-        return total + str.size();
-    };
+    _dtPaths.resize(_dtParents.size());
+}
 
-    const auto totalSizeFunc = [accFunc](const auto& dtPathMapPair) {
-        return std::accumulate(dtPathMapPair.second.path.begin(), dtPathMapPair.second.path.end(),
-                               0ULL, accFunc) + dtPathMapPair.second.path.size() + 4;
-    };
+void Metadata::_setDtPaths(const yactfr::DataStreamType * const dst) const
+{
+    if (!_dstsWithDtPaths.insert(dst).second) {
+        // already done
+        return;
+    }
 
-    const auto maxDtPathIt = std::max_element(_dtPaths.begin(), _dtPaths.end(),
-                                              [totalSizeFunc](const auto& pairA, const auto& pairB) {
-        return totalSizeFunc(pairA) < totalSizeFunc(pairB);
+    SetDtParentsPathsVisitor visitor {nullptr, [this](const auto& dt, DtPath path) {
+        auto& dtPath = _dtPaths[_dtOrdinals.find(dt)];
+
+        if (!dtPath) {
+            dtPath = std::move(path);
+        }
+    }};
+
+    forEachScopeDt(*_traceType, dst, [&visitor](const auto scope, const auto dt) {
+        visitor.scope(scope);
+        setScopeDtParentsPaths(visitor, dt);
     });
+}
+
+DtOrdinalMap::Ordinal Metadata::_dtOrdinal(const yactfr::DataType& dt) const
+{
+    this->_ensureDtParents();
+    return _dtOrdinals.find(dt);
+}
+
+const DtPath& Metadata::dtPath(const yactfr::DataType& dt) const
+{
+    const auto ordinal = this->_dtOrdinal(dt);
+
+    assert(ordinal != DtOrdinalMap::noOrdinal);
 
-    _maxDtPathSize = maxDtPathIt == _dtPaths.end() ? 0 : totalSizeFunc(*maxDtPathIt);
-#endif
+    std::lock_guard<std::mutex> lock {_dtPathsMutex};
+
+    this->_setDtPaths(_dtDsts[ordinal]);
+    assert(_dtPaths[ordinal]);
+    return *_dtPaths[ordinal];
 }
 
-const DtPath& Metadata::dtPath(const yactfr::DataType& dt) const noexcept
+void Metadata::forEachDtPath(const yactfr::DataStreamType * const dst,
+                             const std::function<void (const DtPath&)>& func) const
 {
-    return _dtPaths.find(&dt)->second;
+    this->_ensureDtParents();
+
+    std::lock_guard<std::mutex> lock {_dtPathsMutex};
+
+    this->_setDtPaths(dst);
+
+    for (DtOrdinalMap::Ordinal ordinal = 0; ordinal < _dtPaths.size(); ++ordinal) {
+        if (_dtDsts[ordinal] == dst && _dtPaths[ordinal]) {
+            func(*_dtPaths[ordinal]);
+        }
+    }
 }
 
-const yactfr::DataType *Metadata::dtParent(const yactfr::DataType& dt) const noexcept
+const yactfr::DataType *Metadata::dtParent(const yactfr::DataType& dt) const
 {
-    const auto it = _dtParents.find(&dt);
+    const auto ordinal = this->_dtOrdinal(dt);
 
-    if (it == _dtParents.end()) {
+    if (ordinal == DtOrdinalMap::noOrdinal) {
         return nullptr;
     }
 
-    return it->second;
+    return _dtParents[ordinal];
 }
 
-yactfr::Scope Metadata::dtScope(const yactfr::DataType& dt) const noexcept
+yactfr::Scope Metadata::dtScope(const yactfr::DataType& dt) const
 {
-    auto curDt = &dt;
+    const auto ordinal = this->_dtOrdinal(dt);
 
-    while (!this->dtIsScopeRoot(*curDt)) {
-        curDt = this->dtParent(*curDt);
-        assert(curDt);
-    }
-
-    return _dtScopes.find(curDt)->second;
+    assert(ordinal != DtOrdinalMap::noOrdinal);
+    return _dtScopes[ordinal];
 }
 
-bool Metadata::dtIsScopeRoot(const yactfr::DataType& dt) const noexcept
+bool Metadata::dtIsScopeRoot(const yactfr::DataType& dt) const
 {
-    return _dtScopes.find(&dt) != _dtScopes.end();
+    const auto ordinal = this->_dtOrdinal(dt);
+
+    return ordinal != DtOrdinalMap::noOrdinal && !_dtParents[ordinal];
 }
 
 DataLen Metadata::fileLen() const noexcept
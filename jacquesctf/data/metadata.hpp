@@ -9,7 +9,10 @@
 #define _JACQUES_DATA_METADATA_HPP
 
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <functional>
+#include <vector>
+#include <unordered_set>
 #include <yactfr/yactfr.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
@@ -20,32 +23,53 @@
 #include "bo.hpp"
 #include "data-len.hpp"
 #include "dt-path.hpp"
+#include "dt-ordinal-map.hpp"
 #include "metadata-error.hpp"
 
 namespace jacques {
 
+/*
+ * Metadata of a trace.
+ *
+ * The data type parent, scope, and path maps are only built when
+ * something needs them, so that the commands which don't inspect
+ * individual data types (listing or copying packets, for example)
+ * don't pay for them. The data type paths are built per data stream
+ * type: a trace with thousands of event record types only gets the
+ * paths of the data stream types which the user actually inspects.
+ *
+ * Each data type of the trace type gets a dense ordinal (see
+ * `DtOrdinalMap`): the parent, scope, and path of a data type are
+ * elements of contiguous vectors at this ordinal.
+ *
+ * The lazy building is thread-safe.
+ */
 class Metadata final :
     boost::noncopyable
 {
 public:
-    using DtParentMap = std::unordered_map<const yactfr::DataType *, const yactfr::DataType *>;
-    using DtScopeMap = std::unordered_map<const yactfr::DataType *, yactfr::Scope>;
-    using DtPathMap = std::unordered_map<const yactfr::DataType *, DtPath>;
+    // data type paths, indexed by data type ordinal
+    using DtPaths = std::vector<boost::optional<DtPath>>;
 
 public:
     explicit Metadata(boost::filesystem::path path, yactfr::TraceType::UP traceType,
                       std::unique_ptr<const yactfr::MetadataStream> stream,
                       boost::optional<boost::uuids::uuid> streamUuid);
-    const yactfr::DataType *dtParent(const yactfr::DataType& dt) const noexcept;
-    yactfr::Scope dtScope(const yactfr::DataType& dt) const noexcept;
-    const DtPath& dtPath(const yactfr::DataType& dt) const noexcept;
-
-    const DtPathMap& dtPaths() const noexcept
-    {
-        return _dtPaths;
-    }
-
-    bool dtIsScopeRoot(const yactfr::DataType& dt) const noexcept;
+    const yactfr::DataType *dtParent(const yactfr::DataType& dt) const;
+    yactfr::Scope dtScope(const yactfr::DataType& dt) const;
+    const DtPath& dtPath(const yactfr::DataType& dt) const;
+
+    /*
+     * Calls `func` with the path of each data type of the data stream
+     * type `dst` (`nullptr`: packet header), only building the paths
+     * of this data stream type if needed.
+     *
+     * `func` must not call other methods of this metadata.
+     */
+    void forEachDtPath(const yactfr::DataStreamType *dst,
+                       const std::function<void (const DtPath&)>& func) const;
+
+    bool dtIsScopeRoot(const yactfr::DataType& dt) const;
     DataLen fileLen() const noexcept;
 
     const std::string& text() const noexcept
@@ -53,6 +77,11 @@ public:
         return _stream->text();
     }
 
+    /*
+     * Path of the file from which this metadata was parsed: other
+     * traces can share this metadata (see MetadataInternTable), so
+     * prefer Trace::metadataPath().
+     */
     const boost::filesystem::path& path() const noexcept
     {
         return _path;
@@ -80,7 +109,10 @@ public:
     }
 
 private:
-    void _setDtParents();
+    void _ensureDtParents() const;
+    void _setDtParents() const;
+    void _setDtPaths(const yactfr::DataStreamType *dst) const;
+    DtOrdinalMap::Ordinal _dtOrdinal(const yactfr::DataType& dt) const;
     void _setIsCorrelatable();
 
 private:
@@ -88,10 +120,25 @@ private:
     yactfr::TraceType::UP _traceType;
     std::unique_ptr<const yactfr::MetadataStream> _stream;
     boost::optional<boost::uuids::uuid> _streamUuid;
-    DtParentMap _dtParents;
-    DtScopeMap _dtScopes;
-    DtPathMap _dtPaths;
     bool _isCorrelatable = false;
+
+    // built once, on first use
+    mutable std::once_flag _dtParentsOnceFlag;
+    mutable DtOrdinalMap _dtOrdinals;
+
+    // indexed by data type ordinal
+    mutable std::vector<const yactfr::DataType *> _dtParents;
+    mutable std::vector<yactfr::Scope> _dtScopes;
+
+    // `nullptr`: packet header
+    mutable std::vector<const yactfr::DataStreamType *> _dtDsts;
+
+    // protects the members below
+    mutable std::mutex _dtPathsMutex;
+
+    // built per data stream type (`nullptr`: packet header), on first use
+    mutable DtPaths _dtPaths;
+    mutable std::unordered_set<const yactfr::DataStreamType *> _dstsWithDtPaths;
 };
 
 const yactfr::DataLocation *dtDataLoc(const yactfr::DataType& dt) noexcept;
@@ -21,20 +21,24 @@ PktDecodingError::PktDecodingError(const yactfr::DecodingError& decodingError,
 
 PktCheckpoints::PktCheckpoints(yactfr::ElementSequence& seq, const Metadata& metadata,
                                const PktIndexEntry& pktIndexEntry, const Size step,
+                               const Size tsIndexStep,
                                PktCheckpointsBuildListener& pktCheckpointsBuildListener)
 {
-    this->_tryCreateCheckpoints(seq, metadata, pktIndexEntry, step, pktCheckpointsBuildListener);
+    this->_tryCreateCheckpoints(seq, metadata, pktIndexEntry, step, tsIndexStep,
+                                pktCheckpointsBuildListener);
 }
 
 void PktCheckpoints::_tryCreateCheckpoints(yactfr::ElementSequence& seq, const Metadata& metadata,
                                            const PktIndexEntry& pktIndexEntry, const Size step,
+                                           const Size tsIndexStep,
                                            PktCheckpointsBuildListener& pktCheckpointsBuildListener)
 {
     auto it = seq.at(pktIndexEntry.offsetInDsFileBytes());
 
     // we consider other errors (e.g., I/O) unrecoverable: do not catch them
     try {
-        this->_createCheckpoints(it, metadata, pktIndexEntry, step, pktCheckpointsBuildListener);
+        this->_createCheckpoints(it, metadata, pktIndexEntry, step, tsIndexStep,
+                                 pktCheckpointsBuildListener);
     } catch (const yactfr::DecodingError& exc) {
         _error = PktDecodingError {exc, pktIndexEntry};
     }
@@ -93,28 +97,80 @@ void PktCheckpoints::_tryCreateCheckpoints(yactfr::ElementSequence& seq, const M
 void PktCheckpoints::_createCheckpoints(yactfr::ElementSequenceIterator& it,
                                         const Metadata& metadata,
                                         const PktIndexEntry& pktIndexEntry, const Size step,
+                                        const Size tsIndexStep,
                                         PktCheckpointsBuildListener& pktCheckpointsBuildListener)
 {
     Index indexInPkt = 0;
+    const auto withTsIndex = tsIndexStep > 0 && metadata.isCorrelatable();
+
+    /*
+     * Position of the beginning of the current event record, if we want
+     * a timestamp index entry for it, until we get its timestamp.
+     */
+    yactfr::ElementSequenceIteratorPosition tsIndexEntryPos;
+    bool hasTsIndexEntryPos = false;
 
     // create all checkpoints except (possibly) the last one
     while (it->kind() != yactfr::Element::Kind::PACKET_END) {
-        if (it->kind() == yactfr::Element::Kind::EVENT_RECORD_BEGINNING) {
+        switch (it->kind()) {
+        case yactfr::Element::Kind::EVENT_RECORD_BEGINNING:
+        {
             const auto curIndexInPkt = indexInPkt;
 
             ++indexInPkt;
 
             if (curIndexInPkt % step == 0) {
+                // this also adds a timestamp index entry
                 this->_createCheckpoint(it, metadata, pktIndexEntry, curIndexInPkt,
                                         pktCheckpointsBuildListener);
                 continue;
             }
+
+            if (withTsIndex && curIndexInPkt % tsIndexStep == 0) {
+                it.savePosition(tsIndexEntryPos);
+                hasTsIndexEntryPos = true;
+            }
+
+            break;
+        }
+
+        case yactfr::Element::Kind::DEFAULT_CLOCK_VALUE:
+            if (hasTsIndexEntryPos) {
+                assert(pktIndexEntry.dst());
+                assert(pktIndexEntry.dst()->defaultClockType());
+                this->_tryAddTsIndexEntry(Ts {
+                    it->asDefaultClockValueElement().cycles(),
+                    *pktIndexEntry.dst()->defaultClockType()
+                }, indexInPkt - 1, std::move(tsIndexEntryPos));
+                hasTsIndexEntryPos = false;
+            }
+
+            break;
+
+        case yactfr::Element::Kind::EVENT_RECORD_END:
+            // no timestamp for this event record
+            hasTsIndexEntryPos = false;
+            break;
+
+        default:
+            break;
         }
 
         ++it;
     }
 }
 
+void PktCheckpoints::_tryAddTsIndexEntry(const Ts& ts, const Index indexInPkt,
+                                         yactfr::ElementSequenceIteratorPosition&& pos)
+{
+    if (!_tsIndex.empty() && _tsIndex.back().indexInPkt >= indexInPkt) {
+        // already indexed (last event record checkpoint)
+        return;
+    }
+
+    _tsIndex.push_back({ts.cycles(), ts.nsFromOrigin(), indexInPkt, std::move(pos)});
+}
+
 void PktCheckpoints::_lastErPositions(yactfr::ElementSequenceIteratorPosition& lastPos,
                                       yactfr::ElementSequenceIteratorPosition& penultimatePos,
                                       Index& lastIndexInPkt, Index& penultimateIndexInPkt,
@@ -154,6 +210,12 @@ void PktCheckpoints::_createCheckpoint(yactfr::ElementSequenceIterator& it,
     it.savePosition(pos);
 
     const auto er = Er::createFromElemSeqIt(it, metadata, pktIndexEntry, indexInPkt);
+
+    if (er->ts()) {
+        this->_tryAddTsIndexEntry(*er->ts(), indexInPkt,
+                                  yactfr::ElementSequenceIteratorPosition {pos});
+    }
+
     _checkpoints.push_back({er, std::move(pos)});
     pktCheckpointsBuildListener.update(*er);
 }
@@ -391,4 +453,18 @@ const PktCheckpoints::Checkpoint *PktCheckpoints::nearestCheckpointAfterCycles(c
     return checkpoint;
 }
 
+const PktCheckpoints::TsIndexEntry *PktCheckpoints::nearestTsIndexEntryBeforeOrAtNsFromOrigin(const long long nsFromOrigin) const noexcept
+{
+    return this->_nearestTsIndexEntryBeforeOrAt(nsFromOrigin, [](const TsIndexEntry& entry) {
+        return entry.nsFromOrigin;
+    });
+}
+
+const PktCheckpoints::TsIndexEntry *PktCheckpoints::nearestTsIndexEntryBeforeOrAtCycles(const unsigned long long cycles) const noexcept
+{
+    return this->_nearestTsIndexEntryBeforeOrAt(cycles, [](const TsIndexEntry& entry) {
+        return entry.cycles;
+    });
+}
+
 } // namespace jacques
@@ -52,9 +52,36 @@ public:
     using Checkpoint = std::pair<Er::SP, yactfr::ElementSequenceIteratorPosition>;
     using Checkpoints = std::vector<Checkpoint>;
 
+    /*
+     * Timestamp index entry: timestamp and position of the beginning of
+     * an event record.
+     *
+     * Contrary to a checkpoint, this doesn't hold an event record
+     * object, but an iterator position still holds a copy of the state
+     * of the decoder (a few hundred bytes, more with deeply nested data
+     * types). With one entry every N event records, the timestamp index
+     * costs about that divided by N per event record: choose N so that
+     * this remains small compared to the event records themselves.
+     */
+    struct TsIndexEntry
+    {
+        unsigned long long cycles;
+        long long nsFromOrigin;
+        Index indexInPkt;
+        yactfr::ElementSequenceIteratorPosition pos;
+    };
+
+    using TsIndex = std::vector<TsIndexEntry>;
+
 public:
+    /*
+     * Builds packet checkpoints, creating one checkpoint every `step`
+     * event records and, if the metadata is correlatable, one timestamp
+     * index entry every `tsIndexStep` event records (0 means no
+     * timestamp index entries besides the checkpoints).
+     */
     explicit PktCheckpoints(yactfr::ElementSequence& seq, const Metadata& metadata,
-                            const PktIndexEntry& pktIndexEntry, Size step,
+                            const PktIndexEntry& pktIndexEntry, Size step, Size tsIndexStep,
                             PktCheckpointsBuildListener& pktCheckpointsBuildListener);
 
     const Checkpoint *nearestCheckpointBeforeOrAtIndex(Index indexInPkt) const noexcept;
@@ -69,6 +96,8 @@ public:
     const Checkpoint *nearestCheckpointBeforeOrAtCycles(unsigned long long cycles) const noexcept;
     const Checkpoint *nearestCheckpointBeforeCycles(unsigned long long cycles) const noexcept;
     const Checkpoint *nearestCheckpointAfterCycles(unsigned long long cycles) const noexcept;
+    const TsIndexEntry *nearestTsIndexEntryBeforeOrAtNsFromOrigin(long long nsFromOrigin) const noexcept;
+    const TsIndexEntry *nearestTsIndexEntryBeforeOrAtCycles(unsigned long long cycles) const noexcept;
 
     Er::SP nearestErBeforeOrAtIndex(const Index indexInPkt) const noexcept
     {
@@ -260,19 +289,27 @@ public:
         return _error;
     }
 
+    const TsIndex& tsIndex() const noexcept
+    {
+        return _tsIndex;
+    }
+
 private:
     void _createCheckpoint(yactfr::ElementSequenceIterator& it, const Metadata& metadata,
                            const PktIndexEntry& pktIndexEntry, Index indexInPkt,
                            PktCheckpointsBuildListener& pktCheckpointsBuildListener);
 
     void _createCheckpoints(yactfr::ElementSequenceIterator& it, const Metadata& metadata,
-                            const PktIndexEntry& pktIndexEntry, Size step,
+                            const PktIndexEntry& pktIndexEntry, Size step, Size tsIndexStep,
                             PktCheckpointsBuildListener& pktCheckpointsBuildListener);
 
     void _tryCreateCheckpoints(yactfr::ElementSequence& seq, const Metadata& metadata,
-                               const PktIndexEntry& pktIndexEntry, Size step,
+                               const PktIndexEntry& pktIndexEntry, Size step, Size tsIndexStep,
                                PktCheckpointsBuildListener& pktCheckpointsBuildListener);
 
+    void _tryAddTsIndexEntry(const Ts& ts, Index indexInPkt,
+                             yactfr::ElementSequenceIteratorPosition&& pos);
+
     void _lastErPositions(yactfr::ElementSequenceIteratorPosition& lastPos,
                           yactfr::ElementSequenceIteratorPosition& penultimatePos,
                           Index& lastIndexInPkt, Index& penultimateIndexInPkt,
@@ -366,8 +403,78 @@ private:
         return &(*it);
     }
 
+    /*
+     * Returns the first timestamp index entry of which the property
+     * (given by `getPropFunc`) is equal to `prop`, or the last one of
+     * which the property is less than `prop`, or `nullptr` if there's
+     * none.
+     *
+     * This is an interpolation search: event record timestamps within
+     * a packet are usually evenly distributed enough for this to find
+     * the entry in a few probes. It alternates with a bisection step so
+     * that the worst case remains O(log n).
+     */
+    template <typename PropT, typename GetPropFuncT>
+    const TsIndexEntry *_nearestTsIndexEntryBeforeOrAt(const PropT prop,
+                                                       GetPropFuncT&& getPropFunc) const noexcept
+    {
+        if (_tsIndex.empty()) {
+            return nullptr;
+        }
+
+        if (getPropFunc(_tsIndex.back()) < prop) {
+            return &_tsIndex.back();
+        }
+
+        if (prop <= getPropFunc(_tsIndex.front())) {
+            if (getPropFunc(_tsIndex.front()) == prop) {
+                return &_tsIndex.front();
+            }
+
+            // nothing before
+            return nullptr;
+        }
+
+        // invariant: property at `low` < `prop` <= property at `high`
+        Index low = 0;
+        Index high = _tsIndex.size() - 1;
+        bool interpolate = true;
+
+        while (high - low > 1) {
+            Index probe;
+
+            if (interpolate) {
+                const auto lowProp = static_cast<long double>(getPropFunc(_tsIndex[low]));
+                const auto highProp = static_cast<long double>(getPropFunc(_tsIndex[high]));
+                const auto ratio = (static_cast<long double>(prop) - lowProp) /
+                                   (highProp - lowProp);
+
+                probe = low + static_cast<Index>(ratio * static_cast<long double>(high - low));
+                probe = std::max(probe, low + 1);
+                probe = std::min(probe, high - 1);
+            } else {
+                probe = low + (high - low) / 2;
+            }
+
+            interpolate = !interpolate;
+
+            if (getPropFunc(_tsIndex[probe]) < prop) {
+                low = probe;
+            } else {
+                high = probe;
+            }
+        }
+
+        if (getPropFunc(_tsIndex[high]) == prop) {
+            return &_tsIndex[high];
+        }
+
+        return &_tsIndex[low];
+    }
+
 private:
     Checkpoints _checkpoints;
+    TsIndex _tsIndex;
     boost::optional<PktDecodingError> _error;
     boost::optional<Index> _pktCtxOffsetInPktBits;
 };
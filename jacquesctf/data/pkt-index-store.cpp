@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <boost/filesystem.hpp>
+
+#include "pkt-index-store.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+namespace {
+
+constexpr std::uint32_t noDst = ~0U;
+
+constexpr std::uint32_t flagHasPktCtxOffsetInPktBits = 1 << 0;
+constexpr std::uint32_t flagHasPreambleLen = 1 << 1;
+constexpr std::uint32_t flagHasExpectedTotalLen = 1 << 2;
+constexpr std::uint32_t flagHasExpectedContentLen = 1 << 3;
+constexpr std::uint32_t flagHasDsId = 1 << 4;
+constexpr std::uint32_t flagHasBeginTs = 1 << 5;
+constexpr std::uint32_t flagHasEndTs = 1 << 6;
+constexpr std::uint32_t flagHasSeqNum = 1 << 7;
+constexpr std::uint32_t flagHasDiscErCounterSnap = 1 << 8;
+constexpr std::uint32_t flagIsInvalid = 1 << 9;
+
+// records to accumulate before writing them to the file
+constexpr Size flushRecordCount = 4096;
+
+// sets `path` to the path of the created temporary file
+int createTmpFile(boost::filesystem::path& path)
+{
+    boost::system::error_code ec;
+    const auto dirPath = boost::filesystem::temp_directory_path(ec);
+
+    if (ec) {
+        return -1;
+    }
+
+    auto pathStr = (dirPath / "jacques-pkt-index-XXXXXX").string();
+    const auto fd = mkstemp(&pathStr[0]);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    // only this process needs it: gone on close
+    static_cast<void>(unlink(pathStr.c_str()));
+    path = pathStr;
+    return fd;
+}
+
+template <typename ValT>
+std::uint64_t recordVal(const boost::optional<ValT>& val, const std::uint32_t flag,
+                        std::uint32_t& flags) noexcept
+{
+    if (!val) {
+        return 0;
+    }
+
+    flags |= flag;
+    return static_cast<std::uint64_t>(*val);
+}
+
+std::uint64_t recordVal(const boost::optional<DataLen>& len, const std::uint32_t flag,
+                        std::uint32_t& flags) noexcept
+{
+    if (!len) {
+        return 0;
+    }
+
+    flags |= flag;
+    return len->bits();
+}
+
+std::uint64_t recordVal(const boost::optional<Ts>& ts, const std::uint32_t flag,
+                        std::uint32_t& flags) noexcept
+{
+    if (!ts) {
+        return 0;
+    }
+
+    flags |= flag;
+    return ts->cycles();
+}
+
+template <typename ValT>
+boost::optional<ValT> optVal(const std::uint64_t val, const std::uint32_t flag,
+                             const std::uint32_t flags) noexcept
+{
+    if (!(flags & flag)) {
+        return boost::none;
+    }
+
+    return static_cast<ValT>(val);
+}
+
+boost::optional<DataLen> optLen(const std::uint64_t bits, const std::uint32_t flag,
+                                const std::uint32_t flags) noexcept
+{
+    if (!(flags & flag)) {
+        return boost::none;
+    }
+
+    return DataLen {bits};
+}
+
+boost::optional<Ts> optTs(const std::uint64_t cycles, const std::uint32_t flag,
+                          const std::uint32_t flags,
+                          const yactfr::DataStreamType * const dst) noexcept
+{
+    if (!(flags & flag)) {
+        return boost::none;
+    }
+
+    // the index builder only creates timestamps with a default clock
+    assert(dst);
+    assert(dst->defaultClockType());
+    return Ts {cycles, *dst->defaultClockType()};
+}
+
+} // namespace
+
+PktIndexStore::PktIndexStore() :
+    _fd {createTmpFile(_tmpFilePath)}
+{
+}
+
+PktIndexStore::~PktIndexStore()
+{
+    if (_mappingAddr) {
+        static_cast<void>(munmap(_mappingAddr, static_cast<size_t>(_mappingLenBytes)));
+    }
+
+    if (_fd >= 0) {
+        static_cast<void>(close(_fd));
+    }
+}
+
+void PktIndexStore::append(const PktIndexEntry& entry)
+{
+    assert(!_mappedRecords);
+    assert(entry.indexInDsFile() == _size);
+
+    _Record record;
+    std::uint32_t flags = 0;
+
+    record.offsetInDsFileBytes = entry.offsetInDsFileBytes();
+    record.pktCtxOffsetInPktBits = recordVal(entry.pktCtxOffsetInPktBits(),
+                                             flagHasPktCtxOffsetInPktBits, flags);
+    record.preambleLenBits = recordVal(entry.preambleLen(), flagHasPreambleLen, flags);
+    record.expectedTotalLenBits = recordVal(entry.expectedTotalLen(), flagHasExpectedTotalLen,
+                                            flags);
+    record.expectedContentLenBits = recordVal(entry.expectedContentLen(),
+                                              flagHasExpectedContentLen, flags);
+    record.effectiveTotalLenBits = entry.effectiveTotalLen().bits();
+    record.effectiveContentLenBits = entry.effectiveContentLen().bits();
+    record.dsId = recordVal(entry.dsId(), flagHasDsId, flags);
+    record.beginTsCycles = recordVal(entry.beginTs(), flagHasBeginTs, flags);
+    record.endTsCycles = recordVal(entry.endTs(), flagHasEndTs, flags);
+    record.seqNum = recordVal(entry.seqNum(), flagHasSeqNum, flags);
+    record.discErCounterSnap = recordVal(entry.discErCounterSnap(), flagHasDiscErCounterSnap,
+                                         flags);
+
+    if (entry.isInvalid()) {
+        flags |= flagIsInvalid;
+    }
+
+    record.flags = flags;
+
+    if (entry.dst()) {
+        // few data stream types per file: linear search is fine
+        const auto it = std::find(_dsts.begin(), _dsts.end(), entry.dst());
+
+        record.dstIndex = static_cast<std::uint32_t>(it - _dsts.begin());
+
+        if (it == _dsts.end()) {
+            _dsts.push_back(entry.dst());
+        }
+    } else {
+        record.dstIndex = noDst;
+    }
+
+    _records.push_back(record);
+    ++_size;
+
+    if (_fd >= 0 && _records.size() == flushRecordCount) {
+        this->_flush();
+    }
+}
+
+void PktIndexStore::_flush()
+{
+    assert(_fd >= 0);
+
+    const auto buf = reinterpret_cast<const char *>(_records.data());
+    const auto lenBytes = _records.size() * sizeof(_Record);
+    Size doneLenBytes = 0;
+
+    while (doneLenBytes < lenBytes) {
+        const auto ret = write(_fd, buf + doneLenBytes, lenBytes - doneLenBytes);
+
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (ret <= 0) {
+            /*
+             * Full or broken temporary file system: keep everything in
+             * memory instead.
+             */
+            std::vector<_Record> records(_size - _records.size());
+
+            if (!records.empty()) {
+                const auto readRet = pread(_fd, records.data(), records.size() * sizeof(_Record),
+                                           0);
+
+                if (readRet < 0) {
+                    throw IOError {
+                        _tmpFilePath,
+                        std::string {"Cannot read file: "} + std::strerror(errno)
+                    };
+                }
+
+                if (static_cast<Size>(readRet) != records.size() * sizeof(_Record)) {
+                    throw IOError {_tmpFilePath, "Unexpected end of file."};
+                }
+            }
+
+            records.insert(records.end(), _records.begin(), _records.end());
+            _records = std::move(records);
+            static_cast<void>(close(_fd));
+            _fd = -1;
+            return;
+        }
+
+        doneLenBytes += static_cast<Size>(ret);
+    }
+
+    _records.clear();
+}
+
+void PktIndexStore::seal()
+{
+    assert(!_mappedRecords);
+
+    if (_fd >= 0) {
+        this->_flush();
+    }
+
+    if (_fd < 0 || _size == 0) {
+        _mappedRecords = _records.data();
+        return;
+    }
+
+    _mappingLenBytes = _size * sizeof(_Record);
+    _mappingAddr = mmap(NULL, static_cast<size_t>(_mappingLenBytes), PROT_READ, MAP_SHARED, _fd,
+                        0);
+
+    if (_mappingAddr == MAP_FAILED) {
+        _mappingAddr = nullptr;
+        throw IOError {_tmpFilePath, std::string {"Cannot map file: "} + std::strerror(errno)};
+    }
+
+    _mappedRecords = static_cast<const _Record *>(_mappingAddr);
+}
+
+PktIndexEntry PktIndexStore::entry(const Index index) const
+{
+    assert(_mappedRecords);
+    assert(index < _size);
+
+    const auto& record = _mappedRecords[index];
+    const auto flags = record.flags;
+    const auto dst = record.dstIndex == noDst ? nullptr : _dsts[record.dstIndex];
+
+    return PktIndexEntry {
+        index, record.offsetInDsFileBytes,
+        optVal<Index>(record.pktCtxOffsetInPktBits, flagHasPktCtxOffsetInPktBits, flags),
+        optLen(record.preambleLenBits, flagHasPreambleLen, flags),
+        optLen(record.expectedTotalLenBits, flagHasExpectedTotalLen, flags),
+        optLen(record.expectedContentLenBits, flagHasExpectedContentLen, flags),
+        DataLen {record.effectiveTotalLenBits}, DataLen {record.effectiveContentLenBits},
+        dst, optVal<Index>(record.dsId, flagHasDsId, flags),
+        optTs(record.beginTsCycles, flagHasBeginTs, flags, dst),
+        optTs(record.endTsCycles, flagHasEndTs, flags, dst),
+        optVal<Index>(record.seqNum, flagHasSeqNum, flags),
+        optVal<Size>(record.discErCounterSnap, flagHasDiscErCounterSnap, flags),
+        (flags & flagIsInvalid) != 0,
+    };
+}
+
+} // namespace jacques
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_PKT_INDEX_STORE_HPP
+#define _JACQUES_DATA_PKT_INDEX_STORE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+#include "pkt-index-entry.hpp"
+
+namespace jacques {
+
+/*
+ * File-backed packet index store.
+ *
+ * A packet index store keeps the packet index entries of a data stream
+ * file as compact fixed-size records in an unlinked temporary file:
+ * you append() entries while building the index, and then seal() the
+ * store, which memory-maps the file. The kernel only pages in the
+ * records which entry() decodes, and can write back and evict them
+ * like any file page, so that a data stream file with millions of
+ * packets doesn't need its whole index in memory.
+ *
+ * If there's no usable temporary directory, the records remain in
+ * memory (still more compact than packet index entries).
+ *
+ * Once the store is sealed, entry() is thread-safe.
+ *
+ * append() and seal() throw `IOError` if they can't read back or map
+ * the temporary file.
+ */
+class PktIndexStore final :
+    boost::noncopyable
+{
+public:
+    explicit PktIndexStore();
+    ~PktIndexStore();
+
+    // appends the entry `entry`, of which the index must be size()
+    void append(const PktIndexEntry& entry);
+
+    // makes the appended entries available to entry()
+    void seal();
+
+    // decodes the entry at index `index`
+    PktIndexEntry entry(Index index) const;
+
+    Size size() const noexcept
+    {
+        return _size;
+    }
+
+private:
+    // a packet index entry in the store
+    struct _Record
+    {
+        std::uint64_t offsetInDsFileBytes;
+        std::uint64_t pktCtxOffsetInPktBits;
+        std::uint64_t preambleLenBits;
+        std::uint64_t expectedTotalLenBits;
+        std::uint64_t expectedContentLenBits;
+        std::uint64_t effectiveTotalLenBits;
+        std::uint64_t effectiveContentLenBits;
+        std::uint64_t dsId;
+        std::uint64_t beginTsCycles;
+        std::uint64_t endTsCycles;
+        std::uint64_t seqNum;
+        std::uint64_t discErCounterSnap;
+
+        // index within `_dsts`, or `noDst`
+        std::uint32_t dstIndex;
+
+        // `_flag*`
+        std::uint32_t flags;
+    };
+
+private:
+    void _flush();
+
+private:
+    Size _size = 0;
+
+    /*
+     * Path of the temporary file, for error messages only (the file is
+     * already unlinked).
+     *
+     * Declared before `_fd`, which the constructor initializes from it.
+     */
+    boost::filesystem::path _tmpFilePath;
+
+    // temporary file, or -1 to keep the records in `_records`
+    int _fd = -1;
+
+    // records not written yet, or all of them without a file
+    std::vector<_Record> _records;
+
+    const _Record *_mappedRecords = nullptr;
+    void *_mappingAddr = nullptr;
+    Size _mappingLenBytes = 0;
+
+    // data stream types of the entries
+    std::vector<const yactfr::DataStreamType *> _dsts;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_PKT_INDEX_STORE_HPP
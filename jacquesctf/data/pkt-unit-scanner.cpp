@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "pkt-unit-scanner.hpp"
+
+namespace jacques {
+
+yactfr::ElementSequenceIterator& PktUnitScanner::WorkerIt::seekPkt(const DsFile& dsFile,
+                                                                   const PktIndexEntry& pktIndexEntry)
+{
+    if (_dsFile != &dsFile) {
+        /*
+         * A worker scans whole units: use our own element sequence,
+         * with a sequential scan data source factory, rather than the
+         * one of the packets of the data stream file.
+         */
+        _it = boost::none;
+        _seq = nullptr;
+        _factory = dsFile.createSeqScanDataSrcFactory();
+        _seq = std::make_unique<yactfr::ElementSequence>(dsFile.metadata().traceType(),
+                                                         *_factory);
+        _dsFile = &dsFile;
+    }
+
+    if (_it) {
+        _it->seekPacket(pktIndexEntry.offsetInDsFileBytes());
+    } else {
+        _it = _seq->at(pktIndexEntry.offsetInDsFileBytes());
+    }
+
+    return *_it;
+}
+
+PktUnitScanner::PktUnitScanner(const std::vector<const DsFile *>& dsFiles,
+                               const DataLen minUnitLen, const DsFileFilterFunc& filterFunc) :
+    _dsFiles {&dsFiles}
+{
+    this->_createUnits(minUnitLen, filterFunc);
+}
+
+PktUnitScanner::~PktUnitScanner()
+{
+    this->cancel();
+    this->join();
+}
+
+void PktUnitScanner::_createUnits(const DataLen minUnitLen, const DsFileFilterFunc& filterFunc)
+{
+    for (Index dsFileIndex = 0; dsFileIndex < _dsFiles->size(); ++dsFileIndex) {
+        const auto& dsFile = *(*_dsFiles)[dsFileIndex];
+
+        if (filterFunc && !filterFunc(dsFileIndex)) {
+            continue;
+        }
+
+        Index beginPktIndex = 0;
+        DataLen unitLen;
+
+        for (Index pktIndex = 0; pktIndex < dsFile.pktCount(); ++pktIndex) {
+            unitLen += dsFile.decodedPktIndexEntry(pktIndex).effectiveTotalLen();
+
+            if (unitLen >= minUnitLen || pktIndex == dsFile.pktCount() - 1) {
+                _units.push_back({dsFileIndex, beginPktIndex, pktIndex + 1});
+                beginPktIndex = pktIndex + 1;
+                unitLen = 0;
+            }
+        }
+
+        _pktCount += dsFile.pktCount();
+    }
+}
+
+Size PktUnitScanner::workerCount(Size threadCount) const noexcept
+{
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    return std::min(threadCount, static_cast<Size>(_units.size()));
+}
+
+void PktUnitScanner::start(const Size threadCount, UnitFunc unitFunc)
+{
+    assert(_threads.empty());
+    _unitFunc = std::move(unitFunc);
+
+    const auto workerCount = this->workerCount(threadCount);
+
+    for (Index workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+        _threads.emplace_back([this, workerIndex] {
+            this->_work(workerIndex);
+        });
+    }
+}
+
+void PktUnitScanner::join()
+{
+    for (auto& thread : _threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void PktUnitScanner::_work(const Index workerIndex)
+{
+    WorkerIt it;
+
+    while (!_isCanceled) {
+        const auto unitIndex = _nextUnit++;
+
+        if (unitIndex >= _units.size()) {
+            break;
+        }
+
+        try {
+            _unitFunc(unitIndex, workerIndex, it);
+        } catch (...) {
+            // keep the first error and stop
+            {
+                std::lock_guard<std::mutex> lock {_excMutex};
+
+                if (!_exc) {
+                    _exc = std::current_exception();
+                }
+            }
+
+            this->cancel();
+        }
+    }
+}
+
+void PktUnitScanner::rethrowError() const
+{
+    std::lock_guard<std::mutex> lock {_excMutex};
+
+    if (_exc) {
+        std::rethrow_exception(_exc);
+    }
+}
+
+} // namespace jacques
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_PKT_UNIT_SCANNER_HPP
+#define _JACQUES_DATA_PKT_UNIT_SCANNER_HPP
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <functional>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+#include "ds-file.hpp"
+#include "data-len.hpp"
+#include "pkt-index-entry.hpp"
+
+namespace jacques {
+
+/*
+ * Packet unit scanner.
+ *
+ * A packet unit scanner splits the packets of data stream files into
+ * units of a few consecutive packets of the same data stream file, and
+ * runs worker threads which call a user function for each unit, in
+ * order of unit index, each unit being scanned by a single worker.
+ *
+ * A worker doesn't create any packet or event record object: the user
+ * function streams the elements of the packets of its unit with the
+ * worker's own element sequence iterator (see WorkerIt), so that it
+ * never touches the state of the data stream files which other threads
+ * use.
+ *
+ * The data stream files must have a built index and must outlive the
+ * scanner.
+ */
+class PktUnitScanner final :
+    boost::noncopyable
+{
+public:
+    struct Unit
+    {
+        Index dsFileIndex;
+        Index beginPktIndex;
+        Index endPktIndex;
+    };
+
+    /*
+     * Element sequence iterator of a worker.
+     *
+     * A worker iterator only creates a data source when the unit to
+     * scan changes data stream file, and seeks its iterator from one
+     * packet to the other: scanning a unit doesn't create a data source
+     * per packet.
+     */
+    class WorkerIt final :
+        boost::noncopyable
+    {
+    public:
+        WorkerIt() = default;
+
+        /*
+         * Returns an element sequence iterator located at the
+         * beginning of the packet `pktIndexEntry` of `dsFile`.
+         *
+         * The returned iterator remains valid until the next call.
+         */
+        yactfr::ElementSequenceIterator& seekPkt(const DsFile& dsFile,
+                                                 const PktIndexEntry& pktIndexEntry);
+
+    private:
+        std::unique_ptr<yactfr::DataSourceFactory> _factory;
+        std::unique_ptr<yactfr::ElementSequence> _seq;
+        boost::optional<yactfr::ElementSequenceIterator> _it;
+        const DsFile *_dsFile = nullptr;
+    };
+
+    /*
+     * Scans the unit at index `unitIndex` with the worker iterator
+     * `it` of the worker `workerIndex`.
+     *
+     * Called from a worker thread. If it throws, the scanner keeps the
+     * first exception (see rethrowError()) and cancels the scan.
+     */
+    using UnitFunc = std::function<void (Index unitIndex, Index workerIndex, WorkerIt& it)>;
+
+    // whether or not the data stream file at index `dsFileIndex` needs scanning
+    using DsFileFilterFunc = std::function<bool (Index dsFileIndex)>;
+
+public:
+    /*
+     * Builds a packet unit scanner for `dsFiles` of which the units
+     * total at least `minUnitLen`, except the last one of each data
+     * stream file, ignoring the data stream files which `filterFunc`
+     * (if set) rejects.
+     *
+     * A smaller unit makes the first results come up more quickly and
+     * the work spread more evenly; a larger unit amortizes the
+     * publication of its results.
+     */
+    explicit PktUnitScanner(const std::vector<const DsFile *>& dsFiles, DataLen minUnitLen,
+                            const DsFileFilterFunc& filterFunc = {});
+
+    // cancels the scan and waits for the worker threads
+    ~PktUnitScanner();
+
+    /*
+     * Number of worker threads which start() with `threadCount` (0
+     * means the number of hardware threads) would start.
+     */
+    Size workerCount(Size threadCount) const noexcept;
+
+    /*
+     * Starts scanning the units with workerCount(`threadCount`) worker
+     * threads, calling `unitFunc` for each unit.
+     *
+     * You may only call this once.
+     */
+    void start(Size threadCount, UnitFunc unitFunc);
+
+    // waits for the worker threads
+    void join();
+
+    // start() followed by join() and rethrowError()
+    void run(const Size threadCount, UnitFunc unitFunc)
+    {
+        this->start(threadCount, std::move(unitFunc));
+        this->join();
+        this->rethrowError();
+    }
+
+    /*
+     * Rethrows the first exception which the user function threw, if
+     * any: the scan is canceled in that case.
+     */
+    void rethrowError() const;
+
+    /*
+     * Makes the workers stop picking units: a user function which
+     * takes long should also check isCanceled().
+     */
+    void cancel() noexcept
+    {
+        _isCanceled = true;
+    }
+
+    bool isCanceled() const noexcept
+    {
+        return _isCanceled;
+    }
+
+    const std::vector<Unit>& units() const noexcept
+    {
+        return _units;
+    }
+
+    const DsFile& dsFile(const Unit& unit) const noexcept
+    {
+        return *(*_dsFiles)[unit.dsFileIndex];
+    }
+
+    // total number of packets of the units
+    Size pktCount() const noexcept
+    {
+        return _pktCount;
+    }
+
+private:
+    void _createUnits(DataLen minUnitLen, const DsFileFilterFunc& filterFunc);
+    void _work(Index workerIndex);
+
+private:
+    const std::vector<const DsFile *> *_dsFiles;
+    std::vector<Unit> _units;
+    Size _pktCount = 0;
+    UnitFunc _unitFunc;
+    std::atomic<Index> _nextUnit {0};
+    std::atomic_bool _isCanceled {false};
+    std::vector<std::thread> _threads;
+
+    // protects `_exc`
+    mutable std::mutex _excMutex;
+
+    std::exception_ptr _exc;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_PKT_UNIT_SCANNER_HPP
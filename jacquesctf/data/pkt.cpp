@@ -16,23 +16,27 @@
 namespace jacques {
 
 Pkt::Pkt(const PktIndexEntry& indexEntry, yactfr::ElementSequence& seq, const Metadata& metadata,
-         yactfr::DataSource::UP dataSrc, std::unique_ptr<MemMappedFile> mmapFile,
+         MemMappedFile::Window dataWindow,
          PktCheckpointsBuildListener& pktCheckpointsBuildListener) :
     _indexEntry {&indexEntry},
     _metadata {&metadata},
-    _dataSrc {std::move(dataSrc)},
-    _mmapFile {std::move(mmapFile)},
+    _dataWindow {std::move(dataWindow)},
     _it {seq.begin()},
     _endIt {seq.end()},
+    /*
+     * One timestamp index entry every 128 event records: a timestamp
+     * seek decodes at most 127 event records from one, and the index
+     * costs a few bytes per event record (see
+     * PktCheckpoints::TsIndexEntry).
+     */
     _checkpoints {
-        seq, metadata, *_indexEntry, 3779, pktCheckpointsBuildListener,
+        seq, metadata, *_indexEntry, 3779, 128, pktCheckpointsBuildListener,
     },
     _lruRegionCache {2000},
     _preambleLen {
         indexEntry.preambleLen() ? *indexEntry.preambleLen() : indexEntry.effectiveContentLen()
     }
 {
-    _mmapFile->map(_indexEntry->offsetInDsFileBytes(), _indexEntry->effectiveTotalLen());
     this->_cachePreambleRegions();
 }
 
@@ -246,8 +250,8 @@ void Pkt::_cacheContentRegionAtCurIt(Scope::SP scope)
 #pragma GCC diagnostic pop
 
         const auto offsetStartBits = this->_itOffsetInPktBits();
-        const auto bufStart = _mmapFile->addr() + this->_itOffsetInPktBytes();
-        auto bufEnd = bufStart;
+        const auto offsetStartBytes = this->_itOffsetInPktBytes();
+        Size lenBytes = 0;
 
         ++_it;
 
@@ -257,10 +261,14 @@ void Pkt::_cacheContentRegionAtCurIt(Scope::SP scope)
             assert(_it->isRawDataElement());
 
             // "consume" this substring
-            bufEnd += _it->asRawDataElement().size();
+            lenBytes += _it->asRawDataElement().size();
             ++_it;
         }
 
+        // only map the string once we know its length
+        const auto bufStart = lenBytes == 0 ? nullptr : this->data(offsetStartBytes, lenBytes);
+        const auto bufEnd = bufStart + lenBytes;
+
         auto str = [&dt, &bufStart, &bufEnd] {
             if (dt.isStringType() &&
                     dt.asStringType().encoding() == yactfr::StringEncoding::UTF_8) {
@@ -284,7 +292,7 @@ void Pkt::_cacheContentRegionAtCurIt(Scope::SP scope)
 
         const PktSegment segment {
             offsetStartBits,
-            DataLen::fromBytes(bufEnd - bufStart)
+            DataLen::fromBytes(lenBytes)
         };
 
         region = std::make_shared<ContentPktRegion>(segment, std::move(scope), dt,
@@ -312,15 +320,14 @@ void Pkt::_cacheContentRegionAtCurIt(Scope::SP scope)
 #pragma GCC diagnostic pop
 
         const auto offsetStartBits = this->_itOffsetInPktBits();
-        const auto bufStart = _mmapFile->addr() + this->_itOffsetInPktBytes();
-        auto bufEnd = bufStart;
+        Size lenBytes = 0;
 
         ++_it;
 
         while (!_it->isStaticLengthBlobEndElement() && !_it->isDynamicLengthBlobEndElement()) {
             if (_it->isRawDataElement()) {
                 // "consume" this BLOB section
-                bufEnd += _it->asRawDataElement().size();
+                lenBytes += _it->asRawDataElement().size();
             }
 
             ++_it;
@@ -328,7 +335,7 @@ void Pkt::_cacheContentRegionAtCurIt(Scope::SP scope)
 
         const PktSegment segment {
             offsetStartBits,
-            DataLen::fromBytes(bufEnd - bufStart)
+            DataLen::fromBytes(lenBytes)
         };
 
         region = std::make_shared<ContentPktRegion>(segment, std::move(scope), dt,
@@ -788,28 +795,28 @@ const PktRegion *Pkt::previousRegion(const PktRegion& region)
 
 const Er *Pkt::erBeforeOrAtNsFromOrigin(const long long nsFromOrigin)
 {
-    const auto cpNearestFunc = [this](const long long nsFromOrigin) -> const PktCheckpoints::Checkpoint * {
-        return _checkpoints.nearestCheckpointBeforeOrAtNsFromOrigin(nsFromOrigin);
+    const auto tsIndexEntryNearestFunc = [this](const long long nsFromOrigin) {
+        return _checkpoints.nearestTsIndexEntryBeforeOrAtNsFromOrigin(nsFromOrigin);
     };
 
     const auto getPropFunc = [](const Ts& ts) -> long long {
         return ts.nsFromOrigin();
     };
 
-    return this->_erBeforeOrAtTs(cpNearestFunc, getPropFunc, nsFromOrigin);
+    return this->_erBeforeOrAtTs(tsIndexEntryNearestFunc, getPropFunc, nsFromOrigin);
 }
 
 const Er *Pkt::erBeforeOrAtCycles(const unsigned long long cycles)
 {
-    const auto cpNearestFunc = [this](const unsigned long long cycles) -> const PktCheckpoints::Checkpoint * {
-        return _checkpoints.nearestCheckpointBeforeOrAtCycles(cycles);
+    const auto tsIndexEntryNearestFunc = [this](const unsigned long long cycles) {
+        return _checkpoints.nearestTsIndexEntryBeforeOrAtCycles(cycles);
     };
 
     const auto getPropFunc = [](const Ts& ts) -> unsigned long long {
         return ts.cycles();
     };
 
-    return this->_erBeforeOrAtTs(cpNearestFunc, getPropFunc, cycles);
+    return this->_erBeforeOrAtTs(tsIndexEntryNearestFunc, getPropFunc, cycles);
 }
 
 } // namespace jacques
@@ -130,8 +130,7 @@ public:
 
 public:
     explicit Pkt(const PktIndexEntry& indexEntry, yactfr::ElementSequence& seq,
-                 const Metadata& metadata, yactfr::DataSource::UP dataSrc,
-                 std::unique_ptr<MemMappedFile> mmapFile,
+                 const Metadata& metadata, MemMappedFile::Window dataWindow,
                  PktCheckpointsBuildListener& pktCheckpointsBuildListener);
 
     /*
@@ -214,15 +213,19 @@ public:
     const Er *erBeforeOrAtCycles(unsigned long long cycles);
 
     /*
-     * Returned bit array remains valid as long as this packet object
-     * exists.
+     * Returned bit array remains valid until the data window of this
+     * packet moves (see data()).
      */
-    BitArray bitArray(const PktSegment& segment) const noexcept
+    BitArray bitArray(const PktSegment& segment) const
     {
         assert(segment.len());
 
+        const auto offsetInPktBytes = segment.offsetInPktBits() / 8;
+        const auto endOffsetInPktBytes = (segment.offsetInPktBits() + segment.len()->bits() +
+                                          7) / 8;
+
         return BitArray {
-            _mmapFile->addr() + segment.offsetInPktBits() / 8,
+            _dataWindow.addr(offsetInPktBytes, endOffsetInPktBytes - offsetInPktBytes),
             segment.offsetInFirstByteBits(),
             *segment.len(),
             segment.bo()
@@ -230,39 +233,45 @@ public:
     }
 
     /*
-     * Returned bit array remains valid as long as this packet object
-     * exists.
+     * Returned bit array remains valid until the data window of this
+     * packet moves (see data()).
      */
-    BitArray bitArray(const PktRegion& region) const noexcept
+    BitArray bitArray(const PktRegion& region) const
     {
         return this->bitArray(region.segment());
     }
 
     /*
-     * Returned bit array remains valid as long as this packet object
-     * exists.
+     * Returned bit array remains valid until the data window of this
+     * packet moves (see data()).
      */
-    BitArray bitArray(const Scope& scope) const noexcept
+    BitArray bitArray(const Scope& scope) const
     {
         return this->bitArray(scope.segment());
     }
 
     /*
-     * Returned bit array remains valid as long as this packet object
-     * exists.
+     * Returned bit array remains valid until the data window of this
+     * packet moves (see data()).
      */
-    BitArray bitArray(const Er& er) const noexcept
+    BitArray bitArray(const Er& er) const
     {
         return this->bitArray(er.segment());
     }
 
     /*
-     * Returned data remains valid as long as this packet object exists.
+     * Returns the data at `offsetInPktBytes`, making sure that the
+     * `lenBytes` bytes from there are addressable.
+     *
+     * A packet only maps a window of its data around the last access
+     * (see MemMappedFile::Window). The returned data remains valid
+     * until an access outside this window moves it, which never
+     * happens with a packet which isn't larger than the window.
      */
-    const std::uint8_t *data(const Index offsetInPktBytes) const
+    const std::uint8_t *data(const Index offsetInPktBytes, const Size lenBytes = 1) const
     {
-        assert(offsetInPktBytes < _indexEntry->effectiveTotalLen().bytes());
-        return _mmapFile->addr() + offsetInPktBytes;
+        assert(offsetInPktBytes + lenBytes <= _indexEntry->effectiveTotalLen().bytes());
+        return _dataWindow.addr(offsetInPktBytes, lenBytes);
     }
 
     bool hasData() const noexcept
@@ -546,9 +555,9 @@ private:
         regions.push_back(std::static_pointer_cast<const PktRegion>(*it));
     }
 
-    template <typename CpNearestFuncT, typename GetProcFuncT, typename PropT>
-    const Er *_erBeforeOrAtTs(CpNearestFuncT&& cpNearestFunc, GetProcFuncT&& getProcFuncT,
-                              const PropT prop)
+    template <typename TsIndexEntryNearestFuncT, typename GetProcFuncT, typename PropT>
+    const Er *_erBeforeOrAtTs(TsIndexEntryNearestFuncT&& tsIndexEntryNearestFunc,
+                              GetProcFuncT&& getProcFuncT, const PropT prop)
     {
         if (!_metadata->isCorrelatable()) {
             return nullptr;
@@ -569,15 +578,19 @@ private:
             return er.get();
         }
 
-        const auto cp = cpNearestFunc(prop);
+        /*
+         * The timestamp index is much denser than the checkpoints, so
+         * that we only decode a few event records from there.
+         */
+        const auto tsIndexEntry = tsIndexEntryNearestFunc(prop);
 
-        if (!cp) {
+        if (!tsIndexEntry) {
             return nullptr;
         }
 
-        _it.restorePosition(cp->second);
+        _it.restorePosition(tsIndexEntry->pos);
 
-        auto curIndex = cp->first->indexInPkt();
+        auto curIndex = tsIndexEntry->indexInPkt;
         auto inEr = false;
         boost::optional<Ts> ts;
         boost::optional<Index> indexInPkt;
@@ -634,8 +647,10 @@ private:
 private:
     const PktIndexEntry * const _indexEntry;
     const Metadata * const _metadata;
-    yactfr::DataSource::UP _dataSrc;
-    std::unique_ptr<MemMappedFile> _mmapFile;
+
+    // mutable: moving the window doesn't change the packet
+    mutable MemMappedFile::Window _dataWindow;
+
     yactfr::ElementSequenceIterator _it;
     yactfr::ElementSequenceIterator _endIt;
     PktCheckpoints _checkpoints;
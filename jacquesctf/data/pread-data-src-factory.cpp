@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <unistd.h>
+
+#include "pread-data-src-factory.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+namespace {
+
+class PreadDataSrc final :
+    public yactfr::DataSource
+{
+public:
+    explicit PreadDataSrc(const boost::filesystem::path& path, const int fd,
+                          const Size fileLenBytes, const Size minReadLenBytes,
+                          const Size maxReadLenBytes,
+                          std::shared_ptr<PreadDataSrcFactory::Stats> stats) :
+        _path {&path},
+        _fd {fd},
+        _fileLenBytes {fileLenBytes},
+        _minReadLenBytes {minReadLenBytes},
+        _maxReadLenBytes {maxReadLenBytes},
+        _readLenBytes {minReadLenBytes},
+        _stats {std::move(stats)}
+    {
+    }
+
+private:
+    boost::optional<yactfr::DataBlock> _data(const Index offset, const Size minSize) override
+    {
+        if (offset >= _fileLenBytes) {
+            return boost::none;
+        }
+
+        const auto bufEndOffset = _bufOffset + _buf.size();
+
+        if (offset < _bufOffset || offset + minSize > bufEndOffset) {
+            this->_read(offset, minSize);
+
+            if (_buf.size() < minSize) {
+                // fewer than `minSize` bytes remain: end of file
+                return boost::none;
+            }
+        }
+
+        assert(offset >= _bufOffset);
+        return yactfr::DataBlock {
+            _buf.data() + (offset - _bufOffset),
+            _bufOffset + _buf.size() - offset
+        };
+    }
+
+    /*
+     * Reads at least `minSize` bytes at `offset` into `_buf`, unless
+     * the file ends before: then `_buf` contains the remaining bytes.
+     */
+    void _read(const Index offset, const Size minSize)
+    {
+        const auto bufEndOffset = _bufOffset + _buf.size();
+
+        if (!_buf.empty() && offset >= bufEndOffset &&
+                offset - bufEndOffset < _readLenBytes) {
+            // close to the previous read: small packets
+            _readLenBytes = std::min(_readLenBytes * 2, _maxReadLenBytes);
+        } else {
+            _readLenBytes = _minReadLenBytes;
+        }
+
+        const auto lenBytes = std::min(std::max(_readLenBytes, minSize), _fileLenBytes - offset);
+
+        _buf.resize(lenBytes);
+        _bufOffset = offset;
+
+        Size doneLenBytes = 0;
+
+        while (doneLenBytes < lenBytes) {
+            const auto ret = pread(_fd, _buf.data() + doneLenBytes, lenBytes - doneLenBytes,
+                                   static_cast<off_t>(offset + doneLenBytes));
+
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                std::ostringstream ss;
+
+                ss << "Cannot read " << (lenBytes - doneLenBytes) << " bytes at offset " <<
+                      (offset + doneLenBytes) << " of file `" << _path->string() << "`.";
+                throw IOError {*_path, ss.str()};
+            }
+
+            if (ret == 0) {
+                // file is shorter than expected: keep what we have
+                _buf.resize(doneLenBytes);
+                break;
+            }
+
+            doneLenBytes += static_cast<Size>(ret);
+        }
+
+        ++_stats->readCount;
+        _stats->readLenBytes += doneLenBytes;
+    }
+
+private:
+    const boost::filesystem::path *_path;
+    const int _fd;
+    const Size _fileLenBytes;
+    const Size _minReadLenBytes;
+    const Size _maxReadLenBytes;
+    Size _readLenBytes;
+    std::vector<std::uint8_t> _buf;
+    Index _bufOffset = 0;
+    std::shared_ptr<PreadDataSrcFactory::Stats> _stats;
+};
+
+} // namespace
+
+PreadDataSrcFactory::PreadDataSrcFactory(boost::filesystem::path path, const int fd,
+                                         const Size fileLenBytes, const Size minReadLenBytes,
+                                         const Size maxReadLenBytes) :
+    _path {std::move(path)},
+    _fd {fd},
+    _fileLenBytes {fileLenBytes},
+    _minReadLenBytes {minReadLenBytes},
+    _maxReadLenBytes {std::max(maxReadLenBytes, minReadLenBytes)},
+    _stats {std::make_shared<Stats>()}
+{
+    assert(_minReadLenBytes > 0);
+}
+
+yactfr::DataSource::UP PreadDataSrcFactory::_createDataSource()
+{
+    return std::make_unique<PreadDataSrc>(_path, _fd, _fileLenBytes, _minReadLenBytes,
+                                          _maxReadLenBytes, _stats);
+}
+
+} // namespace jacques
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_PREAD_DATA_SRC_FACTORY_HPP
+#define _JACQUES_DATA_PREAD_DATA_SRC_FACTORY_HPP
+
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Data source factory of which the data sources read a file with
+ * pread(2) into a small buffer, only reading what the decoder asks for.
+ *
+ * This is what building a packet index needs: the decoder only reads
+ * the preamble (packet header and context) of each packet before
+ * seeking the next one. With memory-mapped windows, each header read
+ * of a packet bigger than a window maps a new window, and the kernel's
+ * readahead reads way more than the header; with those data sources,
+ * the I/O is proportional to the header bytes instead of the file
+ * bytes, which matters on a cold page cache or a network file system.
+ *
+ * The read length adapts to the packet sizes: as long as the next
+ * request is close to the end of the previous read (small packets),
+ * the read length doubles, up to `maxReadLenBytes`, so that a single
+ * system call reads the headers of many packets; a farther request
+ * (large packets) resets it to `minReadLenBytes`.
+ *
+ * The file descriptor must remain open as long as data sources exist.
+ */
+class PreadDataSrcFactory final :
+    public yactfr::DataSourceFactory
+{
+public:
+    // I/O statistics of all the data sources of a factory
+    struct Stats
+    {
+        Size readCount = 0;
+        Size readLenBytes = 0;
+    };
+
+public:
+    explicit PreadDataSrcFactory(boost::filesystem::path path, int fd, Size fileLenBytes,
+                                 Size minReadLenBytes = 4096, Size maxReadLenBytes = 256 << 10);
+
+    const Stats& stats() const noexcept
+    {
+        return *_stats;
+    }
+
+private:
+    yactfr::DataSource::UP _createDataSource() override;
+
+private:
+    const boost::filesystem::path _path;
+    const int _fd;
+    const Size _fileLenBytes;
+    const Size _minReadLenBytes;
+    const Size _maxReadLenBytes;
+    const std::shared_ptr<Stats> _stats;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_PREAD_DATA_SRC_FACTORY_HPP
@@ -37,11 +37,17 @@ public:
 public:
     static std::unique_ptr<Trace> withoutDsFiles(const boost::filesystem::path& traceDir);
 
+    // can be shared with other traces having the same metadata content
     const Metadata& metadata() const noexcept
     {
         return *_metadata;
     }
 
+    const boost::filesystem::path& metadataPath() const noexcept
+    {
+        return _metadataPath;
+    }
+
     DsFiles& dsFiles() noexcept
     {
         return _dsFiles;
@@ -52,12 +58,10 @@ public:
         return _dsFiles;
     }
 
-private:
-    void _createMetadata(const boost::filesystem::path& path);
-
 private:
     DsFiles _dsFiles;
-    std::unique_ptr<Metadata> _metadata;
+    const boost::filesystem::path _metadataPath;
+    std::shared_ptr<const Metadata> _metadata;
 };
 
 } // namespace jacques
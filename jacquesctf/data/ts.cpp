@@ -7,16 +7,130 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 #include <cstdint>
 #include <cstdlib>
 #include <cinttypes>
 #include <limits>
+#include <algorithm>
 #include <array>
 #include <time.h>
+#include <boost/optional.hpp>
 
 #include "ts.hpp"
+#include "utils.hpp"
 
 namespace jacques {
+namespace {
+
+constexpr auto llNsInS = 1'000'000'000LL;
+constexpr auto secsInDay = 86'400LL;
+
+// floored division (rounds towards negative infinity)
+constexpr long long floorDiv(const long long a, const long long b) noexcept
+{
+    return (a >= 0) ? a / b : (a - b + 1) / b;
+}
+
+/*
+ * Converts seconds from the origin to local calendar time.
+ *
+ * localtime_r() is slow and takes a process-wide lock to read the
+ * timezone: this converter only uses it to find the UTC offset of a
+ * given UTC day, which it caches, and does the rest with integer
+ * arithmetic.
+ *
+ * Not thread-safe: use one converter per thread.
+ */
+class LocalTimeConverter final
+{
+public:
+    void convert(const long long secs, Ts::Parts& parts)
+    {
+        const auto localSecs = secs + this->_utcOffsetSecs(secs);
+        const auto days = floorDiv(localSecs, secsInDay);
+        const auto secsInCurDay = localSecs - days * secsInDay;
+
+        parts.hour = static_cast<unsigned int>(secsInCurDay / 3600);
+        parts.min = static_cast<unsigned int>(secsInCurDay % 3600 / 60);
+        parts.sec = static_cast<unsigned int>(secsInCurDay % 60);
+
+        // 1970-01-01 is a Thursday
+        parts.weekday = static_cast<Weekday>(days - floorDiv(days + 4, 7) * 7 + 4);
+
+        /*
+         * Civil date from a number of days since 1970-01-01 in the
+         * proleptic Gregorian calendar (Howard Hinnant's
+         * `civil_from_days()` algorithm), with eras of 400 years
+         * starting on March 1st.
+         */
+        const auto shiftedDays = days + 719'468;
+        const auto era = floorDiv(shiftedDays, 146'097);
+        const auto dayOfEra = shiftedDays - era * 146'097;
+        const auto yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36'524 -
+                                dayOfEra / 146'096) / 365;
+        const auto dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const auto shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+        parts.day = static_cast<unsigned int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+        parts.month = static_cast<unsigned int>(shiftedMonth < 10 ? shiftedMonth + 3 :
+                                                shiftedMonth - 9);
+        parts.year = static_cast<int>(yearOfEra + era * 400 + (parts.month <= 2 ? 1 : 0));
+    }
+
+private:
+    struct _DayOffset
+    {
+        long long utcDay;
+
+        // offset for the whole day, or none if it changes during the day
+        boost::optional<long long> offsetSecs;
+    };
+
+private:
+    static long long _sysUtcOffsetSecs(const long long secs) noexcept
+    {
+        const auto timeT = static_cast<time_t>(secs);
+        tm tm;
+
+        if (!localtime_r(&timeT, &tm)) {
+            return 0;
+        }
+
+        return tm.tm_gmtoff;
+    }
+
+    long long _utcOffsetSecs(const long long secs)
+    {
+        const auto utcDay = floorDiv(secs, secsInDay);
+        auto& dayOffset = _dayOffsets[static_cast<Index>(utcDay) % _dayOffsets.size()];
+
+        if (!dayOffset || dayOffset->utcDay != utcDay) {
+            const auto firstSecs = utcDay * secsInDay;
+            const auto beginOffsetSecs = _sysUtcOffsetSecs(firstSecs);
+            const auto endOffsetSecs = _sysUtcOffsetSecs(firstSecs + secsInDay - 1);
+
+            dayOffset = _DayOffset {utcDay, boost::none};
+
+            if (beginOffsetSecs == endOffsetSecs) {
+                dayOffset->offsetSecs = beginOffsetSecs;
+            }
+        }
+
+        if (!dayOffset->offsetSecs) {
+            // daylight saving time transition day: rare
+            return _sysUtcOffsetSecs(secs);
+        }
+
+        return *dayOffset->offsetSecs;
+    }
+
+private:
+    // direct-mapped cache of recently converted UTC days
+    std::array<boost::optional<_DayOffset>, 64> _dayOffsets;
+};
+
+} // namespace
 
 Ts::Ts(const unsigned long long cycles, const unsigned long long freq, long long offsetSecs,
        const unsigned long long offsetCycles) noexcept :
@@ -26,8 +140,7 @@ Ts::Ts(const unsigned long long cycles, const unsigned long long freq, long long
     assert(offsetCycles < freq);
 
     const auto secsInCycles = cycles / freq;
-    constexpr auto nsInS = 1'000'000'000ULL;
-    constexpr auto llNsInS = static_cast<long long>(nsInS);
+    constexpr auto nsInS = static_cast<unsigned long long>(llNsInS);
 
     offsetSecs += secsInCycles;
 
@@ -50,32 +163,6 @@ Ts::Ts(const unsigned long long cycles, const unsigned long long freq, long long
     }
 
     _nsFromOrigin = offsetSecs * llNsInS + static_cast<long long>(offsetNsPart);
-
-    static_assert(sizeof(time_t) >= 8, "Expecting a 64-bit `time_t`.");
-
-    // I'm pretty sure there's a way to do this without branching
-    const auto secsFloor = static_cast<time_t>((_nsFromOrigin < 0) ?
-                                               (_nsFromOrigin - llNsInS) / llNsInS :
-                                               _nsFromOrigin / llNsInS);
-
-    tm tm;
-
-    localtime_r(&secsFloor, &tm);
-
-    // this too
-    if (_nsFromOrigin < 0) {
-        _ns = std::abs((std::abs(_nsFromOrigin) % llNsInS) - llNsInS);
-    } else {
-        _ns = _nsFromOrigin % llNsInS;
-    }
-
-    _sec = tm.tm_sec;
-    _min = tm.tm_min;
-    _hour = tm.tm_hour;
-    _day = tm.tm_mday;
-    _month = tm.tm_mon + 1;
-    _year = 1900 + tm.tm_year;
-    _weekday = static_cast<Weekday>(tm.tm_wday);
 }
 
 Ts::Ts(const unsigned long long cycles, const yactfr::ClockType& clkType) noexcept :
@@ -88,26 +175,65 @@ Ts::Ts(const unsigned long long cycles, const yactfr::ClockType& clkType) noexce
 {
 }
 
+Ts::Parts Ts::parts() const noexcept
+{
+    static thread_local LocalTimeConverter converter;
+    const auto secsFloor = floorDiv(_nsFromOrigin, llNsInS);
+    Parts parts;
+
+    converter.convert(secsFloor, parts);
+    parts.ns = static_cast<unsigned int>(_nsFromOrigin - secsFloor * llNsInS);
+    return parts;
+}
+
 void Ts::format(char * const buf, const Size bufSize, const TsFmtMode fmtMode) const
 {
+    if (bufSize == 0) {
+        return;
+    }
+
+    // long enough for any mode; truncated to `bufSize` like snprintf()
+    std::array<char, 48> fmtBuf;
+    auto fmtBufAt = fmtBuf.data();
+
     switch (fmtMode) {
     case TsFmtMode::LONG:
-        std::snprintf(buf, bufSize, "%d-%02u-%02u %02u:%02u:%02u.%09u", _year, _month, _day, _hour,
-                      _min, _sec, _ns);
-        break;
-
     case TsFmtMode::SHORT:
-        std::snprintf(buf, bufSize, "%02u:%02u:%02u.%09u", _hour, _min, _sec, _ns);
+    {
+        const auto parts = this->parts();
+
+        if (fmtMode == TsFmtMode::LONG) {
+            fmtBufAt += utils::formatInt(fmtBufAt, parts.year);
+            *fmtBufAt++ = '-';
+            fmtBufAt += utils::formatUInt(fmtBufAt, parts.month, 2);
+            *fmtBufAt++ = '-';
+            fmtBufAt += utils::formatUInt(fmtBufAt, parts.day, 2);
+            *fmtBufAt++ = ' ';
+        }
+
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.hour, 2);
+        *fmtBufAt++ = ':';
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.min, 2);
+        *fmtBufAt++ = ':';
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.sec, 2);
+        *fmtBufAt++ = '.';
+        fmtBufAt += utils::formatUInt(fmtBufAt, parts.ns, 9);
         break;
+    }
 
     case TsFmtMode::NS_FROM_ORIGIN:
-        std::snprintf(buf, bufSize, "%lld", _nsFromOrigin);
+        fmtBufAt += utils::formatInt(fmtBufAt, _nsFromOrigin);
         break;
 
     case TsFmtMode::CYCLES:
-        std::snprintf(buf, bufSize, "%llu", _cycles);
+        fmtBufAt += utils::formatUInt(fmtBufAt, _cycles);
         break;
     }
+
+    const auto len = std::min(static_cast<Size>(fmtBufAt - fmtBuf.data()), bufSize - 1);
+
+    std::memcpy(buf, fmtBuf.data(), len);
+    buf[len] = '\0';
 }
 
 std::string Ts::format(const TsFmtMode fmtMode) const
@@ -41,6 +41,20 @@ enum class Weekday
 class Ts final :
     public boost::totally_ordered<Ts>
 {
+public:
+    // local calendar time
+    struct Parts
+    {
+        int year;
+        unsigned int month;
+        unsigned int day;
+        unsigned int hour;
+        unsigned int min;
+        unsigned int sec;
+        unsigned int ns;
+        Weekday weekday;
+    };
+
 public:
     explicit Ts() noexcept = default;
     explicit Ts(unsigned long long cycles, const yactfr::ClockType& clkType) noexcept;
@@ -66,45 +80,13 @@ public:
         return _nsFromOrigin;
     }
 
-    unsigned int ns() const noexcept
-    {
-        return _ns;
-    }
-
-    unsigned int sec() const noexcept
-    {
-        return _sec;
-    }
-
-    unsigned int min() const noexcept
-    {
-        return _min;
-    }
-
-    unsigned int hour() const noexcept
-    {
-        return _hour;
-    }
-
-    unsigned int day() const noexcept
-    {
-        return _day;
-    }
-
-    unsigned int month() const noexcept
-    {
-        return _month;
-    }
-
-    int year() const noexcept
-    {
-        return _year;
-    }
-
-    Weekday weekday() const noexcept
-    {
-        return _weekday;
-    }
+    /*
+     * Breaks this timestamp down into local calendar time.
+     *
+     * This is only needed to format a timestamp, therefore a timestamp
+     * doesn't do it when you build it.
+     */
+    Parts parts() const noexcept;
 
     void format(char *buf, Size bufSize, TsFmtMode fmtMode = TsFmtMode::LONG) const;
     std::string format(TsFmtMode fmtMode = TsFmtMode::LONG) const;
@@ -123,14 +105,6 @@ private:
     unsigned long long _cycles;
     unsigned long long _freq;
     long long _nsFromOrigin;
-    unsigned int _ns,
-                 _sec,
-                 _min,
-                 _hour,
-                 _day,
-                 _month;
-    int _year;
-    Weekday _weekday;
 };
 
 static inline std::ostream& operator<<(std::ostream& stream, const Ts& ts)
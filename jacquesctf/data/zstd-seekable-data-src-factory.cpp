@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "zstd-seekable-data-src-factory.hpp"
+
+namespace jacques {
+namespace {
+
+class ZstdSeekableDataSrc final :
+    public yactfr::DataSource
+{
+public:
+    explicit ZstdSeekableDataSrc(std::shared_ptr<ZstdSeekableFile> file) :
+        _file {std::move(file)}
+    {
+    }
+
+private:
+    boost::optional<yactfr::DataBlock> _data(const Index offset, const Size minSize) override
+    {
+        const auto contentLenBytes = _file->contentLen().bytes();
+
+        if (offset >= contentLenBytes) {
+            return boost::none;
+        }
+
+        // keep the previous block alive until we have the next one
+        auto frame = _file->frameContaining(offset);
+        const auto frameEndOffset = frame->offsetBytes + frame->data.size();
+
+        if (offset + minSize <= frameEndOffset || frameEndOffset == contentLenBytes) {
+            const auto addr = frame->data.data() + (offset - frame->offsetBytes);
+
+            _block = std::shared_ptr<const std::uint8_t> {std::move(frame), addr};
+
+            return yactfr::DataBlock {_block.get(), frameEndOffset - offset};
+        }
+
+        // crossing a frame boundary: needs a contiguous copy
+        const auto lenBytes = std::min(minSize, contentLenBytes - offset);
+
+        _block = _file->region(offset, lenBytes);
+        return yactfr::DataBlock {_block.get(), lenBytes};
+    }
+
+private:
+    const std::shared_ptr<ZstdSeekableFile> _file;
+    std::shared_ptr<const std::uint8_t> _block;
+};
+
+} // namespace
+
+ZstdSeekableDataSrcFactory::ZstdSeekableDataSrcFactory(std::shared_ptr<ZstdSeekableFile> file) :
+    _file {std::move(file)}
+{
+    assert(_file);
+}
+
+yactfr::DataSource::UP ZstdSeekableDataSrcFactory::_createDataSource()
+{
+    return std::make_unique<ZstdSeekableDataSrc>(_file);
+}
+
+} // namespace jacques
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_ZSTD_SEEKABLE_DATA_SRC_FACTORY_HPP
+#define _JACQUES_DATA_ZSTD_SEEKABLE_DATA_SRC_FACTORY_HPP
+
+#include <memory>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+#include "zstd-seekable-file.hpp"
+
+namespace jacques {
+
+/*
+ * Data source factory of which the data sources read the decompressed
+ * content of a Zstandard seekable file.
+ *
+ * A data source hands the decoder the rest of the decompressed frame
+ * containing the requested offset, without copying it; the frames
+ * themselves are shared with the other users of the same file object
+ * through its LRU cache.
+ */
+class ZstdSeekableDataSrcFactory final :
+    public yactfr::DataSourceFactory
+{
+public:
+    explicit ZstdSeekableDataSrcFactory(std::shared_ptr<ZstdSeekableFile> file);
+
+private:
+    yactfr::DataSource::UP _createDataSource() override;
+
+private:
+    const std::shared_ptr<ZstdSeekableFile> _file;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_ZSTD_SEEKABLE_DATA_SRC_FACTORY_HPP
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <algorithm>
+#include <new>
+#include <sstream>
+#include <unistd.h>
+
+#ifdef JACQUES_HAS_ZSTD
+# include <zstd.h>
+#endif
+
+#include "zstd-seekable-file.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+namespace {
+
+constexpr std::uint32_t seekTableFooterMagic = 0x8f92eab1;
+constexpr std::uint32_t skippableFrameMagic = 0x184d2a5e;
+constexpr Size seekTableFooterLenBytes = 9;
+constexpr Size skippableFrameHeaderLenBytes = 8;
+
+std::uint32_t readLe32(const std::uint8_t * const buf) noexcept
+{
+    return static_cast<std::uint32_t>(buf[0]) |
+           (static_cast<std::uint32_t>(buf[1]) << 8) |
+           (static_cast<std::uint32_t>(buf[2]) << 16) |
+           (static_cast<std::uint32_t>(buf[3]) << 24);
+}
+
+void readFully(const boost::filesystem::path& path, const int fd, std::uint8_t * const buf,
+               const Size lenBytes, const Index offsetBytes)
+{
+    Size doneLenBytes = 0;
+
+    while (doneLenBytes < lenBytes) {
+        const auto ret = pread(fd, buf + doneLenBytes, lenBytes - doneLenBytes,
+                               static_cast<off_t>(offsetBytes + doneLenBytes));
+
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (ret <= 0) {
+            std::ostringstream ss;
+
+            ss << "Cannot read " << lenBytes << " bytes at offset " << offsetBytes <<
+                  " of file `" << path.string() << "`.";
+            throw IOError {path, ss.str()};
+        }
+
+        doneLenBytes += static_cast<Size>(ret);
+    }
+}
+
+} // namespace
+
+std::shared_ptr<ZstdSeekableFile> ZstdSeekableFile::tryCreate(const boost::filesystem::path& path,
+                                                              const int fd,
+                                                              const Size maxCacheLenBytes)
+{
+    const auto fileLenBytes = boost::filesystem::file_size(path);
+
+    if (fileLenBytes < skippableFrameHeaderLenBytes + seekTableFooterLenBytes) {
+        return nullptr;
+    }
+
+    // seek table footer: frame count, descriptor, and magic number
+    std::uint8_t footer[seekTableFooterLenBytes];
+
+    readFully(path, fd, footer, sizeof footer, fileLenBytes - sizeof footer);
+
+    if (readLe32(&footer[5]) != seekTableFooterMagic) {
+        // most probably a plain CTF data stream file
+        return nullptr;
+    }
+
+    const auto invalid = [&path](const char * const reason) {
+        std::ostringstream ss;
+
+        ss << "Invalid Zstandard seekable file `" << path.string() << "`: " << reason;
+        return IOError {path, ss.str()};
+    };
+
+#ifndef JACQUES_HAS_ZSTD
+    throw IOError {
+        path, "Jacques CTF is built without Zstandard support: cannot read `" +
+              path.string() + "`."
+    };
+#endif
+
+    const Size frameCount = readLe32(&footer[0]);
+    const auto descriptor = footer[4];
+
+    if (descriptor & 0x7c) {
+        throw invalid("reserved seek table descriptor bits are set.");
+    }
+
+    const Size entryLenBytes = (descriptor & 0x80) ? 12 : 8;
+    const auto tableLenBytes = frameCount * entryLenBytes;
+    const auto skippableFrameLenBytes = skippableFrameHeaderLenBytes + tableLenBytes +
+                                        seekTableFooterLenBytes;
+
+    if (skippableFrameLenBytes > fileLenBytes) {
+        throw invalid("seek table is larger than the file.");
+    }
+
+    std::vector<std::uint8_t> table(skippableFrameHeaderLenBytes + tableLenBytes);
+
+    readFully(path, fd, table.data(), table.size(), fileLenBytes - skippableFrameLenBytes);
+
+    if (readLe32(&table[0]) != skippableFrameMagic ||
+            readLe32(&table[4]) != tableLenBytes + seekTableFooterLenBytes) {
+        throw invalid("invalid seek table header.");
+    }
+
+    std::vector<_FrameEntry> frameEntries;
+    Index compOffsetBytes = 0;
+    Index offsetBytes = 0;
+
+    frameEntries.reserve(frameCount);
+
+    for (Index i = 0; i < frameCount; ++i) {
+        const auto entry = &table[skippableFrameHeaderLenBytes + i * entryLenBytes];
+        const Size compLenBytes = readLe32(&entry[0]);
+        const Size lenBytes = readLe32(&entry[4]);
+
+        frameEntries.push_back({compOffsetBytes, compLenBytes, offsetBytes, lenBytes});
+        compOffsetBytes += compLenBytes;
+        offsetBytes += lenBytes;
+    }
+
+    if (compOffsetBytes != fileLenBytes - skippableFrameLenBytes) {
+        throw invalid("frame sizes of the seek table don't match the file size.");
+    }
+
+    if (offsetBytes == 0) {
+        throw invalid("no content.");
+    }
+
+    /*
+     * Frames usually have the same decompressed length, except the
+     * last one: cache capacity in frames of the largest length.
+     */
+    const auto maxFrameLenBytes = std::max_element(frameEntries.begin(), frameEntries.end(),
+                                                   [](const auto& a, const auto& b) {
+        return a.lenBytes < b.lenBytes;
+    })->lenBytes;
+
+    return std::shared_ptr<ZstdSeekableFile> {
+        new ZstdSeekableFile {
+            path, fd, std::move(frameEntries),
+            std::max(maxCacheLenBytes / maxFrameLenBytes, 2ULL)
+        }
+    };
+}
+
+ZstdSeekableFile::ZstdSeekableFile(boost::filesystem::path path, const int fd,
+                                   std::vector<_FrameEntry> frameEntries,
+                                   const Size cacheFrameCount) :
+    _path {std::move(path)},
+    _fd {fd},
+    _frameEntries {std::move(frameEntries)},
+    _frameCache {cacheFrameCount}
+{
+    assert(!_frameEntries.empty());
+    _contentLen = DataLen::fromBytes(_frameEntries.back().offsetBytes +
+                                     _frameEntries.back().lenBytes);
+}
+
+ZstdSeekableFile::~ZstdSeekableFile()
+{
+#ifdef JACQUES_HAS_ZSTD
+    for (const auto dCtx : _dCtxs) {
+        ZSTD_freeDCtx(static_cast<ZSTD_DCtx *>(dCtx));
+    }
+#endif
+}
+
+Index ZstdSeekableFile::_frameIndexContaining(const Index offsetBytes) const noexcept
+{
+    assert(offsetBytes < _contentLen.bytes());
+
+    // last frame beginning at or before `offsetBytes` (skips empty frames)
+    const auto it = std::upper_bound(_frameEntries.begin(), _frameEntries.end(), offsetBytes,
+                                     [](const auto offsetBytes, const auto& entry) {
+        return offsetBytes < entry.offsetBytes;
+    });
+
+    assert(it != _frameEntries.begin());
+    return (it - _frameEntries.begin()) - 1;
+}
+
+ZstdSeekableFile::FrameSP ZstdSeekableFile::frameContaining(const Index offsetBytes)
+{
+    return this->_frame(this->_frameIndexContaining(offsetBytes));
+}
+
+ZstdSeekableFile::FrameSP ZstdSeekableFile::_frame(const Index frameIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock {_mutex};
+
+        if (const auto frame = _frameCache.get(frameIndex)) {
+            return *frame;
+        }
+    }
+
+    /*
+     * Read and decompress the frame without holding the lock so that
+     * other threads can get other frames meanwhile.
+     *
+     * Two threads can decompress the same frame: the first one to
+     * publish it wins, and the other one returns it too.
+     */
+    auto frame = this->_decompressFrame(frameIndex);
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    if (const auto cachedFrame = _frameCache.get(frameIndex)) {
+        return *cachedFrame;
+    }
+
+    _frameCache.insert(frameIndex, frame);
+    return frame;
+}
+
+ZstdSeekableFile::FrameSP ZstdSeekableFile::_decompressFrame(const Index frameIndex)
+{
+    const auto& entry = _frameEntries[frameIndex];
+    auto frame = std::make_shared<Frame>();
+
+    frame->offsetBytes = entry.offsetBytes;
+    frame->data.resize(entry.lenBytes);
+
+#ifdef JACQUES_HAS_ZSTD
+    std::vector<std::uint8_t> compData(entry.compLenBytes);
+
+    readFully(_path, _fd, compData.data(), compData.size(), entry.compOffsetBytes);
+
+    // take an unused decompression context, or create one
+    void *dCtx = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock {_mutex};
+
+        if (!_dCtxs.empty()) {
+            dCtx = _dCtxs.back();
+            _dCtxs.pop_back();
+        }
+    }
+
+    if (!dCtx) {
+        dCtx = ZSTD_createDCtx();
+
+        if (!dCtx) {
+            throw std::bad_alloc {};
+        }
+    }
+
+    const auto ret = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx *>(dCtx), frame->data.data(),
+                                         frame->data.size(), compData.data(), compData.size());
+
+    {
+        std::lock_guard<std::mutex> lock {_mutex};
+
+        _dCtxs.push_back(dCtx);
+    }
+
+    if (ZSTD_isError(ret) || ret != entry.lenBytes) {
+        std::ostringstream ss;
+
+        ss << "Cannot decompress frame #" << frameIndex << " of file `" << _path.string() <<
+              "`: " << (ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "unexpected length") << ".";
+        throw IOError {_path, ss.str()};
+    }
+#else
+    // tryCreate() doesn't create an object without libzstd
+    assert(false);
+#endif
+
+    return frame;
+}
+
+std::shared_ptr<const std::uint8_t> ZstdSeekableFile::region(const Index offsetBytes,
+                                                             const Size lenBytes)
+{
+    assert(lenBytes > 0);
+    assert(offsetBytes + lenBytes <= _contentLen.bytes());
+
+    auto frameIndex = this->_frameIndexContaining(offsetBytes);
+    auto frame = this->_frame(frameIndex);
+    const auto offsetInFrameBytes = offsetBytes - frame->offsetBytes;
+
+    if (offsetInFrameBytes + lenBytes <= frame->data.size()) {
+        // the region shares the frame
+        const auto addr = frame->data.data() + offsetInFrameBytes;
+
+        return std::shared_ptr<const std::uint8_t> {std::move(frame), addr};
+    }
+
+    // the region crosses frames: copy them
+    auto buf = std::make_shared<std::vector<std::uint8_t>>();
+
+    buf->reserve(lenBytes);
+
+    while (buf->size() < lenBytes) {
+        const auto beginIt = frame->data.begin() +
+                             (offsetBytes + buf->size() - frame->offsetBytes);
+        const auto copyLenBytes = std::min(lenBytes - buf->size(),
+                                           static_cast<Size>(frame->data.end() - beginIt));
+
+        buf->insert(buf->end(), beginIt, beginIt + copyLenBytes);
+
+        if (buf->size() < lenBytes) {
+            // next non-empty frame
+            do {
+                ++frameIndex;
+                assert(frameIndex < _frameEntries.size());
+            } while (_frameEntries[frameIndex].lenBytes == 0);
+
+            frame = this->_frame(frameIndex);
+        }
+    }
+
+    const auto addr = buf->data();
+
+    return std::shared_ptr<const std::uint8_t> {std::move(buf), addr};
+}
+
+} // namespace jacques
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_DATA_ZSTD_SEEKABLE_FILE_HPP
+#define _JACQUES_DATA_ZSTD_SEEKABLE_FILE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <boost/core/noncopyable.hpp>
+#include <boost/filesystem.hpp>
+
+#include "aliases.hpp"
+#include "data-len.hpp"
+#include "lru-cache.hpp"
+
+namespace jacques {
+
+/*
+ * File in the Zstandard seekable format.
+ *
+ * Such a file is a sequence of independent Zstandard frames followed
+ * by a seek table (a skippable frame) which contains the compressed
+ * and decompressed lengths of each frame. This object reads the seek
+ * table once, and then only decompresses the frames which contain the
+ * requested content, keeping the most recently used ones in an LRU
+ * cache of about `maxCacheLenBytes`.
+ *
+ * The offsets and lengths of the public methods are those of the
+ * decompressed content.
+ *
+ * All the public methods are thread-safe.
+ */
+class ZstdSeekableFile final :
+    boost::noncopyable
+{
+public:
+    // a decompressed frame
+    struct Frame
+    {
+        Index offsetBytes;
+        std::vector<std::uint8_t> data;
+    };
+
+    using FrameSP = std::shared_ptr<const Frame>;
+
+public:
+    /*
+     * Returns a Zstandard seekable file object for the file `path`
+     * (opened as `fd`, not closed by the returned object), or `nullptr`
+     * if this file isn't in the Zstandard seekable format.
+     *
+     * Throws `IOError` if the file is in this format, but Jacques CTF
+     * is built without libzstd or its seek table is invalid.
+     */
+    static std::shared_ptr<ZstdSeekableFile> tryCreate(const boost::filesystem::path& path,
+                                                       int fd,
+                                                       Size maxCacheLenBytes = 256 << 20);
+
+private:
+    struct _FrameEntry
+    {
+        Index compOffsetBytes;
+        Size compLenBytes;
+        Index offsetBytes;
+        Size lenBytes;
+    };
+
+private:
+    explicit ZstdSeekableFile(boost::filesystem::path path, int fd,
+                              std::vector<_FrameEntry> frameEntries, Size cacheFrameCount);
+
+public:
+    ~ZstdSeekableFile();
+
+    // decompressed frame containing the content byte at `offsetBytes`
+    FrameSP frameContaining(Index offsetBytes);
+
+    /*
+     * Returns `lenBytes` contiguous content bytes at `offsetBytes`
+     * (`offsetBytes` + `lenBytes` ≤ contentLen()) which remain valid
+     * as long as the returned pointer exists.
+     *
+     * This doesn't copy anything when the region is within a single
+     * frame.
+     */
+    std::shared_ptr<const std::uint8_t> region(Index offsetBytes, Size lenBytes);
+
+    const DataLen& contentLen() const noexcept
+    {
+        return _contentLen;
+    }
+
+    Size frameCount() const noexcept
+    {
+        return _frameEntries.size();
+    }
+
+    const boost::filesystem::path& path() const noexcept
+    {
+        return _path;
+    }
+
+private:
+    Index _frameIndexContaining(Index offsetBytes) const noexcept;
+    FrameSP _frame(Index frameIndex);
+    FrameSP _decompressFrame(Index frameIndex);
+
+private:
+    const boost::filesystem::path _path;
+    const int _fd;
+
+    // sorted by offset (compressed and decompressed)
+    const std::vector<_FrameEntry> _frameEntries;
+
+    DataLen _contentLen;
+
+    // protects everything below
+    std::mutex _mutex;
+
+    LruCache<Index, FrameSP> _frameCache;
+
+    /*
+     * Unused libzstd decompression contexts (`ZSTD_DCtx`): a thread
+     * takes one while it decompresses a frame.
+     */
+    std::vector<void *> _dCtxs;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_DATA_ZSTD_SEEKABLE_FILE_HPP
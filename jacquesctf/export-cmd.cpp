@@ -0,0 +1,984 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/core/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <boost/variant.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "cfg.hpp"
+#include "export-cmd.hpp"
+#include "io-error.hpp"
+#include "utils.hpp"
+#include "glob-pattern.hpp"
+#include "data/trace.hpp"
+#include "data/metadata.hpp"
+#include "data/metadata-intern-table.hpp"
+#include "data/ds-file.hpp"
+#include "data/data-len.hpp"
+#include "data/dt-path.hpp"
+#include "data/pkt-unit-scanner.hpp"
+#include "data/ts.hpp"
+
+namespace jacques {
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+using Erts = std::vector<const yactfr::EventRecordType *>;
+
+// event record which a worker decodes
+struct ErInfo
+{
+    Index natIndexInPkt;
+    Index offsetInDsFileBits;
+    Size lenBits;
+    boost::optional<long long> nsFromOrigin;
+    const yactfr::EventRecordType *ert;
+};
+
+void appendUInt(std::string& buf, const unsigned long long val)
+{
+    char valBuf[32];
+
+    buf.append(valBuf, utils::formatUInt(valBuf, val));
+}
+
+void appendInt(std::string& buf, const long long val)
+{
+    char valBuf[32];
+
+    buf.append(valBuf, utils::formatInt(valBuf, val));
+}
+
+void appendHex(std::string& buf, const std::uint8_t * const data, const Size len)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (Index i = 0; i < len; ++i) {
+        buf += digits[data[i] >> 4];
+        buf += digits[data[i] & 0xf];
+    }
+}
+
+const char *scopeName(const yactfr::Scope scope) noexcept
+{
+    switch (scope) {
+    case yactfr::Scope::PACKET_HEADER:
+        return "packet-header";
+
+    case yactfr::Scope::PACKET_CONTEXT:
+        return "packet-context";
+
+    case yactfr::Scope::EVENT_RECORD_HEADER:
+        return "header";
+
+    case yactfr::Scope::EVENT_RECORD_COMMON_CONTEXT:
+        return "common-context";
+
+    case yactfr::Scope::EVENT_RECORD_SPECIFIC_CONTEXT:
+        return "specific-context";
+
+    case yactfr::Scope::EVENT_RECORD_PAYLOAD:
+        return "payload";
+
+    default:
+        std::abort();
+    }
+}
+
+class FieldNameItemVisitor final :
+    public boost::static_visitor<void>
+{
+public:
+    explicit FieldNameItemVisitor(std::string& name) :
+        _name {&name}
+    {
+    }
+
+    void operator()(const DtPath::StructMemberItem& item) const
+    {
+        *_name += '.';
+        *_name += item.name;
+    }
+
+    void operator()(const DtPath::VarOptItem& item) const
+    {
+        *_name += '<';
+
+        if (item.name) {
+            *_name += *item.name;
+        } else {
+            *_name += std::to_string(item.index);
+        }
+
+        *_name += '>';
+    }
+
+    void operator()(const DtPath::CurArrayElemItem&) const
+    {
+        *_name += "[]";
+    }
+
+    void operator()(const DtPath::CurOptDataItem&) const
+    {
+    }
+
+private:
+    std::string *_name;
+};
+
+/*
+ * Field name of the data type `dt`, for example
+ * `payload.msg` or `specific-context.cpus[]`.
+ */
+std::string fieldName(const Metadata& metadata, const yactfr::DataType& dt)
+{
+    const auto& path = metadata.dtPath(dt);
+    std::string name {scopeName(path.scope())};
+    const FieldNameItemVisitor visitor {name};
+
+    for (const auto& item : path.items()) {
+        boost::apply_visitor(visitor, item);
+    }
+
+    return name;
+}
+
+/*
+ * Exports the event records of the data stream files of some traces.
+ *
+ * Like the "find all" search, the exporter uses a packet unit scanner
+ * (see PktUnitScanner), each worker formatting the event records of a
+ * unit into the buffer of this unit.
+ *
+ * The exporter writes the buffer of a unit as soon as all the previous
+ * units are written, so that the output is always in data stream file,
+ * packet, and event record order. A worker doesn't start a unit too far
+ * ahead of the next one to write, which bounds the memory usage.
+ */
+class Exporter final :
+    boost::noncopyable
+{
+public:
+    explicit Exporter(const ExportCfg& cfg, const std::vector<const DsFile *>& dsFiles,
+                      const int fd) :
+        _cfg {&cfg},
+        _fd {fd},
+        _dsFileErts {this->_matchingDsFileErts(dsFiles)},
+
+        // smaller than for the "find all" search: the output is larger
+        _scanner {dsFiles, 1_MiB, [this](const Index dsFileIndex) {
+            // nothing to export in a data stream file without matching types
+            const auto& erts = _dsFileErts[dsFileIndex];
+
+            return !erts || !erts->empty();
+        }},
+        _unitBufs(_scanner.units().size())
+    {
+    }
+
+    // writes the header, then exports all the units
+    void run()
+    {
+        this->_writeHeader();
+
+        const auto workerCount = _scanner.workerCount(_cfg->threadCount());
+
+        _maxPendingUnits = std::max(workerCount, static_cast<Size>(1)) * 2;
+        _workerStates.resize(workerCount);
+        _scanner.run(_cfg->threadCount(), [this](const Index unitIndex, const Index workerIndex,
+                                                 PktUnitScanner::WorkerIt& it) {
+            this->_exportUnitWhenPossible(unitIndex, _workerStates[workerIndex], it);
+        });
+
+        if (_writeErrno != 0) {
+            this->_throwWriteError(_writeErrno);
+        }
+    }
+
+    Size erroneousPktCount() const noexcept
+    {
+        return _erroneousPktCount;
+    }
+
+private:
+    // buffer of a unit of the scanner
+    struct _UnitBuf
+    {
+        // only valid until written
+        std::string buf;
+        bool isDone = false;
+    };
+
+    // state of a worker, reused from one unit to the other
+    struct _WorkerState
+    {
+        const DsFile *dsFile = nullptr;
+
+        // encoded field names
+        std::unordered_map<const yactfr::DataType *, std::string> fieldNames;
+
+        // fields of the current event record: encoded names and values
+        std::vector<std::pair<const std::string *, Size>> fields;
+        std::string fieldVals;
+
+        // raw string or BLOB value before encoding it
+        std::string rawVal;
+
+        // encoded path of the current data stream file
+        std::string dsFilePath;
+    };
+
+private:
+    std::vector<boost::optional<Erts>> _matchingDsFileErts(const std::vector<const DsFile *>& dsFiles) const
+    {
+        std::map<const Metadata *, boost::optional<Erts>> metadataErts;
+        std::vector<boost::optional<Erts>> dsFileErts;
+
+        for (const auto dsFile : dsFiles) {
+            auto ertsIt = metadataErts.find(&dsFile->metadata());
+
+            if (ertsIt == metadataErts.end()) {
+                ertsIt = metadataErts.insert({
+                    &dsFile->metadata(), this->_matchingErts(dsFile->metadata())
+                }).first;
+            }
+
+            dsFileErts.push_back(ertsIt->second);
+        }
+
+        return dsFileErts;
+    }
+
+    // `boost::none` means all of them
+    boost::optional<Erts> _matchingErts(const Metadata& metadata) const
+    {
+        if (!_cfg->ertNamePattern() && !_cfg->ertId()) {
+            return boost::none;
+        }
+
+        boost::optional<GlobPattern> namePattern;
+        Erts erts;
+
+        if (_cfg->ertNamePattern()) {
+            namePattern = GlobPattern {*_cfg->ertNamePattern()};
+        }
+
+        for (auto& dst : metadata.traceType().dataStreamTypes()) {
+            for (auto& ert : dst->eventRecordTypes()) {
+                if (namePattern && !(ert->name() && namePattern->matches(*ert->name()))) {
+                    continue;
+                }
+
+                if (_cfg->ertId() && ert->id() != *_cfg->ertId()) {
+                    continue;
+                }
+
+                erts.push_back(ert.get());
+            }
+        }
+
+        std::sort(erts.begin(), erts.end());
+        return erts;
+    }
+
+    void _exportUnitWhenPossible(const Index unitIndex, _WorkerState& workerState,
+                                 PktUnitScanner::WorkerIt& it)
+    {
+        {
+            std::unique_lock<std::mutex> lock {_mutex};
+
+            _cv.wait(lock, [this, unitIndex] {
+                return _scanner.isCanceled() ||
+                       unitIndex < _nextUnitToWrite + _maxPendingUnits;
+            });
+        }
+
+        if (_scanner.isCanceled()) {
+            return;
+        }
+
+        try {
+            this->_exportUnit(unitIndex, workerState, it);
+        } catch (...) {
+            // the scanner cancels the export: don't leave the other workers waiting
+            {
+                std::lock_guard<std::mutex> lock {_mutex};
+
+                _scanner.cancel();
+            }
+
+            _cv.notify_all();
+            throw;
+        }
+
+        this->_publish(unitIndex);
+    }
+
+    void _exportUnit(const Index unitIndex, _WorkerState& workerState,
+                     PktUnitScanner::WorkerIt& it)
+    {
+        const auto& unit = _scanner.units()[unitIndex];
+        const auto& dsFile = _scanner.dsFile(unit);
+        auto& buf = _unitBufs[unitIndex].buf;
+
+        if (workerState.dsFile != &dsFile) {
+            workerState.dsFile = &dsFile;
+            workerState.dsFilePath.clear();
+
+            if (_cfg->format() == ExportCfg::Fmt::CSV) {
+                utils::appendCsvField(workerState.dsFilePath, dsFile.path().string().data(),
+                                      dsFile.path().string().size());
+            } else {
+                utils::appendJsonStr(workerState.dsFilePath, dsFile.path().string().data(),
+                                     dsFile.path().string().size());
+            }
+        }
+
+        for (auto pktIndex = unit.beginPktIndex; pktIndex < unit.endPktIndex; ++pktIndex) {
+            this->_exportPkt(buf, unit.dsFileIndex, workerState, it,
+                             dsFile.decodedPktIndexEntry(pktIndex));
+        }
+    }
+
+    void _exportPkt(std::string& buf, const Index dsFileIndex, _WorkerState& workerState,
+                    PktUnitScanner::WorkerIt& workerIt, const PktIndexEntry& pktIndexEntry)
+    {
+        using ElemKind = yactfr::Element::Kind;
+
+        const auto& dsFile = *workerState.dsFile;
+        const auto& erts = _dsFileErts[dsFileIndex];
+        const auto isCorrelatable = dsFile.metadata().isCorrelatable();
+        boost::optional<long long> curNsFromOrigin;
+        ErInfo erInfo {0, 0, 0, boost::none, nullptr};
+        auto isInEr = false;
+        auto isSkippingEr = false;
+
+        try {
+            auto& it = workerIt.seekPkt(dsFile, pktIndexEntry);
+
+            while (it->kind() != ElemKind::PACKET_END) {
+                switch (it->kind()) {
+                case ElemKind::EVENT_RECORD_BEGINNING:
+                    ++erInfo.natIndexInPkt;
+                    erInfo.offsetInDsFileBits = it.offset();
+                    erInfo.ert = nullptr;
+                    erInfo.nsFromOrigin = boost::none;
+                    workerState.fields.clear();
+                    workerState.fieldVals.clear();
+                    isInEr = true;
+                    isSkippingEr = false;
+                    break;
+
+                case ElemKind::EVENT_RECORD_INFO:
+                    erInfo.ert = it->asEventRecordInfoElement().type();
+
+                    // like Er: the last clock value before the info
+                    erInfo.nsFromOrigin = curNsFromOrigin;
+
+                    if (erts && !(erInfo.ert &&
+                                  std::binary_search(erts->begin(), erts->end(), erInfo.ert))) {
+                        // don't format the remaining fields for nothing
+                        isSkippingEr = true;
+                    }
+
+                    break;
+
+                case ElemKind::DEFAULT_CLOCK_VALUE:
+                    if (isCorrelatable) {
+                        assert(pktIndexEntry.dst());
+                        assert(pktIndexEntry.dst()->defaultClockType());
+                        curNsFromOrigin = Ts {
+                            it->asDefaultClockValueElement().cycles(),
+                            *pktIndexEntry.dst()->defaultClockType()
+                        }.nsFromOrigin();
+                    }
+
+                    break;
+
+                case ElemKind::EVENT_RECORD_END:
+                    isInEr = false;
+
+                    if (isSkippingEr || !erInfo.ert) {
+                        break;
+                    }
+
+                    erInfo.lenBits = it.offset() - erInfo.offsetInDsFileBits;
+                    this->_appendEr(buf, workerState, pktIndexEntry, erInfo);
+                    break;
+
+                default:
+                    if (isInEr && !isSkippingEr) {
+                        this->_tryAppendField(it, workerState);
+                    }
+
+                    break;
+                }
+
+                ++it;
+            }
+        } catch (const yactfr::DecodingError&) {
+            /*
+             * Keep what we have: like the inspection view, the export
+             * stops at the first decoding error of the packet.
+             *
+             * Any other error (I/O error, out of memory) makes the
+             * scanner cancel the export and then rethrow it.
+             */
+            ++_erroneousPktCount;
+        }
+    }
+
+    // appends the field of the element at `it`, if it's a field value
+    void _tryAppendField(yactfr::ElementSequenceIterator& it, _WorkerState& workerState)
+    {
+        using ElemKind = yactfr::Element::Kind;
+
+        auto& vals = workerState.fieldVals;
+        const yactfr::DataType *dt = nullptr;
+        const auto valBegin = vals.size();
+
+        switch (it->kind()) {
+        case ElemKind::FIXED_LENGTH_BIT_ARRAY:
+        {
+            auto& elem = it->asFixedLengthBitArrayElement();
+
+            dt = &elem.type();
+            appendUInt(vals, elem.unsignedIntegerValue());
+            break;
+        }
+
+        case ElemKind::FIXED_LENGTH_BIT_MAP:
+        {
+            auto& elem = it->asFixedLengthBitMapElement();
+
+            dt = &elem.type();
+            appendUInt(vals, elem.unsignedIntegerValue());
+            break;
+        }
+
+        case ElemKind::FIXED_LENGTH_BOOLEAN:
+        {
+            auto& elem = static_cast<const yactfr::FixedLengthBooleanElement&>(*it);
+
+            dt = &elem.type();
+            vals += elem.value() ? "true" : "false";
+            break;
+        }
+
+        case ElemKind::FIXED_LENGTH_SIGNED_INTEGER:
+        {
+            auto& elem = static_cast<const yactfr::FixedLengthSignedIntegerElement&>(*it);
+
+            dt = &elem.type();
+            appendInt(vals, elem.value());
+            break;
+        }
+
+        case ElemKind::FIXED_LENGTH_UNSIGNED_INTEGER:
+        {
+            auto& elem = static_cast<const yactfr::FixedLengthUnsignedIntegerElement&>(*it);
+
+            dt = &elem.type();
+            appendUInt(vals, elem.value());
+            break;
+        }
+
+        case ElemKind::VARIABLE_LENGTH_SIGNED_INTEGER:
+        {
+            auto& elem = static_cast<const yactfr::VariableLengthSignedIntegerElement&>(*it);
+
+            dt = &elem.type();
+            appendInt(vals, elem.value());
+            break;
+        }
+
+        case ElemKind::VARIABLE_LENGTH_UNSIGNED_INTEGER:
+        {
+            auto& elem = static_cast<const yactfr::VariableLengthUnsignedIntegerElement&>(*it);
+
+            dt = &elem.type();
+            appendUInt(vals, elem.value());
+            break;
+        }
+
+        case ElemKind::FIXED_LENGTH_FLOATING_POINT_NUMBER:
+        {
+            auto& elem = static_cast<const yactfr::FixedLengthFloatingPointNumberElement&>(*it);
+
+            dt = &elem.type();
+
+            if (std::isfinite(elem.value())) {
+                char valBuf[32];
+
+                vals.append(valBuf, std::snprintf(valBuf, sizeof(valBuf), "%.17g",
+                                                  elem.value()));
+            } else if (_cfg->format() == ExportCfg::Fmt::JSON_LINES) {
+                vals += "null";
+            } else {
+                vals += std::isnan(elem.value()) ? "nan" : elem.value() < 0 ? "-inf" : "inf";
+            }
+
+            break;
+        }
+
+        case ElemKind::NULL_TERMINATED_STRING_BEGINNING:
+        case ElemKind::STATIC_LENGTH_STRING_BEGINNING:
+        case ElemKind::DYNAMIC_LENGTH_STRING_BEGINNING:
+        {
+            if (it->isNullTerminatedStringBeginningElement()) {
+                dt = &it->asNullTerminatedStringBeginningElement().type();
+            } else if (it->isStaticLengthStringBeginningElement()) {
+                dt = &it->asStaticLengthStringBeginningElement().type();
+            } else {
+                dt = &it->asDynamicLengthStringBeginningElement().type();
+            }
+
+            const auto isUtf8 = dt->isStringType() &&
+                                dt->asStringType().encoding() == yactfr::StringEncoding::UTF_8;
+
+            this->_appendRawDataField(it, workerState, isUtf8);
+            break;
+        }
+
+        case ElemKind::STATIC_LENGTH_BLOB_BEGINNING:
+        case ElemKind::DYNAMIC_LENGTH_BLOB_BEGINNING:
+            if (it->isStaticLengthBlobBeginningElement()) {
+                dt = &it->asStaticLengthBlobBeginningElement().type();
+            } else {
+                dt = &it->asDynamicLengthBlobBeginningElement().type();
+            }
+
+            this->_appendRawDataField(it, workerState, false);
+            break;
+
+        default:
+            // not a field value
+            return;
+        }
+
+        assert(dt);
+        workerState.fields.push_back({&this->_fieldName(workerState, *dt), valBegin});
+    }
+
+    /*
+     * Appends the string or BLOB value which starts at `it`, leaving
+     * `it` at its end element.
+     *
+     * Appends the text of a UTF-8 string (up to its first null
+     * character), or the hexadecimal bytes otherwise.
+     */
+    void _appendRawDataField(yactfr::ElementSequenceIterator& it, _WorkerState& workerState,
+                             const bool isText)
+    {
+        auto& raw = workerState.rawVal;
+        auto isTerminated = false;
+
+        raw.clear();
+        ++it;
+
+        while (!it->isNullTerminatedStringEndElement() &&
+                !it->isStaticLengthStringEndElement() &&
+                !it->isDynamicLengthStringEndElement() &&
+                !it->isStaticLengthBlobEndElement() &&
+                !it->isDynamicLengthBlobEndElement()) {
+            if (it->isRawDataElement()) {
+                auto& elem = it->asRawDataElement();
+                const auto data = elem.dataBegin();
+                const auto len = elem.size();
+
+                if (!isText) {
+                    appendHex(raw, data, len);
+                } else if (!isTerminated) {
+                    const auto end = std::find(data, data + len, 0);
+
+                    raw.append(reinterpret_cast<const char *>(data), end - data);
+                    isTerminated = end != data + len;
+                }
+            }
+
+            ++it;
+        }
+
+        if (_cfg->format() == ExportCfg::Fmt::CSV) {
+            utils::appendCsvField(workerState.fieldVals, raw.data(), raw.size());
+        } else {
+            utils::appendJsonStr(workerState.fieldVals, raw.data(), raw.size());
+        }
+    }
+
+    const std::string& _fieldName(_WorkerState& workerState, const yactfr::DataType& dt)
+    {
+        auto nameIt = workerState.fieldNames.find(&dt);
+
+        if (nameIt == workerState.fieldNames.end()) {
+            const auto name = fieldName(workerState.dsFile->metadata(), dt);
+            std::string encName;
+
+            if (_cfg->format() == ExportCfg::Fmt::CSV) {
+                utils::appendCsvField(encName, name.data(), name.size());
+            } else {
+                utils::appendJsonStr(encName, name.data(), name.size());
+            }
+
+            nameIt = workerState.fieldNames.insert({&dt, std::move(encName)}).first;
+        }
+
+        return nameIt->second;
+    }
+
+    void _appendEr(std::string& buf, const _WorkerState& workerState,
+                   const PktIndexEntry& pktIndexEntry, const ErInfo& erInfo)
+    {
+        switch (_cfg->format()) {
+        case ExportCfg::Fmt::CSV:
+            this->_appendCsvEr(buf, workerState, pktIndexEntry, erInfo);
+            break;
+
+        case ExportCfg::Fmt::JSON_LINES:
+            this->_appendJsonLinesEr(buf, workerState, pktIndexEntry, erInfo);
+            break;
+        }
+    }
+
+    // one row per field (one row without a field if there's none)
+    void _appendCsvEr(std::string& buf, const _WorkerState& workerState,
+                      const PktIndexEntry& pktIndexEntry, const ErInfo& erInfo)
+    {
+        const auto appendPrefix = [&] {
+            buf += workerState.dsFilePath;
+            buf += ',';
+            appendUInt(buf, pktIndexEntry.natIndexInDsFile());
+            buf += ',';
+            appendUInt(buf, erInfo.natIndexInPkt);
+            buf += ',';
+            appendUInt(buf, erInfo.offsetInDsFileBits);
+            buf += ',';
+            appendUInt(buf, erInfo.lenBits);
+            buf += ',';
+
+            if (erInfo.nsFromOrigin) {
+                appendInt(buf, *erInfo.nsFromOrigin);
+            }
+
+            buf += ',';
+
+            if (pktIndexEntry.dst()) {
+                appendUInt(buf, pktIndexEntry.dst()->id());
+            }
+
+            buf += ',';
+            appendUInt(buf, erInfo.ert->id());
+            buf += ',';
+
+            if (erInfo.ert->name()) {
+                utils::appendCsvField(buf, erInfo.ert->name()->data(),
+                                      erInfo.ert->name()->size());
+            }
+
+            buf += ',';
+        };
+
+        if (workerState.fields.empty()) {
+            appendPrefix();
+            buf += ",\n";
+            return;
+        }
+
+        for (Index i = 0; i < workerState.fields.size(); ++i) {
+            appendPrefix();
+            this->_appendField(buf, workerState, i, ',');
+            buf += '\n';
+        }
+    }
+
+    void _appendJsonLinesEr(std::string& buf, const _WorkerState& workerState,
+                            const PktIndexEntry& pktIndexEntry, const ErInfo& erInfo)
+    {
+        buf += "{\"path\":";
+        buf += workerState.dsFilePath;
+        buf += ",\"packet-index\":";
+        appendUInt(buf, pktIndexEntry.natIndexInDsFile());
+        buf += ",\"index\":";
+        appendUInt(buf, erInfo.natIndexInPkt);
+        buf += ",\"offset-bits\":";
+        appendUInt(buf, erInfo.offsetInDsFileBits);
+        buf += ",\"size-bits\":";
+        appendUInt(buf, erInfo.lenBits);
+        buf += ",\"ts-ns-from-origin\":";
+
+        if (erInfo.nsFromOrigin) {
+            appendInt(buf, *erInfo.nsFromOrigin);
+        } else {
+            buf += "null";
+        }
+
+        buf += ",\"data-stream-type-id\":";
+
+        if (pktIndexEntry.dst()) {
+            appendUInt(buf, pktIndexEntry.dst()->id());
+        } else {
+            buf += "null";
+        }
+
+        buf += ",\"type-id\":";
+        appendUInt(buf, erInfo.ert->id());
+        buf += ",\"type-name\":";
+
+        if (erInfo.ert->name()) {
+            utils::appendJsonStr(buf, erInfo.ert->name()->data(), erInfo.ert->name()->size());
+        } else {
+            buf += "null";
+        }
+
+        // pairs rather than an object: names repeat within arrays
+        buf += ",\"fields\":[";
+
+        for (Index i = 0; i < workerState.fields.size(); ++i) {
+            if (i > 0) {
+                buf += ',';
+            }
+
+            buf += '[';
+            this->_appendField(buf, workerState, i, ',');
+            buf += ']';
+        }
+
+        buf += "]}\n";
+    }
+
+    // appends the encoded name and value of field `index`, separated with `sep`
+    static void _appendField(std::string& buf, const _WorkerState& workerState,
+                             const Index index, const char sep)
+    {
+        const auto& field = workerState.fields[index];
+        const auto valEnd = index + 1 < workerState.fields.size() ?
+                            workerState.fields[index + 1].second : workerState.fieldVals.size();
+
+        buf += *field.first;
+        buf += sep;
+        buf.append(workerState.fieldVals, field.second, valEnd - field.second);
+    }
+
+    void _writeHeader()
+    {
+        if (_cfg->format() == ExportCfg::Fmt::JSON_LINES) {
+            // no header
+            return;
+        }
+
+        const std::string buf {
+            "Data stream file path,Packet index,Event record index,Offset (bits),"
+            "Size (bits),Timestamp (ns from origin),Data stream type ID,"
+            "Event record type ID,Event record type name,Field,Value\n"
+        };
+
+        if (!this->_write(buf)) {
+            this->_throwWriteError(errno);
+        }
+    }
+
+    void _publish(const Index unitIndex)
+    {
+        {
+            std::lock_guard<std::mutex> lock {_mutex};
+
+            _unitBufs[unitIndex].isDone = true;
+
+            // write all the complete units which follow the written ones
+            while (!_scanner.isCanceled() && _nextUnitToWrite < _unitBufs.size() &&
+                    _unitBufs[_nextUnitToWrite].isDone) {
+                auto& writeBuf = _unitBufs[_nextUnitToWrite].buf;
+
+                if (!this->_write(writeBuf)) {
+                    _writeErrno = errno;
+                    _scanner.cancel();
+                }
+
+                writeBuf.clear();
+                writeBuf.shrink_to_fit();
+                ++_nextUnitToWrite;
+            }
+        }
+
+        _cv.notify_all();
+    }
+
+    bool _write(const std::string& buf)
+    {
+        Index offset = 0;
+
+        while (offset < buf.size()) {
+            const auto ret = ::write(_fd, buf.data() + offset, buf.size() - offset);
+
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            offset += static_cast<Index>(ret);
+        }
+
+        return true;
+    }
+
+    [[noreturn]] void _throwWriteError(const int errorNumber) const
+    {
+        const auto path = _cfg->outputPath() ? *_cfg->outputPath() : bfs::path {"-"};
+
+        throw IOError {path, std::string {"Cannot write: "} + std::strerror(errorNumber)};
+    }
+
+private:
+    const ExportCfg *_cfg;
+    const int _fd;
+
+    // matching event record types, per data stream file
+    const std::vector<boost::optional<Erts>> _dsFileErts;
+
+    PktUnitScanner _scanner;
+
+    // per unit of `_scanner`
+    std::vector<_UnitBuf> _unitBufs;
+
+    // per worker of `_scanner`
+    std::vector<_WorkerState> _workerStates;
+
+    Size _maxPendingUnits = 1;
+    std::atomic<Size> _erroneousPktCount {0};
+
+    // protects everything below and `_UnitBuf::isDone`
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    Index _nextUnitToWrite = 0;
+    int _writeErrno = 0;
+};
+
+/*
+ * Output file descriptor: the standard output, or a file which it
+ * closes on destruction if close() wasn't called.
+ */
+class OutFd final :
+    boost::noncopyable
+{
+public:
+    explicit OutFd(const boost::optional<bfs::path>& path) :
+        _path {path}
+    {
+        if (!_path) {
+            return;
+        }
+
+        _fd = ::open(_path->c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (_fd < 0) {
+            throw IOError {*_path, std::string {"Cannot open file: "} + std::strerror(errno)};
+        }
+    }
+
+    ~OutFd()
+    {
+        if (_path && _fd >= 0) {
+            ::close(_fd);
+        }
+    }
+
+    // closes the file, if any
+    void close()
+    {
+        if (!_path) {
+            return;
+        }
+
+        const auto fd = _fd;
+
+        _fd = -1;
+
+        if (::close(fd) != 0) {
+            throw IOError {*_path, std::string {"Cannot close file: "} + std::strerror(errno)};
+        }
+    }
+
+    int fd() const noexcept
+    {
+        return _fd;
+    }
+
+private:
+    const boost::optional<bfs::path> _path;
+    int _fd = STDOUT_FILENO;
+};
+
+} // namespace
+
+void exportCmd(const ExportCfg& cfg)
+{
+    // trace directory to set of data stream file paths
+    std::map<bfs::path, std::vector<bfs::path>> groupedDsFilePaths;
+
+    for (auto& dsfPath : cfg.paths()) {
+        groupedDsFilePaths[dsfPath.parent_path()].push_back(dsfPath);
+    }
+
+    // parse the distinct metadata of all the traces in parallel
+    {
+        std::vector<bfs::path> metadataPaths;
+
+        for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+            metadataPaths.push_back(traceDirDsFilePathsPair.first / "metadata");
+        }
+
+        MetadataInternTable::instance().preload(metadataPaths, cfg.threadCount());
+    }
+
+    std::vector<std::unique_ptr<Trace>> traces;
+    std::vector<const DsFile *> dsFiles;
+
+    for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+        traces.push_back(std::make_unique<Trace>(traceDirDsFilePathsPair.second));
+
+        for (auto& dsf : traces.back()->dsFiles()) {
+            dsf->buildIndex();
+            dsFiles.push_back(dsf.get());
+        }
+    }
+
+    OutFd outFd {cfg.outputPath()};
+    Exporter exporter {cfg, dsFiles, outFd.fd()};
+
+    exporter.run();
+    outFd.close();
+
+    if (exporter.erroneousPktCount() > 0) {
+        std::cerr << "WARNING: " << exporter.erroneousPktCount() <<
+                     " packet(s) could not be fully decoded." << std::endl;
+    }
+}
+
+} // namespace jacques
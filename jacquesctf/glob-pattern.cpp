@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "glob-pattern.hpp"
+
+namespace jacques {
+namespace {
+
+inline bool startsWith(const char * const candidate, const Size candidateLen,
+                       const std::string& run) noexcept
+{
+    return candidateLen >= run.size() &&
+           std::memcmp(candidate, run.data(), run.size()) == 0;
+}
+
+inline bool endsWith(const char * const candidate, const Size candidateLen,
+                     const std::string& run) noexcept
+{
+    return candidateLen >= run.size() &&
+           std::memcmp(candidate + candidateLen - run.size(), run.data(), run.size()) == 0;
+}
+
+inline const char *find(const char * const haystack, const Size haystackLen,
+                        const std::string& run) noexcept
+{
+    if (run.size() == 1) {
+        return static_cast<const char *>(std::memchr(haystack, run[0], haystackLen));
+    }
+
+    return static_cast<const char *>(memmem(haystack, haystackLen, run.data(), run.size()));
+}
+
+} // namespace
+
+GlobPattern::GlobPattern(const std::string& pattern) :
+    _pattern {pattern}
+{
+    std::string curRun;
+    Size starCount = 0;
+    auto hasTrailingBackslash = false;
+
+    for (auto it = pattern.begin(); it != pattern.end(); ++it) {
+        switch (*it) {
+        case '*':
+            _runs.push_back(std::move(curRun));
+            curRun.clear();
+            ++starCount;
+            break;
+
+        case '\\':
+            // escaped character
+            if (it + 1 == pattern.end()) {
+                hasTrailingBackslash = true;
+                break;
+            }
+
+            ++it;
+
+            // fall through!
+
+        default:
+            curRun += *it;
+            break;
+        }
+    }
+
+    _runs.push_back(std::move(curRun));
+
+    // consecutive stars: remove the empty runs between them
+    if (_runs.size() > 2) {
+        auto it = _runs.begin() + 1;
+
+        while (it != _runs.end() - 1) {
+            if (it->empty()) {
+                it = _runs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (const auto& run : _runs) {
+        _minLen += run.size();
+    }
+
+    if (hasTrailingBackslash) {
+        // utils::globMatch() never matches it
+        _kind = _Kind::NONE;
+    } else if (starCount == 0) {
+        _kind = _Kind::EXACT;
+    } else if (_runs.size() == 2) {
+        if (_runs[0].empty() && _runs[1].empty()) {
+            _kind = _Kind::ANY;
+        } else if (_runs[1].empty()) {
+            _kind = _Kind::PREFIX;
+        } else if (_runs[0].empty()) {
+            _kind = _Kind::SUFFIX;
+        } else {
+            _kind = _Kind::GENERAL;
+        }
+    } else if (_runs.size() == 3 && _runs[0].empty() && _runs[2].empty()) {
+        _kind = _Kind::INFIX;
+    } else {
+        _kind = _Kind::GENERAL;
+    }
+}
+
+bool GlobPattern::matches(const char * const candidate, const Size candidateLen) const noexcept
+{
+    if (candidateLen < _minLen) {
+        return false;
+    }
+
+    switch (_kind) {
+    case _Kind::EXACT:
+        return candidateLen == _runs[0].size() &&
+               std::memcmp(candidate, _runs[0].data(), candidateLen) == 0;
+
+    case _Kind::ANY:
+        return true;
+
+    case _Kind::NONE:
+        return false;
+
+    case _Kind::PREFIX:
+        return startsWith(candidate, candidateLen, _runs[0]);
+
+    case _Kind::SUFFIX:
+        return endsWith(candidate, candidateLen, _runs[1]);
+
+    case _Kind::INFIX:
+        return find(candidate, candidateLen, _runs[1]);
+
+    default:
+        return this->_matchesGeneral(candidate, candidateLen);
+    }
+}
+
+bool GlobPattern::_matchesGeneral(const char * const candidate,
+                                  const Size candidateLen) const noexcept
+{
+    assert(_runs.size() >= 2);
+
+    const auto& firstRun = _runs.front();
+    const auto& lastRun = _runs.back();
+
+    // anchored ends (`_minLen` guarantees that they don't overlap)
+    if (!startsWith(candidate, candidateLen, firstRun) ||
+            !endsWith(candidate, candidateLen, lastRun)) {
+        return false;
+    }
+
+    // middle runs, in order, between the anchored ends
+    auto at = candidate + firstRun.size();
+    const auto end = candidate + candidateLen - lastRun.size();
+
+    for (auto it = _runs.begin() + 1; it != _runs.end() - 1; ++it) {
+        const auto found = find(at, end - at, *it);
+
+        if (!found) {
+            return false;
+        }
+
+        at = found + it->size();
+    }
+
+    return true;
+}
+
+} // namespace jacques
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_GLOB_PATTERN_HPP
+#define _JACQUES_GLOB_PATTERN_HPP
+
+#include <string>
+#include <vector>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+/*
+ * Compiled globbing pattern.
+ *
+ * Like utils::globMatch(), only the `*` special character works, and
+ * `\` escapes the following character. A pattern ending with an
+ * unescaped `\` doesn't match anything.
+ *
+ * Building a globbing pattern splits it into the literal runs between
+ * its stars, so that matching a candidate string doesn't need to parse
+ * the pattern again nor backtrack character by character:
+ *
+ * * The first run (if the pattern doesn't start with `*`) must be a
+ *   prefix of the candidate.
+ *
+ * * The last run (if the pattern doesn't end with `*`) must be a
+ *   suffix of the candidate.
+ *
+ * * The other runs must appear, in order and without overlapping,
+ *   between them. Finding each one as early as possible is enough, so
+ *   that this is a single forward memmem() (which is vectorized in any
+ *   decent C library) per run.
+ *
+ * The common `prefix*`, `*suffix`, and `*infix*` forms (and the ones
+ * without any star) have their own paths.
+ */
+class GlobPattern final
+{
+public:
+    explicit GlobPattern(const std::string& pattern);
+
+    bool matches(const char *candidate, Size candidateLen) const noexcept;
+
+    bool matches(const std::string& candidate) const noexcept
+    {
+        return this->matches(candidate.data(), candidate.size());
+    }
+
+    const std::string& pattern() const noexcept
+    {
+        return _pattern;
+    }
+
+private:
+    enum class _Kind
+    {
+        // no star: `lit`
+        EXACT,
+
+        // `*`
+        ANY,
+
+        // ends with an unescaped `\`
+        NONE,
+
+        // `lit*`
+        PREFIX,
+
+        // `*lit`
+        SUFFIX,
+
+        // `*lit*`
+        INFIX,
+
+        // anything else
+        GENERAL,
+    };
+
+private:
+    bool _matchesGeneral(const char *candidate, Size candidateLen) const noexcept;
+
+private:
+    std::string _pattern;
+    _Kind _kind;
+
+    // unescaped literal runs between stars (first/last can be empty)
+    std::vector<std::string> _runs;
+
+    // total length of all the runs: minimum candidate length
+    Size _minLen = 0;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_GLOB_PATTERN_HPP
@@ -11,14 +11,18 @@
 
 #include "inspect-cmd-state.hpp"
 #include "msg.hpp"
+#include "data/data-len.hpp"
 
 namespace jacques {
 
 namespace bfs = boost::filesystem;
 
 InspectCmdState::InspectCmdState(const std::vector<bfs::path>& paths,
-                                 PktCheckpointsBuildListener& pktCheckpointsBuildListener) :
-    AppState {paths, pktCheckpointsBuildListener}
+                                 PktCheckpointsBuildListener& pktCheckpointsBuildListener,
+                                 PktBuildWaitFunc pktBuildWaitFunc) :
+    AppState {paths, pktCheckpointsBuildListener},
+    _pktBuildWaitFunc {std::move(pktBuildWaitFunc)},
+    _threadId {std::this_thread::get_id()}
 {
 }
 
@@ -36,6 +40,21 @@ void InspectCmdState::removeObserver(const Index id)
     _observers[id] = nullptr;
 }
 
+void InspectCmdState::buildDsFileIndexesInBackground(DsFileIndexWaitFunc waitFunc)
+{
+    assert(waitFunc);
+    assert(!_dsFileIndexBuilder);
+
+    std::vector<DsFile *> dsFiles;
+
+    for (auto& dsfState : this->dsFileStates()) {
+        dsFiles.push_back(&dsfState->dsFile());
+    }
+
+    _dsFileIndexWaitFunc = std::move(waitFunc);
+    _dsFileIndexBuilder = std::make_unique<DsFileIndexBuilder>(dsFiles);
+}
+
 void InspectCmdState::_notify(const Message msg)
 {
     for (const auto& observer : _observers) {
@@ -60,6 +79,45 @@ void InspectCmdState::_curOffsetInPktChanged()
     this->_notify(Message::CUR_OFFSET_IN_PKT_CHANGED);
 }
 
+Pkt& InspectCmdState::_pktAtIndex(DsFile& dsFile, const Index index,
+                                  PktCheckpointsBuildListener& pktCheckpointsBuildListener)
+{
+    // quick to create anyway (same threshold as the progress view)
+    const auto isSmall = dsFile.pktIndexEntry(index).effectiveTotalLen() < 2_MiB;
+
+    if (dsFile.hasPktAtIndex(index) || isSmall || !_pktBuildWaitFunc ||
+            std::this_thread::get_id() != _threadId) {
+        return AppState::_pktAtIndex(dsFile, index, pktCheckpointsBuildListener);
+    }
+
+    _pktBuildExecutor.start(dsFile.pktBuild(index));
+    _pktBuildWaitFunc(_pktBuildExecutor);
+
+    // throws PktBuildCanceled if canceled
+    auto build = _pktBuildExecutor.finish();
+
+    return dsFile.addPkt(std::move(build));
+}
+
+void InspectCmdState::_requireDsFileIndex(const Index index)
+{
+    if (!_dsFileIndexBuilder) {
+        AppState::_requireDsFileIndex(index);
+        return;
+    }
+
+    // the builder owns the data stream files until they're done
+    assert(std::this_thread::get_id() == _threadId);
+
+    if (!_dsFileIndexBuilder->isDone(index)) {
+        _dsFileIndexBuilder->prioritize(index);
+        _dsFileIndexWaitFunc(*_dsFileIndexBuilder, index);
+        assert(_dsFileIndexBuilder->isDone(index));
+    }
+
+    _dsFileIndexBuilder->rethrowError(index);
+}
+
 InspectCmdStateObserverGuard::InspectCmdStateObserverGuard(InspectCmdState& appState,
                                                            const InspectCmdState::Observer& observer) :
     _appState {&appState},
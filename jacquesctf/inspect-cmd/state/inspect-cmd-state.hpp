@@ -9,12 +9,16 @@
 #define _JACQUES_INSPECT_CMD_STATE_INSPECT_CMD_STATE_HPP
 
 #include <vector>
+#include <memory>
 #include <functional>
+#include <thread>
 #include <boost/filesystem.hpp>
 #include <boost/core/noncopyable.hpp>
 
 #include "msg.hpp"
 #include "inspect-common/app-state.hpp"
+#include "inspect-common/pkt-build-executor.hpp"
+#include "inspect-common/ds-file-index-builder.hpp"
 
 namespace jacques {
 
@@ -24,20 +28,71 @@ class InspectCmdState final :
 public:
     using Observer = std::function<void (Message)>;
 
+    /*
+     * Called while a packet build runs in the background: must return
+     * once `executor.isDone()` is true, possibly after calling
+     * `executor.cancel()`.
+     */
+    using PktBuildWaitFunc = std::function<void (PktBuildExecutor& executor)>;
+
+    /*
+     * Called while the index of the data stream file at index `index`
+     * builds in the background: must return once
+     * `builder.isDone(index)` is true, or throw DsFileIndexWaitCanceled
+     * to stop waiting (the build continues).
+     */
+    using DsFileIndexWaitFunc = std::function<void (const DsFileIndexBuilder& builder,
+                                                    Index index)>;
+
 public:
+    /*
+     * Large packets which the thread creating this state needs are
+     * created in the background while `pktBuildWaitFunc` waits for
+     * them. Navigating to such a packet throws PktBuildCanceled, the
+     * state remaining unchanged, if the build is canceled.
+     */
     explicit InspectCmdState(const std::vector<boost::filesystem::path>& paths,
-                             PktCheckpointsBuildListener& pktCheckpointsBuildListener);
+                             PktCheckpointsBuildListener& pktCheckpointsBuildListener,
+                             PktBuildWaitFunc pktBuildWaitFunc);
     Index addObserver(const Observer& observer);
     void removeObserver(Index id);
 
+    /*
+     * Starts building the indexes of all the data stream files in the
+     * background.
+     *
+     * Afterwards, requireDsFileIndex() makes the index of its data
+     * stream file the next one to build, if it's not being built yet,
+     * and waits for it with `waitFunc`. If `waitFunc` throws
+     * DsFileIndexWaitCanceled, the method which required the index
+     * throws it too, the state remaining unchanged.
+     */
+    void buildDsFileIndexesInBackground(DsFileIndexWaitFunc waitFunc);
+
+    // `nullptr` before buildDsFileIndexesInBackground()
+    const DsFileIndexBuilder *dsFileIndexBuilder() const noexcept
+    {
+        return _dsFileIndexBuilder.get();
+    }
+
 private:
     void _notify(Message msg);
     void _activeDsFileAndPktChanged() override;
     void _activePktChanged() override;
     void _curOffsetInPktChanged() override;
+    Pkt& _pktAtIndex(DsFile& dsFile, Index index,
+                     PktCheckpointsBuildListener& pktCheckpointsBuildListener) override;
+    void _requireDsFileIndex(Index index) override;
 
 private:
     std::vector<Observer> _observers;
+    const PktBuildWaitFunc _pktBuildWaitFunc;
+    PktBuildExecutor _pktBuildExecutor;
+    DsFileIndexWaitFunc _dsFileIndexWaitFunc;
+    std::unique_ptr<DsFileIndexBuilder> _dsFileIndexBuilder;
+
+    // the searches use this state from another thread
+    const std::thread::id _threadId;
 };
 
 class InspectCmdStateObserverGuard final
@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <chrono>
 #include <curses.h>
 #include <signal.h>
 #include <unistd.h>
@@ -15,6 +16,8 @@
 #include "inspect-cmd.hpp"
 #include "cfg.hpp"
 #include "../state/inspect-cmd-state.hpp"
+#include "inspect-common/pkt-build-executor.hpp"
+#include "inspect-common/ds-file-index-builder.hpp"
 #include "stylist.hpp"
 #include "screens/inspect-screen.hpp"
 #include "screens/help-screen.hpp"
@@ -22,6 +25,7 @@
 #include "screens/ds-files-screen.hpp"
 #include "screens/dts-screen.hpp"
 #include "screens/trace-info-screen.hpp"
+#include "screens/search-results-screen.hpp"
 #include "views/status-view.hpp"
 #include "views/pkt-index-build-progress-view.hpp"
 #include "views/pkt-checkpoints-build-progress-view.hpp"
@@ -127,25 +131,60 @@ void init()
     initScreen();
 }
 
-void buildIndexes(InspectCmdState& appState, const Stylist& stylist)
+// period of the data stream file index build progress view (ms)
+constexpr int dsFileIndexProgressDrawPeriodMs = 100;
+
+/*
+ * Shows, within `rect`, the progress of the background build of the
+ * index of the data stream file at index `index` until it's done.
+ *
+ * The user can stop waiting with Esc or `q`: this function then throws
+ * DsFileIndexWaitCanceled. Other keys are ignored, except that a
+ * terminal resize is handled afterwards.
+ */
+void waitDsFileIndex(const DsFileIndexBuilder& builder, const Index index, const Rect& rect,
+                     const Stylist& stylist)
 {
-    const auto screenRect = Rect {{0, 0}, static_cast<Size>(COLS), static_cast<Size>(LINES)};
-    const auto view = std::make_unique<PktIndexBuildProgressView>(screenRect, stylist);
-    auto func = [&view](const PktIndexEntry& entry) {
-        view->pktIndexEntry(entry);
-        view->refresh();
-        doupdate();
-    };
+    const auto view = std::make_unique<PktIndexBuildProgressView>(rect, stylist);
+    auto resized = false;
+    auto canceled = false;
 
     view->focus();
     view->isVisible(true);
     view->refresh(true);
+    view->dsFile(builder.dsFile(index));
+    view->refresh();
+    doupdate();
+    timeout(dsFileIndexProgressDrawPeriodMs);
+
+    while (!builder.isDone(index)) {
+        const auto ch = getch();
 
-    for (auto& dsfStateUp : appState.dsFileStates()) {
-        auto& dsf = dsfStateUp->dsFile();
+        if (ch == ERR) {
+            const auto progress = builder.progress(index);
 
-        view->dsFile(dsf);
-        dsf.buildIndex(func, 443);
+            if (progress.pktCount > 0) {
+                view->progress(progress.pktCount - 1, progress.offsetBytes, progress.seqNum);
+                view->refresh();
+                doupdate();
+            }
+        } else if (ch == 27 || ch == 'q') {
+            canceled = true;
+            break;
+        } else if (ch == KEY_RESIZE) {
+            resized = true;
+        }
+    }
+
+    timeout(-1);
+
+    if (resized) {
+        // handled by the main loop
+        ungetch(KEY_RESIZE);
+    }
+
+    if (canceled) {
+        throw DsFileIndexWaitCanceled {};
     }
 }
 
@@ -161,6 +200,16 @@ void showFullScreenMessage(const std::string& msg, const Stylist& stylist)
     doupdate();
 }
 
+// period of the packet build progress view (ms)
+constexpr int pktBuildProgressDrawPeriodMs = 100;
+
+/*
+ * Shows the progress of packet builds, whether they run on the thread
+ * which calls the listener methods or in the background (waitBuild()).
+ *
+ * The progress view is redrawn periodically, not for each event record:
+ * drawing is much slower than decoding.
+ */
 class PktCheckpointsBuildProgressUpdater final :
     public PktCheckpointsBuildListener
 {
@@ -171,6 +220,50 @@ public:
     {
     }
 
+    /*
+     * Shows the progress of the background build of `executor` until
+     * it's done.
+     *
+     * The user can cancel the build with Esc or `q`. Other keys are
+     * ignored, except that a terminal resize is handled after the build.
+     */
+    void waitBuild(PktBuildExecutor& executor)
+    {
+        this->_showView(executor.pktIndexEntry());
+
+        auto resized = false;
+
+        timeout(pktBuildProgressDrawPeriodMs);
+
+        while (!executor.isDone()) {
+            const auto ch = getch();
+
+            if (ch == ERR) {
+                const auto progress = executor.progress();
+
+                if (progress.erIndexInPkt) {
+                    _view->progress(*progress.erIndexInPkt, progress.erOffsetInPktBits,
+                                    progress.ert);
+                    _view->refresh();
+                    doupdate();
+                }
+            } else if (ch == 27 || ch == 'q') {
+                executor.cancel();
+            } else if (ch == KEY_RESIZE) {
+                resized = true;
+            }
+        }
+
+        timeout(-1);
+
+        if (resized) {
+            // handled by the main loop
+            ungetch(KEY_RESIZE);
+        }
+
+        this->_endBuild();
+    }
+
 private:
     void _startBuild(const DsFile&, const PktIndexEntry& pktIndexEntry) override
     {
@@ -179,15 +272,9 @@ private:
             return;
         }
 
-        const auto rect = Rect {{4, 4}, static_cast<Size>(COLS) - 8, 13};
-
-        _view = std::make_unique<PktCheckpointsBuildProgressView>(rect, *_stylist);
-        _view->focus();
-        _view->isVisible(true);
-        _view->pktIndexEntry(pktIndexEntry);
-        _view->refresh(true);
-        doupdate();
+        this->_showView(pktIndexEntry);
         _count = 0;
+        _lastDrawTime = std::chrono::steady_clock::now();
     }
 
     void _update(const Er& er) override
@@ -196,10 +283,18 @@ private:
             return;
         }
 
-        if (_count++ % 13 != 0) {
+        // don't read the clock for each event record either
+        if (_count++ % 64 != 0) {
             return;
         }
 
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - _lastDrawTime < std::chrono::milliseconds {pktBuildProgressDrawPeriodMs}) {
+            return;
+        }
+
+        _lastDrawTime = now;
         _view->er(er);
         _view->refresh();
         doupdate();
@@ -216,8 +311,21 @@ private:
         *_redrawCurScreen = true;
     }
 
+    void _showView(const PktIndexEntry& pktIndexEntry)
+    {
+        const auto rect = Rect {{4, 4}, static_cast<Size>(COLS) - 8, 13};
+
+        _view = std::make_unique<PktCheckpointsBuildProgressView>(rect, *_stylist);
+        _view->focus();
+        _view->isVisible(true);
+        _view->pktIndexEntry(pktIndexEntry);
+        _view->refresh(true);
+        doupdate();
+    }
+
 private:
     Index _count = 0;
+    std::chrono::steady_clock::time_point _lastDrawTime;
     std::unique_ptr<PktCheckpointsBuildProgressView> _view;
     const Stylist * const _stylist;
     bool * const _redrawCurScreen;
@@ -232,7 +340,10 @@ void startInteractive(const InspectCfg& cfg)
     Screen *curScreen = nullptr;
     bool redrawCurScreen = false;
     PktCheckpointsBuildProgressUpdater updater {*stylist, redrawCurScreen};
-    auto appState = std::make_unique<InspectCmdState>(cfg.paths(), updater);
+    auto appState = std::make_unique<InspectCmdState>(cfg.paths(), updater,
+                                                      [&updater](PktBuildExecutor& executor) {
+        updater.waitBuild(executor);
+    });
 
     if (appState->dsFileStates().empty()) {
         throw CmdError {"All data stream files to inspect are empty."};
@@ -244,9 +355,31 @@ void startInteractive(const InspectCfg& cfg)
      * At this point, the state isn't ready: data stream files have no
      * packet indexes, and there's no active packet built. This is
      * because we want to provide feedback to the user because it could
-     * be a long process. Build indexes first.
+     * be a long process.
+     *
+     * Build all the indexes in the background, but only wait for the
+     * one of the initial data stream file: the user interface can show
+     * it while the others build. The state waits for the index of any
+     * other data stream file which it needs before it's built.
      */
-    buildIndexes(*appState, *stylist);
+    appState->buildDsFileIndexesInBackground([&](const DsFileIndexBuilder& builder,
+                                                 const Index index) {
+        // full screen until there's a screen to return to
+        const auto rect = curScreen ?
+                          Rect {{4, 4}, static_cast<Size>(COLS) - 8, 11} :
+                          Rect {{0, 0}, static_cast<Size>(COLS), static_cast<Size>(LINES)};
+
+        // even if the user stops waiting
+        redrawCurScreen = true;
+        waitDsFileIndex(builder, index, rect, *stylist);
+    });
+
+    try {
+        appState->requireDsFileIndex(0);
+    } catch (const DsFileIndexWaitCanceled&) {
+        // nothing to show yet: quit
+        return;
+    }
 
     /*
      * Show this message because some views created by the screens below
@@ -267,6 +400,8 @@ void startInteractive(const InspectCfg& cfg)
     const auto dtsScreen = std::make_unique<DtsScreen>(screenRect, cfg, *stylist, *appState);
     const auto traceInfoScreen = std::make_unique<TraceInfoScreen>(screenRect, cfg, *stylist,
                                                                    *appState);
+    const auto searchResultsScreen = std::make_unique<SearchResultsScreen>(screenRect, cfg,
+                                                                           *stylist, *appState);
     const std::vector<Screen *> screens {
         inspectScreen.get(),
         pktsScreen.get(),
@@ -274,13 +409,18 @@ void startInteractive(const InspectCfg& cfg)
         helpScreen.get(),
         dtsScreen.get(),
         traceInfoScreen.get(),
+        searchResultsScreen.get(),
     };
 
     // goto first packet if available: this creates it and shows the progress
     showFullScreenMessage("Selecting initial packet...", *stylist);
 
     if (appState->activeDsFileState().dsFile().pktCount() > 0) {
-        appState->gotoPkt(0);
+        try {
+            appState->gotoPkt(0);
+        } catch (const PktBuildCanceled&) {
+            // no active packet: the user can choose another one
+        }
     }
 
     // draw status
@@ -308,7 +448,20 @@ void startInteractive(const InspectCfg& cfg)
     auto wantsToQuit = false;
 
     while (!done) {
+        // a screen can show the progress of some background work
+        timeout(curScreen->needsPeriodicUpdate() ? 250 : -1);
+
         const auto ch = getch();
+
+        // other views read user keys with a blocking getch() too
+        timeout(-1);
+
+        if (ch == ERR) {
+            curScreen->update();
+            doupdate();
+            continue;
+        }
+
         auto refreshStatus = true;
 
         if (wantsToQuit) {
@@ -404,11 +557,38 @@ void startInteractive(const InspectCfg& cfg)
                 break;
             }
 
+            try {
+                // before switching: the user can stop waiting
+                appState->requireTraceDsFileIndexes(appState->trace());
+            } catch (const DsFileIndexWaitCanceled&) {
+                break;
+            }
+
             curScreen->isVisible(false);
             curScreen = traceInfoScreen.get();
             curScreen->isVisible(true);
             break;
 
+        case 'F':
+            try {
+                if (curScreen == searchResultsScreen.get()) {
+                    searchResultsScreen->startSearch();
+                    break;
+                }
+
+                curScreen->isVisible(false);
+                curScreen = searchResultsScreen.get();
+                curScreen->isVisible(true);
+
+                if (!searchResultsScreen->hasSearch()) {
+                    searchResultsScreen->startSearch();
+                }
+            } catch (const DsFileIndexWaitCanceled&) {
+                // the search didn't start
+            }
+
+            break;
+
         case 'h':
         case 'H':
         case '?':
@@ -447,7 +627,17 @@ void startInteractive(const InspectCfg& cfg)
             break;
 
         default:
-            const auto reaction = curScreen->handleKey(ch);
+            auto reaction = KeyHandlingReaction::CONTINUE;
+
+            try {
+                reaction = curScreen->handleKey(ch);
+            } catch (const PktBuildCanceled&) {
+                // the state didn't change
+                redrawCurScreen = true;
+            } catch (const DsFileIndexWaitCanceled&) {
+                // the state didn't change
+                redrawCurScreen = true;
+            }
 
             switch (reaction) {
             case KeyHandlingReaction::RETURN_TO_INSPECT:
@@ -54,6 +54,23 @@ void DsFilesScreen::_visibilityChanged()
     }
 }
 
+bool DsFilesScreen::_needsPeriodicUpdate() const
+{
+    // one last update once all the indexes are built to show everything
+    return !_isIndexingDoneShown;
+}
+
+void DsFilesScreen::_update()
+{
+    const auto builder = this->_appState().dsFileIndexBuilder();
+
+    if (!builder || builder->isAllDone()) {
+        _isIndexingDoneShown = true;
+    }
+
+    _view->update();
+}
+
 KeyHandlingReaction DsFilesScreen::_handleKey(const int key)
 {
     switch (key) {
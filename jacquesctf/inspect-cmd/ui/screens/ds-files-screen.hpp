@@ -29,11 +29,14 @@ private:
     void _resized() override;
     KeyHandlingReaction _handleKey(int key) override;
     void _visibilityChanged() override;
+    bool _needsPeriodicUpdate() const override;
+    void _update() override;
 
 private:
     std::unique_ptr<DsFileTableView> _view;
     CycleWheel<TsFmtMode> _tsFmtModeWheel;
     CycleWheel<utils::LenFmtMode> _dataLenFmtModeWheel;
+    bool _isIndexingDoneShown = false;
 };
 
 } // namespace jacques
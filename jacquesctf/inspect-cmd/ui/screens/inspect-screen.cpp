@@ -331,13 +331,18 @@ void InspectScreen::_setLastOffsetInRowBits()
     }
 }
 
-void InspectScreen::_search(const SearchQuery& query, const bool animate)
+void InspectScreen::_search(const SearchQuery& query, const bool animate,
+                            IncrErtSearch * const incrErtSearch)
 {
-    if (dynamic_cast<const ErtNameSearchQuery *>(&query) ||
-            dynamic_cast<const ErtIdSearchQuery *>(&query)) {
+    if (IncrErtSearch::isSupportedQuery(query)) {
         std::atomic_bool stop {false};
-        std::thread t {[this, &stop, &query] {
-            this->_appState().search(query);
+        std::thread t {[this, &stop, &query, incrErtSearch] {
+            if (incrErtSearch) {
+                incrErtSearch->search(query);
+            } else {
+                this->_appState().search(query);
+            }
+
             stop = true;
         }};
 
@@ -614,16 +619,23 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
         }();
 
         std::unique_ptr<const SearchQuery> query;
+        std::unique_ptr<IncrErtSearch> incrErtSearch;
 
         if (key == 'G') {
             const auto snapshot = this->_takeStateSnapshot();
-            const auto liveUpdateFunc = [this, snapshot](const auto& query) {
+
+            incrErtSearch = std::make_unique<IncrErtSearch>(this->_appState().activeDsFileState());
+
+            const auto liveUpdateFunc = [this, snapshot, &incrErtSearch](const auto& query,
+                                                                         const auto& isCanceledFunc) {
                 // start from initial state
                 this->_restoreStateSnapshot(snapshot);
 
-                if (!dynamic_cast<const ErtNameSearchQuery *>(&query) &&
-                        !dynamic_cast<const ErtIdSearchQuery *>(&query)) {
-                    // this makes the appropriate views update and redraw
+                // this makes the appropriate views update and redraw
+                if (IncrErtSearch::isSupportedQuery(query)) {
+                    // reuses the results of the previous live updates
+                    incrErtSearch->search(query, isCanceledFunc);
+                } else {
                     this->_appState().search(query);
                 }
 
@@ -646,7 +658,7 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
             break;
         }
 
-        this->_search(*query);
+        this->_search(*query, true, incrErtSearch.get());
 
         /*
          * If we didn't move, the state snapshot will be identical and
@@ -660,6 +672,38 @@ KeyHandlingReaction InspectScreen::_handleKey(const int key)
         break;
     }
 
+    case 'T':
+    {
+        const auto query = _searchCtrl.start("*");
+        const auto tsQuery = dynamic_cast<const TimestampSearchQuery *>(query.get());
+
+        if (!tsQuery || tsQuery->unit() != TimestampSearchQuery::Unit::NS) {
+            // canceled, invalid, or not a timestamp (ns from origin)
+            this->_redraw();
+            break;
+        }
+
+        auto nsFromOrigin = tsQuery->val();
+
+        if (tsQuery->isDiff()) {
+            const auto curEr = this->_appState().curEr();
+
+            if (!curEr || !curEr->ts()) {
+                this->_redraw();
+                break;
+            }
+
+            nsFromOrigin += curEr->ts()->nsFromOrigin();
+        }
+
+        // move all the data stream files to this time
+        this->_appState().gotoNsFromOriginInAllDsFiles(nsFromOrigin);
+        this->_snapshotState();
+        this->_redraw();
+        this->_tryShowDecodingError();
+        break;
+    }
+
     case 'n':
         if (!_lastQuery) {
             break;
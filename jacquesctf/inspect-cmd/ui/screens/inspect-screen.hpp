@@ -22,6 +22,7 @@
 #include "screen.hpp"
 #include "../cycle-wheel.hpp"
 #include "../search-ctrl.hpp"
+#include "inspect-common/incr-ert-search.hpp"
 
 namespace jacques {
 
@@ -87,7 +88,8 @@ private:
     void _gotoBookmark(unsigned int id);
     void _refreshViews();
     void _setLastOffsetInRowBits();
-    void _search(const SearchQuery& query, bool animate = true);
+    void _search(const SearchQuery& query, bool animate = true,
+                 IncrErtSearch *incrErtSearch = nullptr);
 
 private:
     std::unique_ptr<ErTableView> _ertView;
@@ -22,4 +22,13 @@ void Screen::_visibilityChanged()
 {
 }
 
+bool Screen::_needsPeriodicUpdate() const
+{
+    return false;
+}
+
+void Screen::_update()
+{
+}
+
 } // namespace jacques
@@ -102,6 +102,24 @@ public:
         return this->_handleKey(key);
     }
 
+    /*
+     * Returns whether or not the screen needs update() to be called
+     * periodically, even without any user key (for example, to show the
+     * progress of some background work).
+     */
+    bool needsPeriodicUpdate() const
+    {
+        return this->_needsPeriodicUpdate();
+    }
+
+    /*
+     * Updates the screen without any user key.
+     */
+    void update()
+    {
+        this->_update();
+    }
+
     const Rect& rect() const noexcept
     {
         return _curRect;
@@ -140,6 +158,19 @@ protected:
      */
     virtual void _visibilityChanged();
 
+    /*
+     * Implementation returns whether or not _update() needs to be
+     * called periodically. The default implementation returns false.
+     */
+    virtual bool _needsPeriodicUpdate() const;
+
+    /*
+     * Called periodically when _needsPeriodicUpdate() returns true.
+     * Implementation can update its views. The default implementation
+     * does nothing.
+     */
+    virtual void _update();
+
     const InspectCfg& _config() const noexcept
     {
         return *_curCfg;
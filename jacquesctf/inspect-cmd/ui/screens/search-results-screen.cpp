@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <curses.h>
+
+#include "cfg.hpp"
+#include "search-results-screen.hpp"
+#include "../stylist.hpp"
+
+namespace jacques {
+
+SearchResultsScreen::SearchResultsScreen(const Rect& rect, const InspectCfg& cfg,
+                                         const Stylist& stylist, InspectCmdState& appState) :
+    Screen {rect, cfg, stylist, appState},
+    _view {std::make_unique<SearchResultTableView>(rect, stylist, appState)},
+    _searchCtrl {*this, stylist},
+    _dataLenFmtModeWheel {
+        utils::LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS,
+        utils::LenFmtMode::BYTES_FLOOR_WITH_EXTRA_BITS,
+        utils::LenFmtMode::BITS,
+    }
+{
+    _view->focus();
+}
+
+void SearchResultsScreen::_redraw()
+{
+    _view->redraw();
+}
+
+void SearchResultsScreen::_resized()
+{
+    _view->moveAndResize(this->rect());
+    _searchCtrl.parentScreenResized(*this);
+}
+
+void SearchResultsScreen::_visibilityChanged()
+{
+    _view->isVisible(this->isVisible());
+
+    if (this->isVisible()) {
+        _view->update();
+        _view->redraw();
+    }
+}
+
+bool SearchResultsScreen::_needsPeriodicUpdate() const
+{
+    // one last update once the search is done to show everything
+    return !_isSearchDoneShown;
+}
+
+void SearchResultsScreen::_update()
+{
+    if (_search && _search->isDone()) {
+        _search->rethrowError();
+        _isSearchDoneShown = true;
+    }
+
+    _view->update();
+}
+
+void SearchResultsScreen::startSearch()
+{
+    const auto query = _searchCtrl.start("*");
+
+    if (!query || !IncrErtSearch::isSupportedQuery(*query)) {
+        // canceled, invalid, or not an event record type name/ID
+        _view->redraw();
+        return;
+    }
+
+    // the search scans all the data stream files
+    this->_appState().requireAllDsFileIndexes();
+
+    // the view must not refer to the previous search anymore
+    _view->search(nullptr);
+    _search = nullptr;
+    _search = std::make_unique<FindAllSearch>(this->_appState(), *query);
+    _isSearchDoneShown = false;
+    _view->search(_search.get());
+}
+
+KeyHandlingReaction SearchResultsScreen::_handleKey(const int key)
+{
+    switch (key) {
+    case KEY_UP:
+        _view->prev();
+        break;
+
+    case KEY_DOWN:
+        _view->next();
+        break;
+
+    case KEY_PPAGE:
+        _view->pageUp();
+        break;
+
+    case KEY_NPAGE:
+        _view->pageDown();
+        break;
+
+    case KEY_END:
+        // also shows the latest results
+        _view->update();
+        _view->selectLast();
+        break;
+
+    case KEY_HOME:
+        _view->selectFirst();
+        break;
+
+    case 'c':
+        _view->centerSelRow();
+        break;
+
+    case 's':
+        _dataLenFmtModeWheel.next();
+        _view->dataLenFmtMode(_dataLenFmtModeWheel.curVal());
+        break;
+
+    case '/':
+        this->startSearch();
+        break;
+
+    case '\n':
+    case '\r':
+    {
+        const auto result = _view->selResult();
+
+        if (!result) {
+            break;
+        }
+
+        this->_appState().gotoDsFile(result->dsFileIndex);
+        this->_appState().activeDsFileState().gotoEr({
+            result->pktIndexInDsFile, result->erIndexInPkt
+        });
+        return KeyHandlingReaction::RETURN_TO_INSPECT;
+    }
+
+    default:
+        break;
+    }
+
+    _view->refresh();
+    return KeyHandlingReaction::CONTINUE;
+}
+
+} // namespace jacques
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_INSPECT_COMMAND_UI_SCREENS_SEARCH_RESULTS_SCREEN_HPP
+#define _JACQUES_INSPECT_COMMAND_UI_SCREENS_SEARCH_RESULTS_SCREEN_HPP
+
+#include "aliases.hpp"
+#include "../stylist.hpp"
+#include "../views/search-result-table-view.hpp"
+#include "../search-ctrl.hpp"
+#include "screen.hpp"
+#include "../cycle-wheel.hpp"
+#include "inspect-common/find-all-search.hpp"
+#include "data/data-len.hpp"
+
+namespace jacques {
+
+class SearchResultsScreen final :
+    public Screen
+{
+public:
+    explicit SearchResultsScreen(const Rect& rect, const InspectCfg& cfg, const Stylist& stylist,
+                                 InspectCmdState& appState);
+
+    /*
+     * Asks the user for an event record type name or ID search query
+     * and starts a new "find all" search, replacing the current one, if
+     * the query is valid.
+     *
+     * Throws DsFileIndexWaitCanceled, keeping the current search, if
+     * the user stops waiting for the data stream file indexes.
+     */
+    void startSearch();
+
+    bool hasSearch() const noexcept
+    {
+        return static_cast<bool>(_search);
+    }
+
+private:
+    void _redraw() override;
+    void _resized() override;
+    KeyHandlingReaction _handleKey(int key) override;
+    void _visibilityChanged() override;
+    bool _needsPeriodicUpdate() const override;
+    void _update() override;
+
+private:
+    std::unique_ptr<SearchResultTableView> _view;
+    SearchCtrl _searchCtrl;
+    std::unique_ptr<FindAllSearch> _search;
+    bool _isSearchDoneShown = true;
+    CycleWheel<utils::LenFmtMode> _dataLenFmtModeWheel;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_INSPECT_COMMAND_UI_SCREENS_SEARCH_RESULTS_SCREEN_HPP
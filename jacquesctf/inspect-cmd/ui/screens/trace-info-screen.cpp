@@ -44,6 +44,18 @@ void TraceInfoScreen::_visibilityChanged()
     }
 }
 
+void TraceInfoScreen::_requireDsFileTraceIndexes(const int step)
+{
+    const auto index = static_cast<long long>(this->_appState().activeDsFileStateIndex()) + step;
+
+    if (index < 0 || index >= static_cast<long long>(this->_appState().dsFileStateCount())) {
+        return;
+    }
+
+    // the view shows the trace of the new active data stream file
+    this->_appState().requireTraceDsFileIndexes(this->_appState().dsFileState(index).trace());
+}
+
 KeyHandlingReaction TraceInfoScreen::_handleKey(const int key)
 {
     switch (key) {
@@ -63,10 +75,12 @@ KeyHandlingReaction TraceInfoScreen::_handleKey(const int key)
         break;
 
     case KEY_F(3):
+        this->_requireDsFileTraceIndexes(-1);
         this->_appState().gotoPrevDsFile();
         break;
 
     case KEY_F(4):
+        this->_requireDsFileTraceIndexes(1);
         this->_appState().gotoNextDsFile();
         break;
 
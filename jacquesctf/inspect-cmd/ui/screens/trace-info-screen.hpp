@@ -28,6 +28,12 @@ private:
     KeyHandlingReaction _handleKey(int key) override;
     void _visibilityChanged() override;
 
+    /*
+     * Requires the indexes of the trace of the data stream file which
+     * is `step` data stream files away from the active one, if any.
+     */
+    void _requireDsFileTraceIndexes(int step);
+
 private:
     std::unique_ptr<TraceInfoView> _view;
 };
@@ -9,6 +9,8 @@
 #include <chrono>
 #include <thread>
 #include <curses.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include "search-ctrl.hpp"
 #include "inspect-common/search-query.hpp"
@@ -26,6 +28,8 @@ std::unique_ptr<const SearchQuery> SearchCtrl::startLive(const std::string& init
     const auto lineLen = _searchView->contentRect().w - 2;
     std::string buf = init;
 
+    _parsedQueries.clear();
+
     _searchView->redraw();
     _searchView->isVisible(true);
 
@@ -81,6 +85,7 @@ std::unique_ptr<const SearchQuery> SearchCtrl::startLive(const std::string& init
 
     _searchView->isVisible(false);
     curs_set(prevCurs);
+    _parsedQueries.clear();
 
     if (!accepted || buf.empty()) {
         return nullptr;
@@ -117,15 +122,53 @@ void SearchCtrl::animate(std::atomic_bool& stop) const
     _searchView->isVisible(false);
 }
 
+namespace {
+
+/*
+ * Returns whether or not the user pressed a key which we didn't read
+ * yet.
+ */
+bool hasPendingInput()
+{
+    pollfd pfd {STDIN_FILENO, POLLIN, 0};
+
+    return poll(&pfd, 1, 0) > 0;
+}
+
+} // namespace
+
+const SearchQuery *SearchCtrl::_parseQuery(const std::string& buf)
+{
+    auto it = _parsedQueries.find(buf);
+
+    if (it == _parsedQueries.end()) {
+        it = _parsedQueries.insert(std::make_pair(buf, parseSearchQuery(buf))).first;
+    }
+
+    return it->second.get();
+}
+
 void SearchCtrl::_tryLiveUpdate(const std::string& buf, const LiveUpdateFunc& liveUpdateFunc)
 {
-    const auto query = parseSearchQuery(buf);
+    const auto query = this->_parseQuery(buf);
     const auto startX = _searchView->rect().pos.x + 1;
     const auto startY = _searchView->rect().pos.y + 1;
 
+    // show the input immediately: the live update could take a while
+    _searchView->drawCurText(buf);
+    move(startY, startX + buf.size());
+    _searchView->refresh();
+    doupdate();
+
     if (query) {
         curs_set(0);
-        liveUpdateFunc(*query);
+
+        /*
+         * The live update function checks this periodically: as soon
+         * as the user types another key, this live update is stale and
+         * the next one will take over.
+         */
+        liveUpdateFunc(*query, hasPendingInput);
     }
 
     _searchView->redraw(true);
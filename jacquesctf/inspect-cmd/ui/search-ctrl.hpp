@@ -10,6 +10,8 @@
 
 #include <memory>
 #include <atomic>
+#include <string>
+#include <unordered_map>
 
 #include "views/search-input-view.hpp"
 #include "screens/screen.hpp"
@@ -20,7 +22,14 @@ namespace jacques {
 class SearchCtrl final
 {
 public:
-    using LiveUpdateFunc = std::function<void (const SearchQuery&)>;
+    /*
+     * Returns whether or not the current live update is stale (the
+     * user typed something else since it started) and should stop as
+     * soon as possible.
+     */
+    using IsCanceledFunc = std::function<bool ()>;
+
+    using LiveUpdateFunc = std::function<void (const SearchQuery&, const IsCanceledFunc&)>;
 
 public:
     explicit SearchCtrl(const Screen& parentScreen, const Stylist& stylist);
@@ -33,7 +42,7 @@ public:
 
     std::unique_ptr<const SearchQuery> start(const std::string& init)
     {
-        return this->startLive(init, [](const auto&) {});
+        return this->startLive(init, [](const auto&, const auto&) {});
     }
 
     std::unique_ptr<const SearchQuery> start()
@@ -43,6 +52,7 @@ public:
 
 private:
     void _tryLiveUpdate(const std::string& buf, const LiveUpdateFunc& liveUpdateFunc);
+    const SearchQuery *_parseQuery(const std::string& buf);
 
     static Rect _viewRect(const Screen& parentScreen) noexcept
     {
@@ -53,6 +63,9 @@ private:
 
 private:
     std::unique_ptr<SearchInputView> _searchView;
+
+    // parsed queries of the current live search (input -> query)
+    std::unordered_map<std::string, std::unique_ptr<const SearchQuery>> _parsedQueries;
 };
 
 } // namespace jacques
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <numeric>
+#include <string>
 
 #include "ds-file-table-view.hpp"
 #include "../../state/msg.hpp"
@@ -98,12 +99,53 @@ void DsFileTableView::_resetRow(const std::vector<TableViewColumnDescr>& descrs)
     if (descrs.size() >= 8) {
         _row.push_back(std::make_unique<UIntTableViewCell>(TableViewCell::TextAlign::RIGHT));
     }
+
+    _indexingRow.clear();
+    _indexingRow.push_back(std::make_unique<PathTableViewCell>());
+    _indexingRow[0]->emphasized(true);
+    _indexingRow.push_back(std::make_unique<DataLenTableViewCell>(_dataLenFmtMode));
+    _indexingRow.push_back(std::make_unique<UIntTableViewCell>(TableViewCell::TextAlign::RIGHT));
+    static_cast<UIntTableViewCell&>(*_indexingRow.back()).sep(true);
+    _indexingRow.push_back(std::make_unique<TextTableViewCell>(TableViewCell::TextAlign::LEFT));
+
+    while (_indexingRow.size() < _row.size()) {
+        _indexingRow.push_back(std::make_unique<TextTableViewCell>(TableViewCell::TextAlign::LEFT));
+        _indexingRow.back()->na(true);
+    }
+}
+
+void DsFileTableView::_drawIndexingRow(const Index row, const DsFileIndexBuilder& builder)
+{
+    const auto& dsf = builder.dsFile(row);
+    const auto progress = builder.progress(row);
+    Index percent = 0;
+
+    if (dsf.fileLen().bytes() > 0) {
+        percent = progress.offsetBytes * 100 / dsf.fileLen().bytes();
+    }
+
+    static_cast<PathTableViewCell&>(*_indexingRow[0]).path(dsf.path());
+    static_cast<DataLenTableViewCell&>(*_indexingRow[1]).len(dsf.fileLen());
+
+    // packets so far
+    static_cast<UIntTableViewCell&>(*_indexingRow[2]).val(progress.pktCount);
+    static_cast<TextTableViewCell&>(*_indexingRow[3]).text("Indexing: " +
+                                                           std::to_string(percent) + " %");
+    this->_drawCells(row, _indexingRow);
 }
 
 void DsFileTableView::_drawRow(const Index row)
 {
     assert(row < _appState->dsFileStateCount());
 
+    const auto builder = _appState->dsFileIndexBuilder();
+
+    if (builder && !builder->isDone(row)) {
+        // the data stream file belongs to the builder until then
+        this->_drawIndexingRow(row, *builder);
+        return;
+    }
+
     const auto& dsf = _appState->dsFileState(row).dsFile();
 
     static_cast<PathTableViewCell&>(*_row[0]).path(dsf.path());
@@ -211,10 +253,17 @@ void DsFileTableView::tsFmtMode(const TsFmtMode tsFmtMode)
 void DsFileTableView::dataLenFmtMode(const utils::LenFmtMode dataLenFmtMode)
 {
     static_cast<DataLenTableViewCell&>(*_row[1]).fmtMode(dataLenFmtMode);
+    static_cast<DataLenTableViewCell&>(*_indexingRow[1]).fmtMode(dataLenFmtMode);
     _dataLenFmtMode = dataLenFmtMode;
     this->_redrawRows();
 }
 
+void DsFileTableView::update()
+{
+    this->_redrawRows();
+    this->refresh();
+}
+
 Index DsFileTableView::selDsFileIndex() const
 {
     return this->_selRow();
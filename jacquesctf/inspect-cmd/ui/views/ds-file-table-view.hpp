@@ -24,6 +24,9 @@ public:
     void tsFmtMode(TsFmtMode tsFmtMode);
     void dataLenFmtMode(utils::LenFmtMode dataLenFmtMode);
 
+    // redraws the rows of the data stream files being indexed
+    void update();
+
 private:
     void _drawRow(Index index) override;
     Size _rowCount() override;
@@ -31,9 +34,14 @@ private:
     void _appStateChanged(Message msg) override;
     void _setColumnDescrs();
     void _resetRow(const std::vector<TableViewColumnDescr>& descrs);
+    void _drawIndexingRow(Index row, const DsFileIndexBuilder& builder);
 
 private:
     std::vector<std::unique_ptr<TableViewCell>> _row;
+
+    // row of a data stream file of which the index isn't built yet
+    std::vector<std::unique_ptr<TableViewCell>> _indexingRow;
+
     InspectCmdState *_appState;
     ViewInspectCmdStateObserverGuard _appStateObserverGuard;
     TsFmtMode _tsFmtMode = TsFmtMode::LONG;
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "ert-table-view.hpp"
+#include "glob-pattern.hpp"
 #include "utils.hpp"
 
 namespace jacques {
@@ -141,6 +142,7 @@ void ErtTableView::selectErt(const std::string& pattern, const bool relative)
         return;
     }
 
+    const GlobPattern globPattern {pattern};
     Index startIndex = 0;
 
     if (relative) {
@@ -154,7 +156,7 @@ void ErtTableView::selectErt(const std::string& pattern, const bool relative)
     for (Index index = startIndex; index < _erts->size(); ++index) {
         auto& ert = (*_erts)[index];
 
-        if (ert->name() && utils::globMatch(pattern, *ert->name())) {
+        if (ert->name() && globPattern.matches(*ert->name())) {
             this->_selRowAndDraw(index);
             return;
         }
@@ -163,7 +165,7 @@ void ErtTableView::selectErt(const std::string& pattern, const bool relative)
     for (Index index = 0; index < startIndex; ++index) {
         auto& ert = (*_erts)[index];
 
-        if (ert->name() && utils::globMatch(pattern, *ert->name())) {
+        if (ert->name() && globPattern.matches(*ert->name())) {
             this->_selRowAndDraw(index);
             return;
         }
@@ -42,8 +42,11 @@ void HelpView::_buildRows()
         _KeyRow {"p", "Go to \"Packets\" screen"},
         _KeyRow {"d", "Go to \"Data types\" screen"},
         _KeyRow {"i", "Go to \"Trace info\" screen"},
+        _KeyRow {"F", "Go to \"Search results\" screen (find all event records of a type)"},
         _KeyRow {"h, H, ?", "Go to \"Help\" screen"},
         _KeyRow {"q, Esc", "Quit current screen or go to \"Packet inspection\" screen"},
+        _KeyRow {"q, Esc", "While creating a large packet: cancel"},
+        _KeyRow {"q, Esc", "While indexing a data stream file: stop waiting"},
         _KeyRow {"r, Ctrl+l", "Hard refresh screen"},
         _KeyRow {"F10, Q", "Quit program"},
         _EmptyRow {},
@@ -102,6 +105,7 @@ void HelpView::_buildRows()
         _KeyRow {"$", "Go to offset within packet (bytes)"},
         _KeyRow {"N, *", "Go to event record with timestamp (ns from origin)"},
         _KeyRow {"k", "Go to event record with timestamp (cycles)"},
+        _KeyRow {"T", "Go to timestamp (ns from origin) in all data stream files"},
         _KeyRow {"n", "Repeat previous search"},
         _EmptyRow {},
         _SectionRow {"\"Data stream files\" screen keys"},
@@ -156,6 +160,26 @@ void HelpView::_buildRows()
         _KeyRow {"Enter", "Accept selection and return to \"Packet inspection\" screen"},
         _KeyRow {"q", "Discard selection and return to \"Packet inspection\" screen"},
         _EmptyRow {},
+        _SectionRow {"\"Search results\" screen keys"},
+        _SubSectionRow {"Presentation"},
+        _KeyRow {"s", "Cycle format of length columns"},
+        _KeyRow {"c", "Center selected row"},
+        _EmptyRow {},
+        _SubSectionRow {"Navigation"},
+        _KeyRow {"Up", "Select previous row"},
+        _KeyRow {"Down", "Select next row"},
+        _KeyRow {"Pg up", "Jump to previous page"},
+        _KeyRow {"Pg down", "Jump to next page"},
+        _KeyRow {"Home", "Select first row"},
+        _KeyRow {"End", "Select last row"},
+        _EmptyRow {},
+        _SubSectionRow {"Search"},
+        _KeyRow {"/, F", "Find all event records of a type (name or ID, see syntax below)"},
+        _EmptyRow {},
+        _SubSectionRow {"Action"},
+        _KeyRow {"Enter", "Go to selected event record in \"Packet inspection\" screen"},
+        _KeyRow {"q", "Return to \"Packet inspection\" screen"},
+        _EmptyRow {},
         _SectionRow {"\"Data types\" screen keys"},
         _SubSectionRow {"Presentation"},
         _KeyRow {"c", "Center selected table row"},
@@ -35,13 +35,24 @@ void PktCheckpointsBuildProgressView::_clearRow(const Index contentY)
 void PktCheckpointsBuildProgressView::pktIndexEntry(const PktIndexEntry& pktIndexEntry)
 {
     _pktIndexEntry = &pktIndexEntry;
-    _er = nullptr;
+    _erIndexInPkt = boost::none;
+    _erOffsetInPktBits = 0;
+    _ert = nullptr;
     this->_redrawContent();
 }
 
 void PktCheckpointsBuildProgressView::er(const Er& er)
 {
-    _er = &er;
+    this->progress(er.indexInPkt(), er.segment().offsetInPktBits(), er.type());
+}
+
+void PktCheckpointsBuildProgressView::progress(const Index erIndexInPkt,
+                                               const Index erOffsetInPktBits,
+                                               const yactfr::EventRecordType * const ert)
+{
+    _erIndexInPkt = erIndexInPkt;
+    _erOffsetInPktBits = erOffsetInPktBits;
+    _ert = ert;
     this->_drawProgress();
 }
 
@@ -58,7 +69,7 @@ void PktCheckpointsBuildProgressView::_drawPktIndexEntry()
 
 void PktCheckpointsBuildProgressView::_drawProgress()
 {
-    if (!_pktIndexEntry || !_er) {
+    if (!_pktIndexEntry || !_erIndexInPkt) {
         return;
     }
 
@@ -75,7 +86,7 @@ void PktCheckpointsBuildProgressView::_drawProgress()
     this->_clearRow(barY);
 
     const auto barW = this->contentRect().w - 2;
-    const auto fBarProgW = (static_cast<double>(_er->segment().offsetInPktBits()) /
+    const auto fBarProgW = (static_cast<double>(_erOffsetInPktBits) /
                             static_cast<double>(_pktIndexEntry->effectiveContentLen().bits())) *
                            static_cast<double>(barW);
     const auto barProgW = static_cast<Index>(fBarProgW);
@@ -99,7 +110,7 @@ void PktCheckpointsBuildProgressView::_drawProgress()
     this->_moveAndPrint({titleX, indexY}, "Index:");
     this->_stylist().std(*this, true);
     this->_moveAndPrint({infoX, indexY}, "%s",
-                        utils::sepNumber(static_cast<long long>(_er->indexInPkt()), ',').c_str());
+                        utils::sepNumber(static_cast<long long>(*_erIndexInPkt), ',').c_str());
 
     // offset
     this->_clearRow(offsetInPktBitsY);
@@ -107,7 +118,7 @@ void PktCheckpointsBuildProgressView::_drawProgress()
     this->_moveAndPrint({titleX, offsetInPktBitsY}, "Offset:");
     this->_stylist().std(*this, true);
 
-    auto lenUnit = utils::formatLen(_er->segment().offsetInPktBits(),
+    auto lenUnit = utils::formatLen(_erOffsetInPktBits,
                                     utils::LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS, ',');
 
     this->_moveAndPrint({infoX, offsetInPktBitsY}, "%s %s", lenUnit.first.c_str(),
@@ -126,24 +137,22 @@ void PktCheckpointsBuildProgressView::_drawProgress()
     this->_clearRow(ertNameY);
     this->_clearRow(ertIdY);
 
-    const auto ert = _er->type();
-
-    if (!ert) {
+    if (!_ert) {
         return;
     }
 
-    if (ert->name()) {
+    if (_ert->name()) {
         this->_stylist().std(*this);
         this->_moveAndPrint({titleX, ertNameY}, "ERT name:");
         this->_stylist().std(*this, true);
-        this->_moveAndPrint({infoX, ertNameY}, "%s", utils::escapeStr(*ert->name()).c_str());
+        this->_moveAndPrint({infoX, ertNameY}, "%s", utils::escapeStr(*_ert->name()).c_str());
     }
 
     // ERT ID
     this->_stylist().std(*this);
     this->_moveAndPrint({titleX, ertIdY}, "ERT ID:");
     this->_stylist().std(*this, true);
-    this->_moveAndPrint({infoX, ertIdY}, "%llu", ert->id());
+    this->_moveAndPrint({infoX, ertIdY}, "%llu", _ert->id());
 }
 
 void PktCheckpointsBuildProgressView::_redrawContent()
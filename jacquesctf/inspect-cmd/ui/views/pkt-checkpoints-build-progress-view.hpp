@@ -8,6 +8,9 @@
 #ifndef _JACQUES_INSPECT_CMD_UI_VIEWS_PKT_CHECKPOINTS_BUILD_PROGRESS_VIEW_HPP
 #define _JACQUES_INSPECT_CMD_UI_VIEWS_PKT_CHECKPOINTS_BUILD_PROGRESS_VIEW_HPP
 
+#include <boost/optional.hpp>
+#include <yactfr/yactfr.hpp>
+
 #include "view.hpp"
 #include "data/pkt-index-entry.hpp"
 #include "data/er.hpp"
@@ -22,6 +25,14 @@ public:
     void pktIndexEntry(const PktIndexEntry& entry);
     void er(const Er& er);
 
+    /*
+     * Shows the progress up to the event record at index `erIndexInPkt`
+     * and at offset `erOffsetInPktBits`, having the type `ert` (may be
+     * `nullptr`).
+     */
+    void progress(Index erIndexInPkt, Index erOffsetInPktBits,
+                  const yactfr::EventRecordType *ert);
+
 protected:
     void _resized() override;
     void _redrawContent() override;
@@ -33,7 +44,12 @@ private:
 
 private:
     const PktIndexEntry *_pktIndexEntry = nullptr;
-    const Er *_er = nullptr;
+
+    // no value: no event record yet
+    boost::optional<Index> _erIndexInPkt;
+
+    Index _erOffsetInPktBits = 0;
+    const yactfr::EventRecordType *_ert = nullptr;
 };
 
 } // namespace jacques
@@ -107,31 +107,85 @@ void PktDataView::_setPrevCurNextOffsetInPktBits()
     }
 }
 
-bool PktDataView::_isCharSel(const _Char& ch) const
+boost::optional<Index> PktDataView::_visiblePktRegionIndex(const boost::optional<Index>& offsetInPktBits) const
 {
-    auto selPktRegionIt = ch.pktRegionIt(_curOffsetInPktBits);
+    if (!offsetInPktBits) {
+        return boost::none;
+    }
+
+    const auto it = std::lower_bound(_pktRegions.begin(), _pktRegions.end(), *offsetInPktBits,
+                                     [](const PktRegion::SPC& pktRegion, const Index offset) {
+        return pktRegion->segment().offsetInPktBits() < offset;
+    });
 
-    if (selPktRegionIt != ch.pktRegions.end()) {
-        return true;
+    if (it == _pktRegions.end() || (*it)->segment().offsetInPktBits() != *offsetInPktBits) {
+        return boost::none;
     }
 
-    if (_prevOffsetInPktBits) {
-        selPktRegionIt = ch.pktRegionIt(*_prevOffsetInPktBits);
+    return static_cast<Index>(it - _pktRegions.begin());
+}
+
+void PktDataView::_setSelPktRegionIndexes()
+{
+    _prevPktRegionIndex = this->_visiblePktRegionIndex(_prevOffsetInPktBits);
+    _curPktRegionIndex = this->_visiblePktRegionIndex(_curOffsetInPktBits);
+    _nextPktRegionIndex = this->_visiblePktRegionIndex(_nextOffsetInPktBits);
+}
 
-        if (selPktRegionIt != ch.pktRegions.end()) {
-            return true;
+template <typename FuncT>
+void PktDataView::_forEachCharOfPktRegion(const Index pktRegionIndex, FuncT&& func) const
+{
+    assert(pktRegionIndex < _pktRegions.size());
+
+    const auto& segment = _pktRegions[pktRegionIndex]->segment();
+    const auto beginOffsetInPktBits = std::max(segment.offsetInPktBits(), _baseOffsetInPktBits);
+    const auto endOffsetInPktBits = std::min(*segment.endOffsetInPktBits(), _endOffsetInPktBits);
+
+    if (beginOffsetInPktBits >= endOffsetInPktBits) {
+        // not visible
+        return;
+    }
+
+    /*
+     * The characters of the packet region are within the characters of
+     * its visible bits (binary) or bytes (hexadecimal, ASCII).
+     */
+    const auto baseByteIndex = _baseOffsetInPktBits / 8;
+    const auto beginByteIndex = beginOffsetInPktBits / 8 - baseByteIndex;
+    const auto endByteIndex = (endOffsetInPktBits - 1) / 8 + 1 - baseByteIndex;
+    const auto forEachChar = [pktRegionIndex, &func](const _Chars& chars, const Index beginIndex,
+                                                     const Index endIndex) {
+        for (auto index = beginIndex; index < std::min(endIndex, static_cast<Index>(chars.size()));
+                ++index) {
+            if (chars[index].hasPktRegion(pktRegionIndex)) {
+                func(chars[index]);
+            }
         }
+    };
+
+    if (_isDataInHex) {
+        // two nibbles per byte
+        forEachChar(_chars, beginByteIndex * 2, endByteIndex * 2);
+    } else {
+        // one character per bit
+        forEachChar(_chars, beginOffsetInPktBits - _baseOffsetInPktBits,
+                    endOffsetInPktBits - _baseOffsetInPktBits);
     }
 
-    if (_nextOffsetInPktBits) {
-        selPktRegionIt = ch.pktRegionIt(*_nextOffsetInPktBits);
+    if (_isAsciiVisible) {
+        forEachChar(_asciiChars, beginByteIndex, endByteIndex);
+    }
+}
 
-        if (selPktRegionIt != ch.pktRegions.end()) {
-            return true;
+template <typename FuncT>
+void PktDataView::_forEachSelChar(FuncT&& func) const
+{
+    for (const auto& pktRegionIndex : {_prevPktRegionIndex, _curPktRegionIndex,
+                                       _nextPktRegionIndex}) {
+        if (pktRegionIndex) {
+            this->_forEachCharOfPktRegion(*pktRegionIndex, func);
         }
     }
-
-    return false;
 }
 
 void PktDataView::_updateSel()
@@ -148,38 +202,16 @@ void PktDataView::_updateSel()
     }
 
     // "erase" currently selected characters
-    // TODO: do not search linearly
-    for (const auto& ch : _chars) {
-        if (this->_isCharSel(ch)) {
-            this->_drawUnselChar(ch);
-        }
-    }
-
-    if (_isAsciiVisible) {
-        for (const auto& ch : _asciiChars) {
-            if (this->_isCharSel(ch)) {
-                this->_drawUnselChar(ch);
-            }
-        }
-    }
+    this->_forEachSelChar([this](const _Char& ch) {
+        this->_drawUnselChar(ch);
+    });
 
     // draw new selected characters
-    // TODO: do not search linearly
     this->_setPrevCurNextOffsetInPktBits();
-
-    for (const auto& ch : _chars) {
-        if (this->_isCharSel(ch)) {
-            this->_drawChar(ch);
-        }
-    }
-
-    if (_isAsciiVisible) {
-        for (const auto& ch : _asciiChars) {
-            if (this->_isCharSel(ch)) {
-                this->_drawChar(ch);
-            }
-        }
-    }
+    this->_setSelPktRegionIndexes();
+    this->_forEachSelChar([this](const _Char& ch) {
+        this->_drawChar(ch);
+    });
 
     // update offset
     this->_drawOffsets();
@@ -368,7 +400,7 @@ void PktDataView::_setTitle()
 
 void PktDataView::_setCustomStyle(const _Char& ch) const
 {
-    if (ch.pktRegions.size() != 1) {
+    if (ch.pktRegionCount != 1) {
         if (ch.isPrintable) {
             this->_stylist().std(*this);
         } else {
@@ -391,7 +423,7 @@ void PktDataView::_setCustomStyle(const _Char& ch) const
     }
 
     auto bookmarkExists = false;
-    const auto& singlePktRegion = *ch.pktRegions.front();
+    const auto& singlePktRegion = *_pktRegions[ch.firstPktRegionIndex];
 
     if (bookmarks) {
         for (Index id = 0; id < bookmarks->size(); ++id) {
@@ -431,10 +463,8 @@ void PktDataView::_drawUnselChar(const _Char& ch) const
 
 void PktDataView::_drawChar(const _Char& ch) const
 {
-    const auto selPktRegionIt = ch.pktRegionIt(_curOffsetInPktBits);
-
-    if (selPktRegionIt != ch.pktRegions.end()) {
-        if (ch.pktRegions.size() == 1) {
+    if (_curPktRegionIndex && ch.hasPktRegion(*_curPktRegionIndex)) {
+        if (ch.pktRegionCount == 1) {
             this->_stylist().pktDataViewSel(*this, Stylist::PktDataViewSelType::CUR);
         } else {
             this->_stylist().pktDataViewAuxSel(*this);
@@ -444,24 +474,20 @@ void PktDataView::_drawChar(const _Char& ch) const
         return;
     }
 
-    if (ch.pktRegions.size() != 1) {
+    if (ch.pktRegionCount != 1) {
         this->_drawUnselChar(ch);
         return;
     }
 
-    const auto& singlePktRegion = *ch.pktRegions.front();
-
     if (_isPrevNextVisible) {
-        if (_prevOffsetInPktBits &&
-                *_prevOffsetInPktBits == singlePktRegion.segment().offsetInPktBits()) {
+        if (_prevPktRegionIndex && *_prevPktRegionIndex == ch.firstPktRegionIndex) {
             this->_stylist().pktDataViewSel(*this,
                                                      Stylist::PktDataViewSelType::PREV);
             this->_putChar(ch.pt, ch.val);
             return;
         }
 
-        if (_nextOffsetInPktBits &&
-                *_nextOffsetInPktBits == singlePktRegion.segment().offsetInPktBits()) {
+        if (_nextPktRegionIndex && *_nextPktRegionIndex == ch.firstPktRegionIndex) {
             this->_stylist().pktDataViewSel(*this,
                                                      Stylist::PktDataViewSelType::NEXT);
             this->_putChar(ch.pt, ch.val);
@@ -519,86 +545,108 @@ inline chtype charFromNibble(const std::uint8_t nibble)
     }
 }
 
+/*
+ * Returns the bit array of the visible part, from `beginOffsetInPktBits`
+ * to `endOffsetInPktBits`, of the packet region `region`: the packet
+ * doesn't need to map a whole huge region (a large BLOB, for example)
+ * to show a page of it.
+ */
+BitArray visibleBitArray(const Pkt& pkt, const PktRegion& region,
+                         const Index beginOffsetInPktBits, const Index endOffsetInPktBits)
+{
+    return pkt.bitArray(PktSegment {
+        beginOffsetInPktBits,
+        endOffsetInPktBits - beginOffsetInPktBits,
+        region.segment().bo()
+    });
+}
+
 } // namespace
 
 void PktDataView::_setHexChars()
 {
     /*
      * The strategy here is to create all the nibble characters first,
-     * and then iterate the packet regions and find the already-created
-     * character to append a packet region (if not already appended).
+     * and then iterate the packet regions and link the already-created
+     * characters of their bytes to them.
      */
-    const auto data = _appState->activePktState().pkt().data(_baseOffsetInPktBits / 8);
+    const auto& pkt = _appState->activePktState().pkt();
+    const auto data = pkt.data(_baseOffsetInPktBits / 8,
+                               (_endOffsetInPktBits - _baseOffsetInPktBits + 7) / 8);
 
     for (auto offsetInPktBits = _baseOffsetInPktBits; offsetInPktBits < _endOffsetInPktBits;
             offsetInPktBits += 8) {
         const auto byte = data[(offsetInPktBits - _baseOffsetInPktBits) / 8];
-        const auto y = (offsetInPktBits - _baseOffsetInPktBits) / _rowSize.bits();
         const auto byteIndexInRow = (offsetInPktBits % _rowSize.bits()) / 8;
+        _Char ch;
 
-        // high nibble
-        {
-            _Char ch;
+        ch.pt.y = (offsetInPktBits - _baseOffsetInPktBits) / _rowSize.bits();
 
-            ch.pt.y = y;
-            ch.pt.x = _dataX + byteIndexInRow * 3;
-            ch.val = charFromNibble((byte >> 4) & 0xf);
-            _chars.push_back(std::move(ch));
-        }
+        // high nibble
+        ch.pt.x = _dataX + byteIndexInRow * 3;
+        ch.val = charFromNibble((byte >> 4) & 0xf);
+        _chars.push_back(ch);
 
         // low nibble
-        {
-            _Char ch;
-
-            ch.pt.y = y;
-            ch.pt.x = _dataX + byteIndexInRow * 3 + 1;
-            ch.val = charFromNibble(byte & 0xf);
-            _chars.push_back(std::move(ch));
-        }
+        ch.pt.x = _dataX + byteIndexInRow * 3 + 1;
+        ch.val = charFromNibble(byte & 0xf);
+        _chars.push_back(ch);
     }
 
     const Er *curEr = nullptr;
+    const auto baseByteIndex = _baseOffsetInPktBits / 8;
 
-    for (auto& pktRegion : _pktRegions) {
-        const auto bitArray = _appState->activePktState().pkt().bitArray(*pktRegion);
-        const auto firstBitOffsetInPkt = pktRegion->segment().offsetInPktBits();
-
+    for (Index pktRegionIndex = 0; pktRegionIndex < _pktRegions.size(); ++pktRegionIndex) {
+        const auto& pktRegion = *_pktRegions[pktRegionIndex];
         auto isErFirst = false;
 
-        if (pktRegion->scope() && pktRegion->scope()->er() && pktRegion->scope()->er() != curEr) {
-            curEr = pktRegion->scope()->er();
+        if (pktRegion.scope() && pktRegion.scope()->er() && pktRegion.scope()->er() != curEr) {
+            curEr = pktRegion.scope()->er();
             isErFirst = true;
         }
 
-        const auto startOffsetInPktBits = std::max(firstBitOffsetInPkt, _baseOffsetInPktBits);
-        const auto endOffsetInPktBits = std::min(firstBitOffsetInPkt +
-                                                 pktRegion->segment().len()->bits(),
+        const auto startOffsetInPktBits = std::max(pktRegion.segment().offsetInPktBits(),
+                                                   _baseOffsetInPktBits);
+        const auto endOffsetInPktBits = std::min(*pktRegion.segment().endOffsetInPktBits(),
                                                  _endOffsetInPktBits);
 
-        for (Index bitOffsetInPkt = startOffsetInPktBits;
-                bitOffsetInPkt < endOffsetInPktBits; ++bitOffsetInPkt) {
-            const auto indexInBitArray = bitOffsetInPkt -
-                                         firstBitOffsetInPkt;
-
-            // times two because `_chars` contains nibbles, not bytes
-            auto charIndex = ((bitOffsetInPkt / 8) - (_baseOffsetInPktBits / 8)) * 2;
-            const auto bitLoc = bitArray.bitLoc(indexInBitArray);
+        if (startOffsetInPktBits >= endOffsetInPktBits) {
+            continue;
+        }
 
-            if (bitLoc.bitIndexInByte() < 4) {
-                // low nibble
-                ++charIndex;
-            }
+        /*
+         * Within a byte, the first four bits of a big endian packet
+         * region are in the high nibble, while the first four bits of a
+         * little endian packet region are in the low nibble.
+         */
+        const auto& bo = pktRegion.segment().bo();
+        const auto isLe = bo && *bo == yactfr::ByteOrder::LITTLE;
+        const auto linkChar = [pktRegionIndex, isErFirst](_Char& ch) {
+            ch.isErFirst = isErFirst;
+            ch.linkPktRegion(pktRegionIndex);
+        };
+
+        for (auto byteOffsetInPktBits = startOffsetInPktBits - startOffsetInPktBits % 8;
+                byteOffsetInPktBits < endOffsetInPktBits; byteOffsetInPktBits += 8) {
+            // bits of the packet region within this byte
+            const auto beginBitInByte = std::max(startOffsetInPktBits, byteOffsetInPktBits) -
+                                        byteOffsetInPktBits;
+            const auto endBitInByte = std::min(endOffsetInPktBits, byteOffsetInPktBits + 8) -
+                                      byteOffsetInPktBits;
+            const auto hasFirstHalf = beginBitInByte < 4;
+            const auto hasSecondHalf = endBitInByte > 4;
 
-            assert(charIndex < _chars.size());
+            // times two because `_chars` contains nibbles, not bytes
+            const auto charIndex = (byteOffsetInPktBits / 8 - baseByteIndex) * 2;
 
-            // get existing character (created above)
-            auto& ch = _chars[charIndex];
+            assert(charIndex + 1 < _chars.size());
 
-            ch.isErFirst = isErFirst;
+            if (isLe ? hasSecondHalf : hasFirstHalf) {
+                linkChar(_chars[charIndex]);
+            }
 
-            if (ch.pktRegions.empty() || ch.pktRegions.back() != pktRegion.get()) {
-                // associate character to packet region
-                ch.pktRegions.push_back(pktRegion.get());
+            if (isLe ? hasFirstHalf : hasSecondHalf) {
+                linkChar(_chars[charIndex + 1]);
             }
         }
     }
@@ -613,6 +661,8 @@ void PktDataView::_setAsciiChars()
     assert((_baseOffsetInPktBits & 7) == 0);
 
     const auto& pkt = _appState->activePktState().pkt();
+    const auto data = pkt.data(_baseOffsetInPktBits / 8,
+                               (_endOffsetInPktBits - _baseOffsetInPktBits + 7) / 8);
 
     for (auto offsetInPktBits = _baseOffsetInPktBits; offsetInPktBits < _endOffsetInPktBits;
             offsetInPktBits += 8) {
@@ -621,7 +671,7 @@ void PktDataView::_setAsciiChars()
         ch.pt.y = (offsetInPktBits - _baseOffsetInPktBits) / _rowSize.bits();
         ch.pt.x = _asciiCharsX + (offsetInPktBits % _rowSize.bits()) / 8;
 
-        const auto val = static_cast<chtype>(*pkt.data(offsetInPktBits / 8));
+        const auto val = static_cast<chtype>(data[(offsetInPktBits - _baseOffsetInPktBits) / 8]);
 
         if (!std::isprint(val)) {
             ch.isPrintable = false;
@@ -630,29 +680,33 @@ void PktDataView::_setAsciiChars()
             ch.val = val;
         }
 
-        _asciiChars.push_back(std::move(ch));
+        _asciiChars.push_back(ch);
     }
 
     const Er *curEr = nullptr;
+    const auto baseByteIndex = _baseOffsetInPktBits / 8;
 
-    for (const auto& pktRegion : _pktRegions) {
-        const auto firstBitOffsetInPkt = pktRegion->segment().offsetInPktBits();
-
+    for (Index pktRegionIndex = 0; pktRegionIndex < _pktRegions.size(); ++pktRegionIndex) {
+        const auto& pktRegion = *_pktRegions[pktRegionIndex];
         bool isErFirst = false;
 
-        if (pktRegion->scope() && pktRegion->scope()->er() && pktRegion->scope()->er() != curEr) {
-            curEr = pktRegion->scope()->er();
+        if (pktRegion.scope() && pktRegion.scope()->er() && pktRegion.scope()->er() != curEr) {
+            curEr = pktRegion.scope()->er();
             isErFirst = true;
         }
 
-        const auto startOffsetInPktBits = std::max(firstBitOffsetInPkt, _baseOffsetInPktBits);
-        const auto endOffsetInPktBits = std::min(firstBitOffsetInPkt +
-                                                 pktRegion->segment().len()->bits(),
+        const auto startOffsetInPktBits = std::max(pktRegion.segment().offsetInPktBits(),
+                                                   _baseOffsetInPktBits);
+        const auto endOffsetInPktBits = std::min(*pktRegion.segment().endOffsetInPktBits(),
                                                  _endOffsetInPktBits);
 
-        for (Index bitOffsetInPkt = startOffsetInPktBits; bitOffsetInPkt < endOffsetInPktBits;
-                ++bitOffsetInPkt) {
-            const auto charIndex = ((bitOffsetInPkt / 8) - (_baseOffsetInPktBits / 8));
+        if (startOffsetInPktBits >= endOffsetInPktBits) {
+            continue;
+        }
+
+        for (auto byteIndex = startOffsetInPktBits / 8;
+                byteIndex <= (endOffsetInPktBits - 1) / 8; ++byteIndex) {
+            const auto charIndex = byteIndex - baseByteIndex;
 
             assert(charIndex < _asciiChars.size());
 
@@ -660,11 +714,7 @@ void PktDataView::_setAsciiChars()
             auto& ch = _asciiChars[charIndex];
 
             ch.isErFirst = isErFirst;
-
-            if (ch.pktRegions.empty() || ch.pktRegions.back() != pktRegion.get()) {
-                // associate character to packet region
-                ch.pktRegions.push_back(pktRegion.get());
-            }
+            ch.linkPktRegion(pktRegionIndex);
         }
     }
 }
@@ -673,28 +723,38 @@ void PktDataView::_setBinaryChars()
 {
     const Er *curEr = nullptr;
 
-    for (const auto& pktRegion : _pktRegions) {
-        const auto bitArray = _appState->activePktState().pkt().bitArray(*pktRegion);
-        const auto firstBitOffsetInPkt = pktRegion->segment().offsetInPktBits();
+    const auto& pkt = _appState->activePktState().pkt();
+
+    for (Index pktRegionIndex = 0; pktRegionIndex < _pktRegions.size(); ++pktRegionIndex) {
+        const auto& pktRegion = *_pktRegions[pktRegionIndex];
         bool isErFirst = false;
 
-        if (pktRegion->scope() && pktRegion->scope()->er() && pktRegion->scope()->er() != curEr) {
-            curEr = pktRegion->scope()->er();
+        if (pktRegion.scope() && pktRegion.scope()->er() && pktRegion.scope()->er() != curEr) {
+            curEr = pktRegion.scope()->er();
             isErFirst = true;
         }
 
-        const auto startOffsetInPktBits = std::max(firstBitOffsetInPkt, _baseOffsetInPktBits);
-        const auto endOffsetInPktBits = std::min(firstBitOffsetInPkt +
-                                                 pktRegion->segment().len()->bits(),
+        const auto startOffsetInPktBits = std::max(pktRegion.segment().offsetInPktBits(),
+                                                   _baseOffsetInPktBits);
+        const auto endOffsetInPktBits = std::min(*pktRegion.segment().endOffsetInPktBits(),
                                                  _endOffsetInPktBits);
 
+        if (startOffsetInPktBits >= endOffsetInPktBits) {
+            continue;
+        }
+
+        const auto bitArray = visibleBitArray(pkt, pktRegion, startOffsetInPktBits,
+                                              endOffsetInPktBits);
+        _Char ch;
+
+        ch.isErFirst = isErFirst;
+        ch.linkPktRegion(pktRegionIndex);
+
         for (Index bitOffsetInPkt = startOffsetInPktBits; bitOffsetInPkt < endOffsetInPktBits;
                 ++bitOffsetInPkt) {
-            const auto indexInBitArray = bitOffsetInPkt - firstBitOffsetInPkt;
+            const auto indexInBitArray = bitOffsetInPkt - startOffsetInPktBits;
             const auto bitLoc = bitArray.bitLoc(indexInBitArray);
-            _Char ch;
 
-            ch.isErFirst = isErFirst;
             ch.val = '0' + bitArray[bitLoc];
             ch.pt.y = (bitOffsetInPkt - _baseOffsetInPktBits) / _rowSize.bits();
 
@@ -706,8 +766,7 @@ void PktDataView::_setBinaryChars()
              *                              ^ + 7 - bitLoc.bitIndexInByte() [+ 7 - 2]
              */
             ch.pt.x = _dataX + byteIndex * 9 + 7 - bitLoc.bitIndexInByte();
-            ch.pktRegions.push_back(pktRegion.get());
-            _chars.push_back(std::move(ch));
+            _chars.push_back(ch);
         }
     }
 }
@@ -722,7 +781,6 @@ void PktDataView::_setNumericCharsAndAsciiChars()
     assert(_appState->hasActivePktState());
 
     // set numeric characters
-    std::vector<PktRegion::SPC> pktRegions;
     auto& pkt = _appState->activePktState().pkt();
 
     /*
@@ -751,6 +809,7 @@ void PktDataView::_setNumericCharsAndAsciiChars()
     // set ASCII chars
     _asciiChars.clear();
     this->_setAsciiChars();
+    this->_setSelPktRegionIndexes();
 }
 
 void PktDataView::pageDown()
@@ -12,6 +12,8 @@
 #include <list>
 #include <algorithm>
 #include <unordered_set>
+#include <cassert>
+#include <boost/optional.hpp>
 
 #include "view.hpp"
 #include "data/pkt-region.hpp"
@@ -25,19 +27,33 @@ namespace jacques {
  * The view has a current base offset which is the offset of the first
  * visible bit/nibble (top left), if any.
  *
- * The view contains a current vector of character objects. A character
- * is linked to one or more packet regions. A character contains a point
- * and a value to print (for example, `0`, `1`, `5`, `c`).
+ * The view contains the current visible packet regions, sorted by
+ * offset and contiguous (`_pktRegions`), as well as flat vectors of
+ * character objects: one for the numeric characters and one for the
+ * ASCII characters. A character contains a point and a value to print
+ * (for example, `0`, `1`, `5`, `c`), and is linked to a range of
+ * consecutive packet regions within `_pktRegions` (indexes, not
+ * pointers).
  *
  * The view builds character objects from the regions of the current
  * packet with _setNumericCharsAndAsciiChars(). This method takes the
- * current base offset into account.
+ * current base offset into account. It reuses the same vectors from
+ * one page to the other and a character doesn't own anything, so that
+ * changing the page doesn't allocate once the vectors are large enough
+ * for a screen.
  *
  * A character can be linked to more than one packet regions in
  * hexadecimal display mode (when `_isHex` is true). This is because a
  * single nibble can contain up to four individual bits which may belong
  * to different packet regions.
  *
+ * Because the characters of a given packet region are always within a
+ * range of characters which only depends on the visible bits of this
+ * packet region, finding the characters to draw when the selection
+ * changes is a matter of finding the index of the selected packet
+ * region (binary search within `_pktRegions`) and then checking a few
+ * characters.
+ *
  * ASCII characters use the same character class. An ASCII character can
  * have its `isPrintable` property set to false, in which case the view
  * must print an alternative (printable) character with a different
@@ -110,23 +126,32 @@ public:
 private:
     struct _Char
     {
-        explicit _Char() = default;
-        _Char(const _Char&) = default;
-        _Char& operator=(const _Char&) = default;
-        _Char(_Char&&) = default;
-        _Char& operator=(_Char&&) = default;
+        bool hasPktRegion(const Index pktRegionIndex) const noexcept
+        {
+            return pktRegionCount > 0 && pktRegionIndex >= firstPktRegionIndex &&
+                   pktRegionIndex < firstPktRegionIndex + pktRegionCount;
+        }
 
-        auto pktRegionIt(const Index offsetInPktBits) const
+        // links this character to the packet region `pktRegionIndex`
+        void linkPktRegion(const Index pktRegionIndex) noexcept
         {
-            return std::find_if(pktRegions.begin(), pktRegions.end(),
-                                [offsetInPktBits](const auto& pktRegion) {
-                return pktRegion->segment().offsetInPktBits() == offsetInPktBits;
-            });
+            if (pktRegionCount == 0) {
+                firstPktRegionIndex = pktRegionIndex;
+                pktRegionCount = 1;
+            } else {
+                // packet regions are linked in order
+                assert(pktRegionIndex >= firstPktRegionIndex);
+                pktRegionCount = pktRegionIndex - firstPktRegionIndex + 1;
+            }
         }
 
         Point pt;
         chtype val;
-        std::vector<const PktRegion *> pktRegions;
+
+        // range of packet regions within `_pktRegions`
+        Index firstPktRegionIndex = 0;
+        Size pktRegionCount = 0;
+
         bool isErFirst = false;
         bool isPrintable = true;
     };
@@ -145,7 +170,6 @@ private:
     void _drawUnselChar(const _Char& ch) const;
     void _drawAllNumericChars() const;
     void _drawAllAsciiChars() const;
-    bool _isCharSel(const _Char& ch) const;
     void _setDataXAndRowSize();
     void _updateSel();
     void _setHexChars();
@@ -153,6 +177,14 @@ private:
     void _setAsciiChars();
     void _setNumericCharsAndAsciiChars();
     void _setPrevCurNextOffsetInPktBits();
+    void _setSelPktRegionIndexes();
+    boost::optional<Index> _visiblePktRegionIndex(const boost::optional<Index>& offsetInPktBits) const;
+
+    template <typename FuncT>
+    void _forEachCharOfPktRegion(Index pktRegionIndex, FuncT&& func) const;
+
+    template <typename FuncT>
+    void _forEachSelChar(FuncT&& func) const;
     void _setBaseAndEndOffsetInPktBitsFromOffset(Index offsetInPktBits);
 
     void _setEndOffsetInPktBitsFromBaseOffset() noexcept
@@ -209,12 +241,17 @@ private:
     // current ASCII characters
     _Chars _asciiChars;
 
-    // current packet regions (owned here)
+    // current packet regions (owned here), sorted by offset
     std::vector<PktRegion::SPC> _pktRegions;
 
     boost::optional<Index> _prevOffsetInPktBits;
     Index _curOffsetInPktBits = 0;
     boost::optional<Index> _nextOffsetInPktBits;
+
+    // indexes of the selected packet regions within `_pktRegions`
+    boost::optional<Index> _prevPktRegionIndex;
+    boost::optional<Index> _curPktRegionIndex;
+    boost::optional<Index> _nextPktRegionIndex;
     bool _isAsciiVisible = true;
     bool _isPrevNextVisible = true;
     bool _isErFirstPktRegionEmphasized = true;
@@ -46,9 +46,15 @@ void PktIndexBuildProgressView::dsFile(const DsFile& dsf)
 
 void PktIndexBuildProgressView::pktIndexEntry(const PktIndexEntry& entry)
 {
-    _index = entry.indexInDsFile();
-    _offsetBytes = entry.offsetInDsFileBytes();
-    _seqNum = entry.seqNum();
+    this->progress(entry.indexInDsFile(), entry.offsetInDsFileBytes(), entry.seqNum());
+}
+
+void PktIndexBuildProgressView::progress(const Index index, const Index offsetBytes,
+                                         const boost::optional<Index>& seqNum)
+{
+    _index = index;
+    _offsetBytes = offsetBytes;
+    _seqNum = seqNum;
     this->_drawProgress();
 }
 
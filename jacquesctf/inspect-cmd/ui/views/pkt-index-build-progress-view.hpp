@@ -23,6 +23,9 @@ public:
     void dsFile(const DsFile& dsf);
     void pktIndexEntry(const PktIndexEntry& entry);
 
+    // progress without the packet index entry itself
+    void progress(Index index, Index offsetBytes, const boost::optional<Index>& seqNum);
+
 protected:
     void _resized() override;
     void _redrawContent() override;
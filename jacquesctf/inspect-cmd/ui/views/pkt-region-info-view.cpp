@@ -33,7 +33,6 @@ PktRegionInfoView::PktRegionInfoView(const Rect& rect, const Stylist& stylist,
     _appState {&appState},
     _appStateObserverGuard {appState, *this}
 {
-    this->_setMaxDtPathSizes();
 }
 
 void PktRegionInfoView::_appStateChanged(Message)
@@ -219,7 +218,7 @@ void PktRegionInfoView::_redrawContent()
     // size
     this->_stylist().pktRegionInfoViewStd(*this, false);
 
-    const auto pathWidth = _maxDtPathSizes[&_appState->trace()];
+    const auto pathWidth = this->_curMaxDtPathSize();
     const auto str = utils::sepNumber(pktRegion->segment().len()->bits(), ',');
 
     this->_safeMoveAndPrint({
@@ -314,43 +313,49 @@ void PktRegionInfoView::_redrawContent()
     }
 }
 
-void PktRegionInfoView::_setMaxDtPathSize(const Trace& trace)
+Size PktRegionInfoView::_maxDtPathSize(const Metadata& metadata,
+                                       const yactfr::DataStreamType * const dst)
 {
-    const auto accFunc = [](const auto total, auto& item) {
-        return total + dtPathItemStr(item).size();
-    };
+    const auto key = std::make_pair(&metadata, dst);
+    const auto it = _maxDtPathSizes.find(key);
 
-    const auto totalDtPathItSizeFunc = [&accFunc](auto& dtDtPathPair) {
+    if (it != _maxDtPathSizes.end()) {
+        return it->second;
+    }
+
+    Size maxSize = 0;
+
+    metadata.forEachDtPath(dst, [&maxSize](const auto& dtPath) {
         /*
-         * Adding `dtDtPathPair.second.items().size()` for the
-         * separators and 4 for the scope name.
+         * Adding `dtPath.items().size()` for the separators and 4 for
+         * the scope name.
          */
-        return std::accumulate(dtDtPathPair.second.items().begin(),
-                               dtDtPathPair.second.items().end(), 0ULL, accFunc) +
-               dtDtPathPair.second.items().size() + 4;
-    };
-
-    const auto maxDtPathIt = std::max_element(trace.metadata().dtPaths().begin(),
-                                              trace.metadata().dtPaths().end(),
-                                              [&totalDtPathItSizeFunc](const auto& pairA,
-                                                                       const auto& pairB) {
-        return totalDtPathItSizeFunc(pairA) < totalDtPathItSizeFunc(pairB);
+        const auto size = std::accumulate(dtPath.items().begin(), dtPath.items().end(), 0ULL,
+                                          [](const auto total, auto& item) {
+            return total + dtPathItemStr(item).size();
+        }) + dtPath.items().size() + 4;
+
+        maxSize = std::max(maxSize, static_cast<Size>(size));
     });
 
-    _maxDtPathSizes.insert(std::make_pair(&trace,
-                                          maxDtPathIt == trace.metadata().dtPaths().end() ? 0ULL :
-                                          totalDtPathItSizeFunc(*maxDtPathIt)));
+    _maxDtPathSizes.insert(std::make_pair(key, maxSize));
+    return maxSize;
 }
 
-void PktRegionInfoView::_setMaxDtPathSizes()
+Size PktRegionInfoView::_curMaxDtPathSize()
 {
-    for (const auto& dsfState : _appState->dsFileStates()) {
-        auto& trace = dsfState->trace();
+    assert(_appState->hasActivePktState());
 
-        if (_maxDtPathSizes.find(&trace) == _maxDtPathSizes.end()) {
-            this->_setMaxDtPathSize(trace);
-        }
-    }
+    /*
+     * Only the paths of the packet header and of the data stream type
+     * of the current packet: don't build the paths of the other data
+     * stream types until a packet of theirs is shown.
+     */
+    const auto& metadata = _appState->trace().metadata();
+
+    return std::max(this->_maxDtPathSize(metadata, nullptr),
+                    this->_maxDtPathSize(metadata,
+                                         _appState->activePktState().pkt().indexEntry().dst()));
 }
 
 Size PktRegionInfoView::_curMaxOffsetSize()
@@ -9,6 +9,8 @@
 #define _JACQUES_INSPECT_CMD_UI_VIEWS_PKT_REGION_INFO_VIEW_HPP
 
 #include <unordered_map>
+#include <map>
+#include <utility>
 
 #include "view.hpp"
 
@@ -25,14 +27,16 @@ private:
     void _redrawContent() override;
     void _safePrintScope(yactfr::Scope scope);
     Size _curMaxOffsetSize();
-    void _setMaxDtPathSize(const Trace& trace);
-    void _setMaxDtPathSizes();
+    Size _maxDtPathSize(const Metadata& metadata, const yactfr::DataStreamType *dst);
+    Size _curMaxDtPathSize();
 
 private:
     InspectCmdState *_appState;
     ViewInspectCmdStateObserverGuard _appStateObserverGuard;
     std::unordered_map<const Pkt *, Size> _maxOffsetSizes;
-    std::unordered_map<const Trace *, Size> _maxDtPathSizes;
+
+    // maximum data type path size per data stream type (`nullptr`: packet header)
+    std::map<std::pair<const Metadata *, const yactfr::DataStreamType *>, Size> _maxDtPathSizes;
 };
 
 } // namespace jacques
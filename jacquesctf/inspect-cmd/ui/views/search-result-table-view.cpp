@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <numeric>
+#include <sstream>
+
+#include "search-result-table-view.hpp"
+#include "utils.hpp"
+
+namespace jacques {
+
+SearchResultTableView::SearchResultTableView(const Rect& rect, const Stylist& stylist,
+                                             const InspectCmdState& appState) :
+    TableView {rect, "Search results", DecorationStyle::BORDERS, stylist},
+    _appState {&appState}
+{
+    this->_setColumnDescrs();
+}
+
+void SearchResultTableView::_resized()
+{
+    TableView::_resized();
+    this->_setColumnDescrs();
+}
+
+void SearchResultTableView::_setColumnDescrs()
+{
+    std::vector<TableViewColumnDescr> descrs {
+        TableViewColumnDescr {"Data stream file", 29},
+        TableViewColumnDescr {"Packet", 10},
+        TableViewColumnDescr {"ER", 10},
+        TableViewColumnDescr {"Offset in packet", 17},
+        TableViewColumnDescr {"In packet", 10},
+        TableViewColumnDescr {"In file", 12},
+    };
+
+    const auto accOp = [](const auto sz, auto& descr) {
+        return sz + descr.contentWidth();
+    };
+    auto curSize = std::accumulate(descrs.begin(), descrs.end(), 0ULL, accOp);
+
+    // remove some columns until they all fit
+    while (this->_contentSize(descrs.size()) < curSize && descrs.size() > 3) {
+        descrs.erase(descrs.end() - 1);
+        curSize = std::accumulate(descrs.begin(), descrs.end(), 0ULL, accOp);
+    }
+
+    // expand first column
+    descrs.front() = TableViewColumnDescr {
+        descrs.front().title(),
+        this->_contentSize(descrs.size()) -
+            std::accumulate(descrs.begin() + 1, descrs.end(), 0ULL, accOp)
+    };
+
+    this->_resetRow(descrs);
+    this->_colDescrs(std::move(descrs));
+}
+
+void SearchResultTableView::_resetRow(const std::vector<TableViewColumnDescr>& descrs)
+{
+    _row.clear();
+    _row.push_back(std::make_unique<PathTableViewCell>());
+    _row[0]->emphasized(true);
+
+    for (Index col = 1; col < descrs.size(); ++col) {
+        if (col == 3) {
+            _row.push_back(std::make_unique<DataLenTableViewCell>(_dataLenFmtMode));
+            continue;
+        }
+
+        _row.push_back(std::make_unique<UIntTableViewCell>(TableViewCell::TextAlign::RIGHT));
+        static_cast<UIntTableViewCell&>(*_row.back()).sep(true);
+    }
+}
+
+void SearchResultTableView::_drawRow(const Index row)
+{
+    assert(_search);
+    assert(row < _resultCount);
+
+    const auto result = _search->result(row);
+    const auto& dsf = _appState->dsFileState(result.dsFileIndex).dsFile();
+
+    static_cast<PathTableViewCell&>(*_row[0]).path(dsf.path());
+    static_cast<UIntTableViewCell&>(*_row[1]).val(result.pktIndexInDsFile);
+    static_cast<UIntTableViewCell&>(*_row[2]).val(result.erIndexInPkt);
+
+    if (_row.size() >= 4) {
+        static_cast<DataLenTableViewCell&>(*_row[3]).len(result.offsetInPktBits);
+    }
+
+    if (_row.size() >= 5) {
+        static_cast<UIntTableViewCell&>(*_row[4]).val(_search->resultCountInPkt(result));
+    }
+
+    if (_row.size() >= 6) {
+        static_cast<UIntTableViewCell&>(*_row[5]).val(_search->resultCountInDsFile(result.dsFileIndex));
+    }
+
+    this->_drawCells(row, _row);
+}
+
+Size SearchResultTableView::_rowCount()
+{
+    return _resultCount;
+}
+
+void SearchResultTableView::_updateTitle()
+{
+    std::ostringstream ss;
+
+    ss << "Search results";
+
+    if (_search) {
+        ss << ": " << utils::sepNumber(static_cast<unsigned long long>(_resultCount), ',');
+
+        if (!_search->isDone()) {
+            const auto pktCount = std::max(_search->pktCount(), 1ULL);
+
+            ss << " (scanning: " << (_search->scannedPktCount() * 100 / pktCount) << " %)";
+        }
+
+        if (_search->erroneousPktCount() > 0) {
+            ss << " (" << _search->erroneousPktCount() << " packets with errors)";
+        }
+    }
+
+    this->_title(ss.str());
+}
+
+void SearchResultTableView::search(const FindAllSearch * const search)
+{
+    _search = search;
+    _resultCount = search ? search->resultCount() : 0;
+    this->_selRowAndDraw(0, false);
+    this->_updateTitle();
+    this->_updateCounts();
+    this->redraw();
+}
+
+void SearchResultTableView::update()
+{
+    if (!_search) {
+        return;
+    }
+
+    /*
+     * Published results never move: appending rows doesn't change the
+     * selected row.
+     */
+    _resultCount = _search->resultCount();
+    this->_updateTitle();
+    this->_updateCounts();
+    this->redraw();
+}
+
+void SearchResultTableView::dataLenFmtMode(const utils::LenFmtMode dataLenFmtMode)
+{
+    if (_row.size() >= 4) {
+        static_cast<DataLenTableViewCell&>(*_row[3]).fmtMode(dataLenFmtMode);
+    }
+
+    _dataLenFmtMode = dataLenFmtMode;
+    this->_redrawRows();
+}
+
+boost::optional<FindAllSearch::Result> SearchResultTableView::selResult() const
+{
+    if (!_search || _resultCount == 0) {
+        return boost::none;
+    }
+
+    return _search->result(this->_selRow());
+}
+
+} // namespace jacques
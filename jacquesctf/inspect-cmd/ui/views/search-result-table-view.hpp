@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_INSPECT_CMD_UI_VIEWS_SEARCH_RESULT_TABLE_VIEW_HPP
+#define _JACQUES_INSPECT_CMD_UI_VIEWS_SEARCH_RESULT_TABLE_VIEW_HPP
+
+#include <boost/optional.hpp>
+
+#include "data/data-len.hpp"
+#include "inspect-common/find-all-search.hpp"
+#include "table-view.hpp"
+
+namespace jacques {
+
+/*
+ * Table of the results of a "find all" search.
+ *
+ * Each row is an event record; the last two columns are the numbers of
+ * results in its packet and in its data stream file.
+ *
+ * The search keeps running while the view shows its first results:
+ * call update() from time to time to show the new ones.
+ */
+class SearchResultTableView final :
+    public TableView
+{
+public:
+    explicit SearchResultTableView(const Rect& rect, const Stylist& stylist,
+                                   const InspectCmdState& appState);
+
+    // `search` must outlive this view, or be reset to `nullptr`
+    void search(const FindAllSearch *search);
+
+    void update();
+    void dataLenFmtMode(utils::LenFmtMode dataLenFmtMode);
+    boost::optional<FindAllSearch::Result> selResult() const;
+
+private:
+    void _drawRow(Index index) override;
+    Size _rowCount() override;
+    void _resized() override;
+    void _setColumnDescrs();
+    void _resetRow(const std::vector<TableViewColumnDescr>& descrs);
+    void _updateTitle();
+
+private:
+    std::vector<std::unique_ptr<TableViewCell>> _row;
+    const InspectCmdState *_appState;
+    const FindAllSearch *_search = nullptr;
+    Size _resultCount = 0;
+    utils::LenFmtMode _dataLenFmtMode = utils::LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_INSPECT_CMD_UI_VIEWS_SEARCH_RESULT_TABLE_VIEW_HPP
@@ -25,41 +25,39 @@ StatusView::StatusView(const Rect& rect, const Stylist& stylist, InspectCmdState
     _appState {&appState},
     _appStateObserverGuard {appState, *this}
 {
-    this->_createEndPositions();
 }
 
-void StatusView::_createEndPositions()
+const StatusView::_EndPositions& StatusView::_endPositionsOf(const DsFileState& dsfState)
 {
-    for (const auto& dsfState : _appState->dsFileStates()) {
-        _EndPositions positions;
-        const auto& dsf = dsfState->dsFile();
-        const auto pktCountStr = utils::sepNumber(dsf.pktCount());
-
-        positions.pktCount = 0;
-        positions.pktIndex = positions.pktCount + pktCountStr.size() + 1;
-        positions.seqNum = positions.pktIndex + pktCountStr.size() + 5;
-        positions.pktPercent = positions.seqNum + pktCountStr.size() + 6;
-        positions.curOffsetInDsFileBits = positions.pktPercent + 9;
-        positions.curOffsetInPktBits = positions.curOffsetInDsFileBits + 17;
-
-        const auto maxEntryIt = std::max_element(dsf.pktIndexEntries().begin(),
-                                                 dsf.pktIndexEntries().end(),
-                                                 [](const auto& entryA, const auto& entryB) {
-            return entryA.effectiveTotalLen() < entryB.effectiveTotalLen();
-        });
-        const auto maxOffsetInPktBitsStr = (maxEntryIt == dsf.pktIndexEntries().end()) ?
-                                           std::string {} :
-                                           utils::sepNumber(maxEntryIt->effectiveTotalLen().bits());
-
-        positions.dsfPath = positions.curOffsetInPktBits + maxOffsetInPktBitsStr.size() + 6;
-        _endPositions[dsfState.get()] = positions;
+    const auto it = _endPositions.find(&dsfState);
+
+    if (it != _endPositions.end()) {
+        return it->second;
     }
+
+    _EndPositions positions;
+    const auto& dsf = dsfState.dsFile();
+    const auto pktCountStr = utils::sepNumber(dsf.pktCount());
+
+    positions.pktCount = 0;
+    positions.pktIndex = positions.pktCount + pktCountStr.size() + 1;
+    positions.seqNum = positions.pktIndex + pktCountStr.size() + 5;
+    positions.pktPercent = positions.seqNum + pktCountStr.size() + 6;
+    positions.curOffsetInDsFileBits = positions.pktPercent + 9;
+    positions.curOffsetInPktBits = positions.curOffsetInDsFileBits + 17;
+
+    const auto maxOffsetInPktBitsStr = (dsf.pktCount() == 0) ?
+                                       std::string {} :
+                                       utils::sepNumber(dsf.maxPktTotalLen().bits());
+
+    positions.dsfPath = positions.curOffsetInPktBits + maxOffsetInPktBitsStr.size() + 6;
+    return _endPositions[&dsfState] = positions;
 }
 
 void StatusView::_appStateChanged(const Message msg)
 {
     if (msg == Message::ACTIVE_DS_FILE_AND_PKT_CHANGED || msg == Message::ACTIVE_PKT_CHANGED) {
-        _curEndPositions = &_endPositions[&_appState->activeDsFileState()];
+        _curEndPositions = &this->_endPositionsOf(_appState->activeDsFileState());
         this->redraw();
     } else if (msg == Message::CUR_OFFSET_IN_PKT_CHANGED) {
         this->_drawOffset();
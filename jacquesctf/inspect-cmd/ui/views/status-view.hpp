@@ -35,7 +35,7 @@ private:
     };
 
 private:
-    void _createEndPositions();
+    const _EndPositions& _endPositionsOf(const DsFileState& dsfState);
     void _drawOffset();
     void _appStateChanged(Message msg) override;
     void _redrawContent() override;
@@ -43,7 +43,10 @@ private:
 private:
     InspectCmdState *_appState;
     ViewInspectCmdStateObserverGuard _appStateObserverGuard;
+
+    // created on first use: requires the data stream file index
     std::unordered_map<const DsFileState *, _EndPositions> _endPositions;
+
     const _EndPositions *_curEndPositions = nullptr;
 };
 
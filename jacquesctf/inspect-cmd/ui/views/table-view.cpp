@@ -206,28 +206,31 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
         this->_drawCellAlignedText(contentPos, descr.contentWidth(), rCell->val() ? "Yes" : "No",
                                    rCell->val() ? 3 : 2, customStyle, cell.textAlign());
     } else if (const auto dsCell = dynamic_cast<const DataLenTableViewCell *>(&cell)) {
-        const auto parts = dsCell->len().format(dsCell->fmtMode(), ',');
-        const char *fmt = "%s %s";
-        std::array<char, 32> buf;
+        std::array<char, 48> buf;
+        const auto unit = utils::formatLen(buf.data(), dsCell->len().bits(), dsCell->fmtMode(),
+                                           ',');
+        auto len = std::strlen(buf.data());
+        const auto unitLen = std::strlen(unit);
 
         if (dsCell->fmtMode() == utils::LenFmtMode::FULL_FLOOR ||
                 dsCell->fmtMode() == utils::LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS) {
-            fmt = "%s%4s";
+            // right-align the unit within 4 characters
+            for (auto i = unitLen; i < 4; ++i) {
+                buf[len++] = ' ';
+            }
+        } else {
+            buf[len++] = ' ';
         }
 
-        std::sprintf(buf.data(), fmt, parts.first.c_str(), parts.second.c_str());
-
-        auto fh = fopen("/tmp/meow", "wb");
-
-        fwrite(parts.first.c_str(), 1, parts.first.size() + 1, fh);
-        fclose(fh);
+        std::memcpy(&buf[len], unit, unitLen + 1);
+        len += unitLen;
 
         if (customStyle) {
             this->_stylist().tableViewTextCell(*this, cell.emphasized());
         }
 
-        this->_drawCellAlignedText(contentPos, descr.contentWidth(), buf.data(),
-                                   std::strlen(buf.data()), customStyle, cell.textAlign());
+        this->_drawCellAlignedText(contentPos, descr.contentWidth(), buf.data(), len, customStyle,
+                                   cell.textAlign());
     } else if (const auto rCell = dynamic_cast<const IntTableViewCell *>(&cell)) {
         std::array<char, 32> buf;
         const char *fmt = nullptr;
@@ -250,26 +253,19 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
             assert(rCell->radix() == IntTableViewCell::Radix::DEC);
 
             if (intCell->sep()) {
-                std::sprintf(buf.data(), "%s", utils::sepNumber(intCell->val(), ',').c_str());
+                utils::sepNumber(buf.data(), intCell->val(), ',');
             } else {
-                fmt = "%lld";
-            }
-
-            if (fmt) {
-                std::sprintf(buf.data(), fmt, intCell->val());
+                utils::formatInt(buf.data(), intCell->val());
             }
         } else if (auto intCell = dynamic_cast<const UIntTableViewCell *>(&cell)) {
             assert(rCell->radix() == IntTableViewCell::Radix::DEC);
 
-            if (intCell->sep()) {
-                std::sprintf(buf.data(), "%s",
-                             utils::sepNumber(static_cast<long long>(intCell->val()), ',').c_str());
-            } else {
-                fmt = "%llu";
-            }
-
             if (fmt) {
                 std::sprintf(buf.data(), fmt, intCell->val());
+            } else if (intCell->sep()) {
+                utils::sepNumber(buf.data(), static_cast<long long>(intCell->val()), ',');
+            } else {
+                utils::formatUInt(buf.data(), intCell->val());
             }
         } else {
             std::abort();
@@ -299,8 +295,11 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
 
         case TsFmtMode::NS_FROM_ORIGIN:
         {
-            const auto parts = utils::formatNs(rCell->ts().nsFromOrigin(), ',');
-            const auto partsWidth = parts.first.size() + parts.second.size() + 4;
+            std::array<char, 32> secsBuf;
+            std::array<char, 32> nsBuf;
+            const auto lens = utils::formatNs(secsBuf.data(), nsBuf.data(),
+                                              rCell->ts().nsFromOrigin(), ',');
+            const auto partsWidth = lens.first + lens.second + 4;
             const auto startPos = Point {
                 contentPos.x + descr.contentWidth() - partsWidth, contentPos.y
             };
@@ -310,13 +309,13 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
             }
 
             this->_clearCell(contentPos, descr.contentWidth());
-            this->_moveAndPrint(startPos, "%s,", parts.first.c_str());
+            this->_moveAndPrint(startPos, "%s,", secsBuf.data());
 
             if (customStyle) {
                 this->_stylist().tableViewTsCellNsPart(*this, cell.emphasized());
             }
 
-            this->_print("%s", parts.second.c_str());
+            this->_print("%s", nsBuf.data());
 
             if (customStyle) {
                 this->_stylist().tableViewTextCell(*this, cell.emphasized());
@@ -328,13 +327,16 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
 
         case TsFmtMode::CYCLES:
         {
-            const auto str = utils::sepNumber(rCell->ts().cycles(), ',') + " cc";
+            auto len = utils::sepNumber(buf.data(), rCell->ts().cycles(), ',');
+
+            std::memcpy(&buf[len], " cc", 4);
+            len += 3;
 
             if (customStyle) {
                 this->_stylist().tableViewTextCell(*this, cell.emphasized());
             }
 
-            this->_drawCellAlignedText(contentPos, descr.contentWidth(), str.c_str(), str.size(),
+            this->_drawCellAlignedText(contentPos, descr.contentWidth(), buf.data(), len,
                                        customStyle, cell.textAlign());
             break;
         }
@@ -367,8 +369,12 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
 
         case TsFmtMode::NS_FROM_ORIGIN:
         {
-            const auto parts = utils::formatNs(rCell->absDuration().ns(), ',');
-            const auto partsWidth = parts.first.size() + parts.second.size() + 4;
+            std::array<char, 32> secsBuf;
+            std::array<char, 32> nsBuf;
+            const auto lens = utils::formatNs(secsBuf.data(), nsBuf.data(),
+                                              static_cast<long long>(rCell->absDuration().ns()),
+                                              ',');
+            const auto partsWidth = lens.first + lens.second + 4;
             const auto startPos = Point {
                 contentPos.x + descr.contentWidth() - partsWidth - (rCell->isNegative() ? 1 : 0),
                 contentPos.y
@@ -385,13 +391,13 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
                 this->_appendChar('-');
             }
 
-            this->_safePrint("%s,", parts.first.c_str());
+            this->_safePrint("%s,", secsBuf.data());
 
             if (customStyle) {
                 this->_stylist().tableViewTsCellNsPart(*this, cell.emphasized());
             }
 
-            this->_safePrint("%s", parts.second.c_str());
+            this->_safePrint("%s", nsBuf.data());
 
             if (customStyle) {
                 this->_stylist().tableViewTextCell(*this, cell.emphasized());
@@ -412,9 +418,17 @@ void TableView::_drawCell(const Point& contentPos, const TableViewColumnDescr& d
                 break;
             }
 
-            std::sprintf(buf.data(), "%s%s cc", rCell->isNegative() ? "-" : "",
-                         utils::sepNumber(rCell->absCycleDiff(), ',').c_str());
+        {
+            auto bufAt = buf.data();
+
+            if (rCell->isNegative()) {
+                *bufAt++ = '-';
+            }
+
+            bufAt += utils::sepNumber(bufAt, rCell->absCycleDiff(), ',');
+            std::memcpy(bufAt, " cc", 4);
             break;
+        }
 
         default:
             break;
@@ -27,10 +27,7 @@ TraceInfoView::TraceInfoView(const Rect& rect, const Stylist& stylist, InspectCm
     _appState {&appState},
     _appStateObserverGuard {appState, *this}
 {
-    this->_buildRows();
-    _rows = &_traceInfo[&appState.trace()];
-    this->_rowCount(_rows->size());
-    this->_drawRows();
+    // rows are built when shown: they require data stream file indexes
 }
 
 void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
@@ -45,9 +42,11 @@ void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
     _Rows rows;
 
     rows.push_back(std::make_unique<_SectionRow>("Paths"));
+    // the interned metadata may come from another trace: use the path of this one
     rows.push_back(std::make_unique<_StrPropRow>("Trace directory",
-                                                 metadata.path().parent_path().string()));
-    rows.push_back(std::make_unique<_StrPropRow>("Metadata stream", metadata.path().string()));
+                                                 trace.metadataPath().parent_path().string()));
+    rows.push_back(std::make_unique<_StrPropRow>("Metadata stream",
+                                                 trace.metadataPath().string()));
     rows.push_back(std::make_unique<_EmptyRow>());
     rows.push_back(std::make_unique<_SectionRow>("Data streams"));
 
@@ -68,7 +67,7 @@ void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
         ++dsfCount;
         pktCount += dsFile->pktCount();
 
-        for (const auto& entry : dsFile->pktIndexEntries()) {
+        dsFile->forEachPktIndexEntry([&](const auto& entry) {
             if (entry.expectedContentLen()) {
                 totalExpectedPktsContentLen += *entry.expectedContentLen();
             }
@@ -79,7 +78,7 @@ void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
 
             totalEffectivePktsContentLen += entry.effectiveContentLen();
             totalEffectivePktsTotalLen += entry.effectiveTotalLen();
-        }
+        });
 
         if (dsFile->pktCount() > 0) {
             const auto& dsId = dsFile->pktIndexEntry(0).dsId();
@@ -91,8 +90,8 @@ void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
                 ++dsfWithoutDsIdCount;
             }
 
-            const auto& firstpktIndexEntry = dsFile->pktIndexEntries().front();
-            const auto& lastpktIndexEntry = dsFile->pktIndexEntries().back();
+            const auto& firstpktIndexEntry = dsFile->pktIndexEntry(0);
+            const auto& lastpktIndexEntry = dsFile->pktIndexEntry(dsFile->pktCount() - 1);
             const auto& dsfFirstTs = firstpktIndexEntry.beginTs();
             const auto& dsfLastTs = lastpktIndexEntry.endTs();
 
@@ -212,7 +211,7 @@ void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
     const auto pMetadataStream = dynamic_cast<const yactfr::PacketizedMetadataStream *>(&metadata.stream());
 
     rows.push_back(std::make_unique<_StrPropRow>("Packetized", pMetadataStream ? "Yes" : "No"));
-    rows.push_back(std::make_unique<_StrPropRow>("Path", metadata.path().string()));
+    rows.push_back(std::make_unique<_StrPropRow>("Path", trace.metadataPath().string()));
     rows.push_back(std::make_unique<_DataLenPropRow>("Size", metadata.fileLen()));
 
     if (pMetadataStream) {
@@ -389,50 +388,73 @@ void TraceInfoView::_buildTraceInfoRows(const Trace& trace)
     _traceInfo[&trace] = std::move(rows);
 }
 
-void TraceInfoView::_buildRows()
+void TraceInfoView::_setRows()
 {
-    for (const auto& dsfState : _appState->dsFileStates()) {
-        this->_buildTraceInfoRows(dsfState->dsFile().trace());
+    const auto& trace = _appState->trace();
+
+    if (_traceInfo.find(&trace) == _traceInfo.end()) {
+        /*
+         * Normally a no-op: whatever shows this view or changes its
+         * trace requires those indexes first, as the user can stop
+         * waiting for them.
+         */
+        _appState->requireTraceDsFileIndexes(trace);
+        this->_buildTraceInfoRows(trace);
+        this->_setValOffsets(_traceInfo[&trace]);
     }
 
-    for (const auto& traceInfo : _traceInfo) {
-        Size longestKeySize = 0;
-        auto it = traceInfo.second.begin();
-        auto lastSectionIt = it;
-
-        const auto setValOffsets = [&longestKeySize, &lastSectionIt, &it]() {
-            while (lastSectionIt != it) {
-                if (const auto sRow = dynamic_cast<_PropRow *>(lastSectionIt->get())) {
-                    sRow->valOffset = longestKeySize + 2;
-                }
+    _rows = &_traceInfo[&trace];
+    this->_index(0);
+    this->_rowCount(_rows->size());
+}
 
-                ++lastSectionIt;
+void TraceInfoView::_setValOffsets(const _Rows& rows)
+{
+    Size longestKeySize = 0;
+    auto it = rows.begin();
+    auto lastSectionIt = it;
+
+    const auto setValOffsets = [&longestKeySize, &lastSectionIt, &it]() {
+        while (lastSectionIt != it) {
+            if (const auto sRow = dynamic_cast<_PropRow *>(lastSectionIt->get())) {
+                sRow->valOffset = longestKeySize + 2;
             }
 
-            longestKeySize = 0;
-            lastSectionIt = it;
-        };
+            ++lastSectionIt;
+        }
 
-        while (it != traceInfo.second.end()) {
-            const auto& row = *it;
+        longestKeySize = 0;
+        lastSectionIt = it;
+    };
 
-            if (const auto sRow = dynamic_cast<const _SectionRow *>(row.get())) {
-                setValOffsets();
-            } else if (const auto sRow = dynamic_cast<const _PropRow *>(row.get())) {
-                longestKeySize = std::max(longestKeySize, static_cast<Index>(sRow->key.size()));
-            }
+    while (it != rows.end()) {
+        const auto& row = *it;
 
-            ++it;
+        if (const auto sRow = dynamic_cast<const _SectionRow *>(row.get())) {
+            setValOffsets();
+        } else if (const auto sRow = dynamic_cast<const _PropRow *>(row.get())) {
+            longestKeySize = std::max(longestKeySize, static_cast<Index>(sRow->key.size()));
         }
 
-        setValOffsets();
+        ++it;
     }
+
+    setValOffsets();
 }
 
 void TraceInfoView::_drawRows()
 {
     this->_stylist().std(*this);
     this->_clearContent();
+
+    if (!_rows) {
+        if (!this->isVisible()) {
+            return;
+        }
+
+        this->_setRows();
+    }
+
     assert(this->_index() < this->_rowCount());
 
     for (Index index = this->_index(); index < this->_index() + this->contentRect().h; ++index) {
@@ -490,9 +512,12 @@ void TraceInfoView::_drawRows()
 void TraceInfoView::_appStateChanged(const Message msg)
 {
     if (msg == Message::ACTIVE_DS_FILE_AND_PKT_CHANGED) {
-        _rows = &_traceInfo[&_appState->trace()];
+        const auto it = _traceInfo.find(&_appState->trace());
+
+        // if not built yet, _drawRows() builds them once visible
+        _rows = it == _traceInfo.end() ? nullptr : &it->second;
         this->_index(0);
-        this->_rowCount(_rows->size());
+        this->_rowCount(_rows ? _rows->size() : 0);
         this->_redrawContent();
     }
 }
@@ -29,7 +29,7 @@ private:
     void _drawRows() override;
     void _appStateChanged(Message msg) override;
     void _buildTraceInfoRows(const Trace& metadata);
-    void _buildRows();
+    void _setRows();
 
 private:
     struct _Row
@@ -149,10 +149,15 @@ private:
 private:
     using _Rows = std::vector<std::unique_ptr<_Row>>;
 
+private:
+    void _setValOffsets(const _Rows& rows);
+
 private:
     InspectCmdState *_appState;
     ViewInspectCmdStateObserverGuard _appStateObserverGuard;
     std::unordered_map<const Trace *, _Rows> _traceInfo;
+
+    // `nullptr` until built for the active trace (see _setRows())
     const _Rows *_rows = nullptr;
 };
 
@@ -10,6 +10,7 @@
 #include <map>
 
 #include "data/trace.hpp"
+#include "data/metadata-intern-table.hpp"
 #include "app-state.hpp"
 #include "search-query.hpp"
 
@@ -29,6 +30,17 @@ AppState::AppState(const std::vector<bfs::path>& paths,
         tracePaths[path.parent_path()].push_back(path);
     }
 
+    // parse the distinct metadata of all the traces in parallel
+    {
+        std::vector<bfs::path> metadataPaths;
+
+        for (const auto& tracePathPathsPair : tracePaths) {
+            metadataPaths.push_back(tracePathPathsPair.first / "metadata");
+        }
+
+        MetadataInternTable::instance().preload(metadataPaths);
+    }
+
     // create traces
     for (const auto& tracePathPathsPair : tracePaths) {
         auto trace = std::make_unique<Trace>(tracePathPathsPair.second);
@@ -53,14 +65,23 @@ void AppState::gotoDsFile(const Index index)
         return;
     }
 
-    _activeDsFileStateIndex = index;
-    _activeDsFileState = _dsFileStates[index].get();
+    this->requireDsFileIndex(index);
+
+    auto& dsfState = *_dsFileStates[index];
 
-    if (_activeDsFileState->dsFile().pktCount() > 0 && !_activeDsFileState->hasActivePktState()) {
-        // go to first packet without notifying as we notify here
-        _activeDsFileState->_gotoPkt(0, false);
+    if (dsfState.dsFile().pktCount() > 0 && !dsfState.hasActivePktState()) {
+        /*
+         * Go to first packet without notifying as we notify here.
+         *
+         * Do it before changing the active data stream file state:
+         * creating the packet can throw.
+         */
+        dsfState._gotoPkt(0, false);
     }
 
+    _activeDsFileStateIndex = index;
+    _activeDsFileState = &dsfState;
+
     // notify
     this->_activeDsFileAndPktChanged();
 }
@@ -88,6 +109,80 @@ bool AppState::search(const SearchQuery& query)
     return this->activeDsFileState().search(query);
 }
 
+const GlobalTsIndex& AppState::globalTsIndex()
+{
+    if (!_globalTsIndex) {
+        this->requireAllDsFileIndexes();
+
+        std::vector<const DsFile *> dsFiles;
+
+        for (const auto& dsfState : _dsFileStates) {
+            dsFiles.push_back(&dsfState->dsFile());
+        }
+
+        _globalTsIndex = std::make_unique<const GlobalTsIndex>(dsFiles);
+    }
+
+    return *_globalTsIndex;
+}
+
+void AppState::requireDsFileIndex(const Index index)
+{
+    assert(index < _dsFileStates.size());
+    this->_requireDsFileIndex(index);
+}
+
+void AppState::requireAllDsFileIndexes()
+{
+    for (Index index = 0; index < _dsFileStates.size(); ++index) {
+        this->_requireDsFileIndex(index);
+    }
+}
+
+void AppState::requireTraceDsFileIndexes(const Trace& trace)
+{
+    for (Index index = 0; index < _dsFileStates.size(); ++index) {
+        if (&_dsFileStates[index]->trace() == &trace) {
+            this->_requireDsFileIndex(index);
+        }
+    }
+}
+
+Size AppState::gotoNsFromOriginInAllDsFiles(const long long nsFromOrigin)
+{
+    std::vector<const GlobalTsIndex::Entry *> entries;
+
+    this->globalTsIndex().entriesContainingNsFromOrigin(nsFromOrigin, entries);
+
+    /*
+     * Packets of the same data stream file can't overlap in a valid
+     * trace, but keep the first one we find (earliest beginning)
+     * anyway.
+     */
+    std::vector<bool> dsFileStateIsDone(_dsFileStates.size(), false);
+    Size count = 0;
+
+    for (const auto entry : entries) {
+        // globalTsIndex() gives the data stream files in this order
+        const auto dsfStateIndex = entry->dsFileIndex;
+        auto& dsfState = *_dsFileStates[dsfStateIndex];
+
+        assert(&dsfState.dsFile() == entry->dsFile);
+
+        if (dsFileStateIsDone[dsfStateIndex]) {
+            continue;
+        }
+
+        dsFileStateIsDone[dsfStateIndex] = true;
+
+        if (dsfState.gotoErBeforeOrAtNsFromOrigin(entry->pktIndexEntry(), nsFromOrigin)) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
 void AppState::_activeDsFileAndPktChanged()
 {
 }
@@ -100,4 +195,16 @@ void AppState::_curOffsetInPktChanged()
 {
 }
 
+Pkt& AppState::_pktAtIndex(DsFile& dsFile, const Index index,
+                           PktCheckpointsBuildListener& pktCheckpointsBuildListener)
+{
+    return dsFile.pktAtIndex(index, pktCheckpointsBuildListener);
+}
+
+void AppState::_requireDsFileIndex(const Index index)
+{
+    // no-op if already built
+    _dsFileStates[index]->dsFile().buildIndex();
+}
+
 } // namespace jacques
@@ -17,11 +17,12 @@
 #include "search-query.hpp"
 #include "data/pkt-checkpoints-build-listener.hpp"
 #include "data/trace.hpp"
+#include "data/global-ts-index.hpp"
 
 namespace jacques {
 
 /*
- * Common abstract application state for an inspection command.
+ * Common application state for an inspection command.
  *
  * This state (application model) guarantees the following:
  *
@@ -40,7 +41,8 @@ namespace jacques {
  * when the data stream file is empty, otherwise there's always at least
  * one available packet, but it could contain a decoding error.
  *
- * A concrete application state may implement:
+ * You may use this class directly (the `bench` command does) or a
+ * derived application state which implements:
  *
  * _activeDsFileAndPktChanged():
  *     Called when the active data stream file AND packet changed.
@@ -50,6 +52,15 @@ namespace jacques {
  *
  * _curOffsetInPktChanged():
  *     Called when the current offset in the active packet changed.
+ *
+ * _pktAtIndex():
+ *     Called to get a packet of a data stream file, creating it if
+ *     needed. The default implementation calls DsFile::pktAtIndex().
+ *
+ * _requireDsFileIndex():
+ *     Called when the index of a data stream file is needed: must
+ *     return once it's built. The default implementation calls
+ *     DsFile::buildIndex().
  */
 class AppState :
     boost::noncopyable
@@ -57,16 +68,34 @@ class AppState :
     friend class DsFileState;
     friend class PktState;
 
-protected:
+public:
     explicit AppState(const std::vector<boost::filesystem::path>& paths,
                       PktCheckpointsBuildListener& pktCheckpointsBuildListener);
 
-public:
     virtual ~AppState() = default;
     void gotoDsFile(Index index);
     void gotoPrevDsFile();
     void gotoNextDsFile();
     bool search(const SearchQuery& query);
+    Size gotoNsFromOriginInAllDsFiles(long long nsFromOrigin);
+    const GlobalTsIndex& globalTsIndex();
+
+    /*
+     * Makes sure that the index of the data stream file of the data
+     * stream file state at index `index` is built.
+     *
+     * gotoDsFile() and globalTsIndex() call this themselves.
+     */
+    void requireDsFileIndex(Index index);
+
+    // calls requireDsFileIndex() for all the data stream file states
+    void requireAllDsFileIndexes();
+
+    /*
+     * Calls requireDsFileIndex() for the data stream file states of
+     * which the data stream file belongs to `trace`.
+     */
+    void requireTraceDsFileIndexes(const Trace& trace);
 
     DsFileState& activeDsFileState() const noexcept
     {
@@ -187,12 +216,18 @@ protected:
     virtual void _activeDsFileAndPktChanged();
     virtual void _activePktChanged();
     virtual void _curOffsetInPktChanged();
+    virtual Pkt& _pktAtIndex(DsFile& dsFile, Index index,
+                             PktCheckpointsBuildListener& pktCheckpointsBuildListener);
+    virtual void _requireDsFileIndex(Index index);
 
 private:
     std::vector<std::unique_ptr<DsFileState>> _dsFileStates;
     DsFileState *_activeDsFileState;
     Index _activeDsFileStateIndex = 0;
     std::vector<std::unique_ptr<Trace>> _traces;
+
+    // built on first use: requires all the data stream file indexes
+    std::unique_ptr<const GlobalTsIndex> _globalTsIndex;
 };
 
 } // namespace jacques
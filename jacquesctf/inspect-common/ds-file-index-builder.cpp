@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "ds-file-index-builder.hpp"
+#include "data/pkt-index-entry.hpp"
+
+namespace jacques {
+
+DsFileIndexBuilder::DsFileIndexBuilder(const std::vector<DsFile *>& dsFiles, Size threadCount)
+{
+    for (Index index = 0; index < dsFiles.size(); ++index) {
+        _slots.push_back(std::make_unique<_Slot>(*dsFiles[index]));
+        _queue.push_back(index);
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    threadCount = std::min(threadCount, static_cast<Size>(_slots.size()));
+
+    for (Index i = 0; i < threadCount; ++i) {
+        _threads.emplace_back([this] {
+            this->_work();
+        });
+    }
+}
+
+DsFileIndexBuilder::~DsFileIndexBuilder()
+{
+    _isCanceled = true;
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void DsFileIndexBuilder::prioritize(const Index index)
+{
+    assert(index < _slots.size());
+
+    std::lock_guard<std::mutex> lock {_mutex};
+    const auto it = std::find(_queue.begin(), _queue.end(), index);
+
+    if (it == _queue.end()) {
+        // being indexed or done
+        return;
+    }
+
+    _queue.erase(it);
+    _queue.push_front(index);
+}
+
+DsFileIndexBuilder::Progress DsFileIndexBuilder::progress(const Index index) const noexcept
+{
+    assert(index < _slots.size());
+
+    const auto& slot = *_slots[index];
+
+    return {
+        slot.pktCount, slot.offsetBytes,
+        slot.hasSeqNum ? boost::make_optional<Index>(slot.seqNum) : boost::none,
+    };
+}
+
+void DsFileIndexBuilder::rethrowError(const Index index) const
+{
+    assert(this->isDone(index));
+
+    const auto& slot = *_slots[index];
+
+    if (slot.exc) {
+        std::rethrow_exception(slot.exc);
+    }
+}
+
+void DsFileIndexBuilder::_work()
+{
+    while (!_isCanceled) {
+        Index index;
+
+        {
+            std::lock_guard<std::mutex> lock {_mutex};
+
+            if (_queue.empty()) {
+                break;
+            }
+
+            index = _queue.front();
+            _queue.pop_front();
+        }
+
+        this->_build(*_slots[index]);
+    }
+}
+
+void DsFileIndexBuilder::_build(_Slot& slot)
+{
+    const auto progressFunc = [this, &slot](const PktIndexEntry& entry) {
+        if (_isCanceled) {
+            throw _Canceled {};
+        }
+
+        slot.pktCount = entry.indexInDsFile() + 1;
+        slot.offsetBytes = entry.offsetInDsFileBytes();
+
+        if (entry.seqNum()) {
+            slot.seqNum = *entry.seqNum();
+            slot.hasSeqNum = true;
+        } else {
+            slot.hasSeqNum = false;
+        }
+    };
+
+    try {
+        slot.dsFile->buildIndex(progressFunc);
+    } catch (const _Canceled&) {
+        // nobody will use this data stream file anymore
+        return;
+    } catch (...) {
+        // rethrown by rethrowError(), from the thread which needs it
+        slot.exc = std::current_exception();
+    }
+
+    slot.isDone.store(true, std::memory_order_release);
+    _doneCount.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace jacques
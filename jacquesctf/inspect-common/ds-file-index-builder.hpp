@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_INSPECT_COMMON_DS_FILE_INDEX_BUILDER_HPP
+#define _JACQUES_INSPECT_COMMON_DS_FILE_INDEX_BUILDER_HPP
+
+#include <cassert>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "aliases.hpp"
+#include "data/ds-file.hpp"
+
+namespace jacques {
+
+/*
+ * Thrown when something which waits for the index of a data stream
+ * file stops waiting before it's built.
+ */
+class DsFileIndexWaitCanceled final :
+    public std::exception
+{
+public:
+    const char *what() const noexcept override
+    {
+        return "Data stream file index wait canceled.";
+    }
+};
+
+/*
+ * Background data stream file index builder.
+ *
+ * As soon as you build it, a data stream file index builder starts
+ * worker threads which build the packet indexes of data stream files,
+ * in order, each data stream file being indexed by a single worker.
+ * prioritize() moves a data stream file which isn't being indexed yet
+ * to the front of the queue.
+ *
+ * Building the index of a data stream file only touches this data
+ * stream file, but the thread which uses the data stream files must
+ * not use one of which the index isn't built (see isDone()) at all.
+ *
+ * All the public methods are thread-safe. The data stream files must
+ * outlive the builder.
+ */
+class DsFileIndexBuilder final :
+    boost::noncopyable
+{
+public:
+    // progress of a single data stream file
+    struct Progress
+    {
+        // number of indexed packets so far
+        Size pktCount;
+
+        // offset of the last indexed packet
+        Index offsetBytes;
+
+        // sequence number of the last indexed packet, if any
+        boost::optional<Index> seqNum;
+    };
+
+public:
+    /*
+     * Builds a data stream file index builder for `dsFiles` and starts
+     * it immediately with `threadCount` worker threads (0 means the
+     * number of hardware threads).
+     */
+    explicit DsFileIndexBuilder(const std::vector<DsFile *>& dsFiles, Size threadCount = 0);
+
+    // cancels the remaining builds and waits for the worker threads
+    ~DsFileIndexBuilder();
+
+    /*
+     * Indexes the data stream file at index `index` as soon as a worker
+     * is available, unless it's already being indexed.
+     */
+    void prioritize(Index index);
+
+    /*
+     * Whether or not the index of the data stream file at index
+     * `index` is built (or failed to build; see rethrowError()).
+     */
+    bool isDone(const Index index) const noexcept
+    {
+        assert(index < _slots.size());
+        return _slots[index]->isDone.load(std::memory_order_acquire);
+    }
+
+    bool isAllDone() const noexcept
+    {
+        return _doneCount.load(std::memory_order_acquire) == _slots.size();
+    }
+
+    Progress progress(Index index) const noexcept;
+
+    /*
+     * Rethrows the error which building the index of the data stream
+     * file at index `index`, which must be done, threw, if any.
+     */
+    void rethrowError(Index index) const;
+
+    const DsFile& dsFile(const Index index) const noexcept
+    {
+        assert(index < _slots.size());
+        return *_slots[index]->dsFile;
+    }
+
+    Size dsFileCount() const noexcept
+    {
+        return _slots.size();
+    }
+
+private:
+    struct _Slot
+    {
+        explicit _Slot(DsFile& dsFile) noexcept :
+            dsFile {&dsFile}
+        {
+        }
+
+        DsFile * const dsFile;
+        std::atomic_bool isDone {false};
+        std::atomic<Size> pktCount {0};
+        std::atomic<Index> offsetBytes {0};
+        std::atomic<Index> seqNum {0};
+        std::atomic_bool hasSeqNum {false};
+
+        // only valid once done
+        std::exception_ptr exc;
+    };
+
+    // unwinds DsFile::buildIndex() when the builder is destroyed
+    struct _Canceled final
+    {
+    };
+
+private:
+    void _work();
+    void _build(_Slot& slot);
+
+private:
+    // unique pointers: `_Slot` contains atomics
+    std::vector<std::unique_ptr<_Slot>> _slots;
+
+    std::atomic<Size> _doneCount {0};
+    std::atomic_bool _isCanceled {false};
+    std::vector<std::thread> _threads;
+
+    // protects `_queue`
+    std::mutex _mutex;
+
+    // indexes of the data stream files to index, in order
+    std::deque<Index> _queue;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_INSPECT_COMMON_DS_FILE_INDEX_BUILDER_HPP
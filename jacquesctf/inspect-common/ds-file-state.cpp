@@ -56,7 +56,7 @@ PktState& DsFileState::_pktState(const Index index)
     }
 
     if (!_pktStates[index]) {
-        auto& pkt = _dsFile->pktAtIndex(index, *_pktCheckpointsBuildListener);
+        auto& pkt = _appState->_pktAtIndex(*_dsFile, index, *_pktCheckpointsBuildListener);
 
         _pktStates[index] = std::make_unique<PktState>(*_appState, _dsFile->metadata(), pkt);
     }
@@ -73,8 +73,11 @@ void DsFileState::_gotoPkt(const Index index, const bool notify)
         return;
     }
 
+    // creating the packet can throw: change nothing before
+    auto& pktState = this->_pktState(index);
+
     _activePktStateIndex = index;
-    _activePktState = &this->_pktState(index);
+    _activePktState = &pktState;
 
     if (notify && &_appState->activeDsFileState() == this) {
         _appState->_activePktChanged();
@@ -166,34 +169,22 @@ void DsFileState::gotoLastPktRegion()
     _activePktState->gotoLastPktRegion();
 }
 
-bool DsFileState::_gotoNextErWithProp(const std::function<bool (const Er&)>& cmpFunc,
-                                      const boost::optional<Index>& initPktIndex,
-                                      const boost::optional<Index>& initErIndex)
+DsFileState::ErPos DsFileState::nextErSearchStartPos()
 {
     if (!_activePktState) {
-        return false;
-    }
-
-    Index startPktIndex = _activePktStateIndex + 1;
-    boost::optional<Index> startErIndex = 0;
-
-    if (initPktIndex) {
-        startPktIndex = *initPktIndex;
+        return {0, 0};
     }
 
-    if (initErIndex) {
-        startErIndex = *initErIndex;
-    }
+    ErPos startPos {_activePktStateIndex + 1, 0};
 
-    if (_activePktState->pkt().erCount() > 0 && !initPktIndex && !initErIndex) {
+    if (_activePktState->pkt().erCount() > 0) {
         const auto curEr = _activePktState->curEr();
-        boost::optional<Index> erIndex;
 
         if (curEr) {
             if (curEr->indexInPkt() < _activePktState->pkt().erCount() - 1) {
                 // skip current event record
-                startPktIndex = _activePktStateIndex;
-                startErIndex = curEr->indexInPkt() + 1;
+                startPos.pktIndex = _activePktStateIndex;
+                startPos.erIndexInPkt = curEr->indexInPkt() + 1;
             }
         } else {
             const auto& firstEr = _activePktState->pkt().erAtIndexInPkt(0);
@@ -201,33 +192,126 @@ bool DsFileState::_gotoNextErWithProp(const std::function<bool (const Er&)>& cmp
             if (_activePktState->curOffsetInPktBits() <
                     firstEr.segment().offsetInPktBits()) {
                 // search active packet from beginning
-                startPktIndex = _activePktStateIndex;
+                startPos.pktIndex = _activePktStateIndex;
             }
         }
     }
 
-    for (auto pktIndex = startPktIndex; pktIndex < _dsFile->pktCount(); ++pktIndex) {
+    return startPos;
+}
+
+DsFileState::ErSearchResult DsFileState::findErWithProp(const std::function<bool (const Er&)>& cmpFunc,
+                                                        const ErPos& startPos,
+                                                        const std::function<bool ()>& isCanceledFunc)
+{
+    ErSearchResult result;
+    auto startErIndex = startPos.erIndexInPkt;
+
+    for (auto pktIndex = startPos.pktIndex; pktIndex < _dsFile->pktCount(); ++pktIndex) {
+        if (isCanceledFunc && isCanceledFunc()) {
+            result.resumePos = ErPos {pktIndex, startErIndex};
+            return result;
+        }
+
         auto& pkt = this->_pktState(pktIndex).pkt();
 
-        const auto itStartErIndex = startErIndex ? *startErIndex : 0;
+        const auto itStartErIndex = startErIndex;
 
-        startErIndex = boost::none;
-        assert(itStartErIndex < pkt.erCount());
+        startErIndex = 0;
 
         for (Index erIndex = itStartErIndex; erIndex < pkt.erCount(); ++erIndex) {
+            const auto checkCanceled = isCanceledFunc && erIndex > itStartErIndex &&
+                                       (erIndex - itStartErIndex) % 512 == 0;
+
+            if (checkCanceled && isCanceledFunc()) {
+                result.resumePos = ErPos {pktIndex, erIndex};
+                return result;
+            }
+
             const auto& er = pkt.erAtIndexInPkt(erIndex);
 
             if (cmpFunc(er)) {
-                const auto offsetInPktBits = er.segment().offsetInPktBits();
-
-                this->gotoPkt(pktIndex);
-                _activePktState->gotoPktRegionAtOffsetInPktBits(offsetInPktBits);
-                return true;
+                result.foundPos = ErPos {pktIndex, erIndex};
+                return result;
             }
         }
     }
 
-    return false;
+    return result;
+}
+
+void DsFileState::gotoEr(const ErPos& pos)
+{
+    assert(pos.pktIndex < _dsFile->pktCount());
+
+    this->gotoPkt(pos.pktIndex);
+    assert(pos.erIndexInPkt < _activePktState->pkt().erCount());
+
+    const auto& er = _activePktState->pkt().erAtIndexInPkt(pos.erIndexInPkt);
+
+    _activePktState->gotoPktRegionAtOffsetInPktBits(er.segment().offsetInPktBits());
+}
+
+bool DsFileState::_gotoNextErWithProp(const std::function<bool (const Er&)>& cmpFunc)
+{
+    if (!_activePktState) {
+        return false;
+    }
+
+    const auto result = this->findErWithProp(cmpFunc, this->nextErSearchStartPos());
+
+    if (!result.foundPos) {
+        return false;
+    }
+
+    this->gotoEr(*result.foundPos);
+    return true;
+}
+
+bool DsFileState::_gotoErBeforeOrAtTs(const PktIndexEntry& pktIndexEntry, const long long val,
+                                      const TimestampSearchQuery::Unit unit)
+{
+    auto& pkt = _appState->_pktAtIndex(*_dsFile, pktIndexEntry.indexInDsFile(),
+                                       *_pktCheckpointsBuildListener);
+
+    if (pkt.erCount() == 0) {
+        return false;
+    }
+
+    const Er *er = nullptr;
+
+    switch (unit) {
+    case TimestampSearchQuery::Unit::NS:
+        er = pkt.erBeforeOrAtNsFromOrigin(val);
+        break;
+
+    case TimestampSearchQuery::Unit::CYCLE:
+        er = pkt.erBeforeOrAtCycles(static_cast<unsigned long long>(val));
+        break;
+    }
+
+    if (!er) {
+        return false;
+    }
+
+    // `er` can become invalid through `this->gotoPkt()`
+    const auto offsetInPktBits = er->segment().offsetInPktBits();
+
+    if (!_activePktState || _activePktState->pkt().indexEntry() != pktIndexEntry) {
+        // change packet
+        this->gotoPkt(pktIndexEntry.indexInDsFile());
+    }
+
+    _activePktState->gotoPktRegionAtOffsetInPktBits(offsetInPktBits);
+    return true;
+}
+
+bool DsFileState::gotoErBeforeOrAtNsFromOrigin(const PktIndexEntry& pktIndexEntry,
+                                               const long long nsFromOrigin)
+{
+    assert(pktIndexEntry.indexInDsFile() < _dsFile->pktCount());
+    return this->_gotoErBeforeOrAtTs(pktIndexEntry, nsFromOrigin,
+                                     TimestampSearchQuery::Unit::NS);
 }
 
 bool DsFileState::search(const SearchQuery& query)
@@ -441,38 +525,7 @@ bool DsFileState::search(const SearchQuery& query)
             return false;
         }
 
-        auto& pkt = _dsFile->pktAtIndex(indexEntry->indexInDsFile(), *_pktCheckpointsBuildListener);
-
-        if (pkt.erCount() == 0) {
-            return false;
-        }
-
-        const Er *er = nullptr;
-
-        switch (sQuery->unit()) {
-        case TimestampSearchQuery::Unit::NS:
-            er = pkt.erBeforeOrAtNsFromOrigin(reqVal);
-            break;
-
-        case TimestampSearchQuery::Unit::CYCLE:
-            er = pkt.erBeforeOrAtCycles(static_cast<unsigned long long>(reqVal));
-            break;
-        }
-
-        if (!er) {
-            return false;
-        }
-
-        // `er` can become invalid through `this->gotoPkt()`
-        const auto offsetInPktBits = er->segment().offsetInPktBits();
-
-        if (_activePktState->pkt().indexEntry() != *indexEntry) {
-            // change packet
-            this->gotoPkt(indexEntry->indexInDsFile());
-        }
-
-        _activePktState->gotoPktRegionAtOffsetInPktBits(offsetInPktBits);
-        return true;
+        return this->_gotoErBeforeOrAtTs(*indexEntry, reqVal, sQuery->unit());
     }
 
     return false;
@@ -484,13 +537,13 @@ void DsFileState::analyzeAllPkts(PktCheckpointsBuildListener *buildListener)
         buildListener = _pktCheckpointsBuildListener;
     }
 
-    for (auto& pktIndexEntry : _dsFile->pktIndexEntries()) {
-        if (pktIndexEntry.erCount()) {
+    for (Index pktIndex = 0; pktIndex < _dsFile->pktCount(); ++pktIndex) {
+        if (_dsFile->pktIndexEntry(pktIndex).erCount()) {
             continue;
         }
 
         // this creates checkpoints and shows progress
-        _dsFile->pktAtIndex(pktIndexEntry.indexInDsFile(), *buildListener);
+        _dsFile->pktAtIndex(pktIndex, *buildListener);
     }
 }
 
@@ -32,6 +32,36 @@ class DsFileState final :
 {
     friend class AppState;
 
+public:
+    // position of an event record within a data stream file
+    struct ErPos
+    {
+        bool operator<(const ErPos& other) const noexcept
+        {
+            if (pktIndex != other.pktIndex) {
+                return pktIndex < other.pktIndex;
+            }
+
+            return erIndexInPkt < other.erIndexInPkt;
+        }
+
+        Index pktIndex;
+        Index erIndexInPkt;
+    };
+
+    // result of findErWithProp()
+    struct ErSearchResult
+    {
+        // position of the found event record, if any
+        boost::optional<ErPos> foundPos;
+
+        /*
+         * If the search was canceled: position of the next event record
+         * to check to continue it (no event record before it matches).
+         */
+        boost::optional<ErPos> resumePos;
+    };
+
 public:
     explicit DsFileState(AppState& appState, DsFile& dsFile,
                          PktCheckpointsBuildListener& pktCheckpointsBuildListener);
@@ -46,8 +76,40 @@ public:
     void gotoPktCtx();
     void gotoLastPktRegion();
     bool search(const SearchQuery& query);
+
+    /*
+     * Goes to the event record of the packet indexed by
+     * `pktIndexEntry` having the greatest timestamp which is less than
+     * or equal to `nsFromOrigin`.
+     *
+     * Returns whether or not the position changed.
+     */
+    bool gotoErBeforeOrAtNsFromOrigin(const PktIndexEntry& pktIndexEntry, long long nsFromOrigin);
+
     void analyzeAllPkts(PktCheckpointsBuildListener *buildListener = nullptr);
 
+    /*
+     * Position of the first event record which a "next event record"
+     * search considers from the current position.
+     */
+    ErPos nextErSearchStartPos();
+
+    /*
+     * Finds the first event record, at or after `startPos`, for which
+     * `cmpFunc` returns true.
+     *
+     * If `isCanceledFunc` is set, this method calls it periodically and
+     * stops searching when it returns true.
+     *
+     * This method doesn't change the current position.
+     */
+    ErSearchResult findErWithProp(const std::function<bool (const Er&)>& cmpFunc,
+                                  const ErPos& startPos,
+                                  const std::function<bool ()>& isCanceledFunc = {});
+
+    // goes to the event record at `pos`
+    void gotoEr(const ErPos& pos);
+
     DsFile& dsFile() noexcept
     {
         return *_dsFile;
@@ -151,9 +213,9 @@ public:
 private:
     PktState& _pktState(Index index);
     void _gotoPkt(Index index, bool notify);
-    bool _gotoNextErWithProp(const std::function<bool (const Er&)>& cmpFunc,
-                             const boost::optional<Index>& initPktIndex = boost::none,
-                             const boost::optional<Index>& initErIndex = boost::none);
+    bool _gotoNextErWithProp(const std::function<bool (const Er&)>& cmpFunc);
+    bool _gotoErBeforeOrAtTs(const PktIndexEntry& pktIndexEntry, long long val,
+                             TimestampSearchQuery::Unit unit);
 
 private:
     AppState *_appState;
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+#include <map>
+
+#include "find-all-search.hpp"
+#include "data/data-len.hpp"
+
+namespace jacques {
+
+namespace {
+
+std::vector<const DsFile *> appStateDsFiles(const AppState& appState)
+{
+    std::vector<const DsFile *> dsFiles;
+
+    for (const auto& dsFileState : appState.dsFileStates()) {
+        dsFiles.push_back(&dsFileState->dsFile());
+    }
+
+    return dsFiles;
+}
+
+std::vector<IncrErtSearch::Erts> matchingDsFileErts(const std::vector<const DsFile *>& dsFiles,
+                                                    const SearchQuery& query)
+{
+    assert(IncrErtSearch::isSupportedQuery(query));
+
+    // many data stream files usually share the same metadata
+    std::map<const Metadata *, IncrErtSearch::Erts> metadataErts;
+    std::vector<IncrErtSearch::Erts> dsFileErts;
+
+    for (const auto dsFile : dsFiles) {
+        auto ertsIt = metadataErts.find(&dsFile->metadata());
+
+        if (ertsIt == metadataErts.end()) {
+            ertsIt = metadataErts.insert({
+                &dsFile->metadata(), IncrErtSearch::matchingErts(query, dsFile->metadata())
+            }).first;
+        }
+
+        dsFileErts.push_back(ertsIt->second);
+    }
+
+    return dsFileErts;
+}
+
+} // namespace
+
+/*
+ * A unit totals at least 4 MiB: small enough for the first results to
+ * show up quickly and for the work to spread evenly, large enough to
+ * amortize the publication.
+ */
+FindAllSearch::FindAllSearch(const AppState& appState, const SearchQuery& query,
+                             const Size threadCount) :
+    _dsFiles {appStateDsFiles(appState)},
+    _dsFileErts {matchingDsFileErts(_dsFiles, query)},
+    _scanner {_dsFiles, 4_MiB, [this](const Index dsFileIndex) {
+        // nothing can match in a data stream file without matching types
+        return !_dsFileErts[dsFileIndex].empty();
+    }}
+{
+    _unitResults.resize(_scanner.units().size());
+    _dsFileResultCounts.resize(_dsFiles.size());
+    _scanner.start(threadCount, [this](const Index unitIndex, Index,
+                                       PktUnitScanner::WorkerIt& it) {
+        this->_scanUnit(unitIndex, it);
+
+        if (!_scanner.isCanceled()) {
+            this->_publish(unitIndex);
+        }
+    });
+}
+
+FindAllSearch::~FindAllSearch()
+{
+    // the workers use the members below `_scanner`
+    _scanner.cancel();
+    _scanner.join();
+}
+
+void FindAllSearch::_scanUnit(const Index unitIndex, PktUnitScanner::WorkerIt& it)
+{
+    const auto& unit = _scanner.units()[unitIndex];
+    const auto& dsFile = _scanner.dsFile(unit);
+
+    for (auto pktIndex = unit.beginPktIndex; pktIndex < unit.endPktIndex; ++pktIndex) {
+        if (_scanner.isCanceled()) {
+            return;
+        }
+
+        // the materialized entries belong to the user interface thread
+        this->_scanPkt(_unitResults[unitIndex], unit.dsFileIndex, it,
+                       dsFile.decodedPktIndexEntry(pktIndex));
+        ++_scannedPktCount;
+    }
+}
+
+void FindAllSearch::_scanPkt(_UnitResults& unitResults, const Index dsFileIndex,
+                             PktUnitScanner::WorkerIt& workerIt,
+                             const PktIndexEntry& pktIndexEntry)
+{
+    const auto& erts = _dsFileErts[dsFileIndex];
+    Index erIndexInPkt = 0;
+    Index erOffsetInPktBits = 0;
+
+    try {
+        auto& it = workerIt.seekPkt(*_dsFiles[dsFileIndex], pktIndexEntry);
+
+        while (it->kind() != yactfr::Element::Kind::PACKET_END) {
+            switch (it->kind()) {
+            case yactfr::Element::Kind::EVENT_RECORD_BEGINNING:
+                erOffsetInPktBits = it.offset() - pktIndexEntry.offsetInDsFileBits();
+                ++erIndexInPkt;
+                break;
+
+            case yactfr::Element::Kind::EVENT_RECORD_INFO:
+            {
+                const auto ert = it->asEventRecordInfoElement().type();
+
+                if (ert && std::binary_search(erts.begin(), erts.end(), ert)) {
+                    assert(erIndexInPkt > 0);
+                    unitResults.results.push_back({
+                        erOffsetInPktBits,
+                        static_cast<std::uint32_t>(dsFileIndex),
+                        static_cast<std::uint32_t>(pktIndexEntry.indexInDsFile()),
+                        static_cast<std::uint32_t>(erIndexInPkt - 1),
+                    });
+                }
+
+                break;
+            }
+
+            default:
+                break;
+            }
+
+            ++it;
+        }
+    } catch (const yactfr::DecodingError&) {
+        /*
+         * Keep what we have: like the inspection view, the results stop
+         * at the first decoding error of the packet.
+         *
+         * Any other error (I/O error, out of memory) makes the scanner
+         * cancel the search: see rethrowError().
+         */
+        ++_erroneousPktCount;
+    }
+}
+
+void FindAllSearch::_publish(const Index unitIndex)
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    _unitResults[unitIndex].isDone = true;
+
+    // publish all the complete units which follow the published ones
+    while (_nextUnitToPublish < _unitResults.size() &&
+            _unitResults[_nextUnitToPublish].isDone) {
+        auto& pubResults = _unitResults[_nextUnitToPublish].results;
+        const auto dsFileIndex = _scanner.units()[_nextUnitToPublish].dsFileIndex;
+
+        _results.insert(_results.end(), pubResults.begin(), pubResults.end());
+        _dsFileResultCounts[dsFileIndex] += pubResults.size();
+        pubResults.clear();
+        pubResults.shrink_to_fit();
+        ++_nextUnitToPublish;
+    }
+}
+
+Size FindAllSearch::resultCount() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _results.size();
+}
+
+FindAllSearch::Result FindAllSearch::result(const Index index) const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    assert(index < _results.size());
+    return _results[index];
+}
+
+Size FindAllSearch::resultCountInPkt(const Result& result) const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    // published results are sorted, and a unit contains whole packets
+    const auto range = std::equal_range(_results.begin(), _results.end(), result,
+                                        [](const auto& a, const auto& b) {
+        return std::make_pair(a.dsFileIndex, a.pktIndexInDsFile) <
+               std::make_pair(b.dsFileIndex, b.pktIndexInDsFile);
+    });
+
+    return range.second - range.first;
+}
+
+Size FindAllSearch::resultCountInDsFile(const Index dsFileIndex) const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    assert(dsFileIndex < _dsFileResultCounts.size());
+    return _dsFileResultCounts[dsFileIndex];
+}
+
+bool FindAllSearch::isDone() const
+{
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _scanner.isCanceled() || _nextUnitToPublish == _unitResults.size();
+}
+
+} // namespace jacques
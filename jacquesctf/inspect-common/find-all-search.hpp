@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_INSPECT_COMMON_FIND_ALL_SEARCH_HPP
+#define _JACQUES_INSPECT_COMMON_FIND_ALL_SEARCH_HPP
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+#include "app-state.hpp"
+#include "data/pkt-unit-scanner.hpp"
+#include "incr-ert-search.hpp"
+#include "search-query.hpp"
+
+namespace jacques {
+
+/*
+ * "Find all" event record type search.
+ *
+ * A "find all" search collects all the event records, in all the data
+ * stream files of an application state, having a type which an event
+ * record type name or ID search query matches.
+ *
+ * As soon as you build it, the search starts a packet unit scanner
+ * (see PktUnitScanner) of which the workers only keep the event record
+ * types and offsets of the packets they scan, so that they never touch
+ * the state which the user interface uses.
+ *
+ * The search publishes the results of a unit as soon as all the
+ * previous units are complete, therefore the published results are
+ * always sorted by data stream file index, packet index, and event
+ * record index, and never move once published: a user interface can
+ * show them while the search continues.
+ *
+ * All the public methods are thread-safe. The data stream files of the
+ * application state must have a built index and must outlive the
+ * search.
+ */
+class FindAllSearch final :
+    boost::noncopyable
+{
+public:
+    // compact: there can be millions of them
+    struct Result
+    {
+        std::uint64_t offsetInPktBits;
+        std::uint32_t dsFileIndex;
+        std::uint32_t pktIndexInDsFile;
+        std::uint32_t erIndexInPkt;
+    };
+
+public:
+    /*
+     * Builds a "find all" search for `query` (an ErtNameSearchQuery or
+     * ErtIdSearchQuery instance; see IncrErtSearch::isSupportedQuery())
+     * and starts it immediately with `threadCount` worker threads (0
+     * means the number of hardware threads).
+     */
+    explicit FindAllSearch(const AppState& appState, const SearchQuery& query,
+                           Size threadCount = 0);
+
+    // cancels the search and waits for the worker threads
+    ~FindAllSearch();
+
+    // number of published results
+    Size resultCount() const;
+
+    // published result at index `index`
+    Result result(Index index) const;
+
+    // number of published results in the packet of `result`
+    Size resultCountInPkt(const Result& result) const;
+
+    // number of published results in the data stream file `dsFileIndex`
+    Size resultCountInDsFile(Index dsFileIndex) const;
+
+    // whether or not all the results are published (or canceled)
+    bool isDone() const;
+
+    /*
+     * Rethrows the error which canceled the search, if any: call this
+     * once isDone() is true.
+     */
+    void rethrowError() const
+    {
+        _scanner.rethrowError();
+    }
+
+    void cancel() noexcept
+    {
+        _scanner.cancel();
+    }
+
+    // total number of packets to scan
+    Size pktCount() const noexcept
+    {
+        return _scanner.pktCount();
+    }
+
+    Size scannedPktCount() const noexcept
+    {
+        return _scannedPktCount;
+    }
+
+    // number of scanned packets which the search couldn't fully decode
+    Size erroneousPktCount() const noexcept
+    {
+        return _erroneousPktCount;
+    }
+
+private:
+    // results of a unit of the scanner
+    struct _UnitResults
+    {
+        // only valid until published
+        std::vector<Result> results;
+        bool isDone = false;
+    };
+
+private:
+    void _scanUnit(Index unitIndex, PktUnitScanner::WorkerIt& it);
+    void _scanPkt(_UnitResults& unitResults, Index dsFileIndex, PktUnitScanner::WorkerIt& it,
+                  const PktIndexEntry& pktIndexEntry);
+    void _publish(Index unitIndex);
+
+private:
+    const std::vector<const DsFile *> _dsFiles;
+
+    // matching event record types, per data stream file
+    const std::vector<IncrErtSearch::Erts> _dsFileErts;
+
+    PktUnitScanner _scanner;
+
+    // per unit of `_scanner`
+    std::vector<_UnitResults> _unitResults;
+
+    std::atomic<Size> _scannedPktCount {0};
+    std::atomic<Size> _erroneousPktCount {0};
+
+    // protects everything below and `_UnitResults::isDone`
+    mutable std::mutex _mutex;
+
+    Index _nextUnitToPublish = 0;
+    std::vector<Result> _results;
+    std::vector<Size> _dsFileResultCounts;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_INSPECT_COMMON_FIND_ALL_SEARCH_HPP
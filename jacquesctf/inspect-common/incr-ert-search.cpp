@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <algorithm>
+
+#include "incr-ert-search.hpp"
+
+namespace jacques {
+
+IncrErtSearch::IncrErtSearch(DsFileState& dsFileState) :
+    _dsFileState {&dsFileState},
+    _initStartPos {dsFileState.nextErSearchStartPos()}
+{
+}
+
+IncrErtSearch::Erts IncrErtSearch::matchingErts(const SearchQuery& query,
+                                                const Metadata& metadata)
+{
+    const auto nameQuery = dynamic_cast<const ErtNameSearchQuery *>(&query);
+    const auto idQuery = dynamic_cast<const ErtIdSearchQuery *>(&query);
+    Erts erts;
+
+    assert(nameQuery || idQuery);
+
+    for (auto& dst : metadata.traceType().dataStreamTypes()) {
+        for (auto& ert : dst->eventRecordTypes()) {
+            if (nameQuery) {
+                if (ert->name() && nameQuery->matches(*ert->name())) {
+                    erts.push_back(ert.get());
+                }
+            } else if (idQuery->val() >= 0 &&
+                    ert->id() == static_cast<yactfr::TypeId>(idQuery->val())) {
+                erts.push_back(ert.get());
+            }
+        }
+    }
+
+    std::sort(erts.begin(), erts.end());
+    return erts;
+}
+
+boost::optional<DsFileState::ErSearchResult> IncrErtSearch::_tryKnownResult(const Erts& erts,
+                                                                            DsFileState::ErPos& startPos) const
+{
+    if (erts.empty()) {
+        // nothing can match
+        return DsFileState::ErSearchResult {};
+    }
+
+    for (const auto& ertsResultPair : _results) {
+        const auto& knownErts = ertsResultPair.first;
+        const auto& result = ertsResultPair.second;
+
+        if (!std::includes(knownErts.begin(), knownErts.end(), erts.begin(), erts.end())) {
+            // not a superset: can't use it
+            continue;
+        }
+
+        if (result.foundPos) {
+            if (knownErts == erts) {
+                return result;
+            }
+
+            /*
+             * The first event record matching `erts` can't be before
+             * the first one matching the superset.
+             */
+            startPos = std::max(startPos, *result.foundPos);
+        } else if (result.resumePos) {
+            startPos = std::max(startPos, *result.resumePos);
+        } else {
+            // complete search for a superset found nothing
+            return result;
+        }
+    }
+
+    return boost::none;
+}
+
+bool IncrErtSearch::search(const SearchQuery& query, const IsCanceledFunc& isCanceledFunc)
+{
+    if (_dsFileState->dsFile().pktCount() == 0) {
+        return false;
+    }
+
+    auto erts = IncrErtSearch::matchingErts(query, _dsFileState->metadata());
+    auto startPos = _initStartPos;
+    auto result = this->_tryKnownResult(erts, startPos);
+
+    if (!result) {
+        const auto cmpFunc = [&erts](const Er& er) {
+            return er.type() && std::binary_search(erts.begin(), erts.end(), er.type());
+        };
+
+        result = _dsFileState->findErWithProp(cmpFunc, startPos, isCanceledFunc);
+        _results[std::move(erts)] = *result;
+    }
+
+    if (!result->foundPos) {
+        return false;
+    }
+
+    _dsFileState->gotoEr(*result->foundPos);
+    return true;
+}
+
+} // namespace jacques
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2018 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_INSPECT_COMMON_INCR_ERT_SEARCH_HPP
+#define _JACQUES_INSPECT_COMMON_INCR_ERT_SEARCH_HPP
+
+#include <vector>
+#include <map>
+#include <functional>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "ds-file-state.hpp"
+#include "search-query.hpp"
+
+namespace jacques {
+
+/*
+ * Incremental event record type search.
+ *
+ * An incremental event record type search finds the next event record
+ * having a type which an event record type name or ID search query
+ * matches, always from the same initial position (the one of the
+ * active packet state of the data stream file state when you build
+ * it), reusing the results of its previous searches. This is what a
+ * live search needs, as each new keystroke creates a new query.
+ *
+ * The key observation is that the metadata contains a finite set of
+ * event record types, so that a query is equivalent to the set of
+ * event record types it matches. For a new query having the set of
+ * event record types S:
+ *
+ * * If a previous search has the same set, we have the result already.
+ *
+ * * If a previous search, with a superset of S, didn't find anything,
+ *   then the new search won't find anything either.
+ *
+ * * If a previous search, with a superset of S, found an event record
+ *   at position P, or was canceled at position P without finding
+ *   anything before, then the new search can start at P.
+ *
+ * Narrowing a pattern while typing (for example, `sched*` to
+ * `sched_s*`) therefore continues scanning from the last match instead
+ * of restarting from the initial position.
+ */
+class IncrErtSearch final :
+    boost::noncopyable
+{
+public:
+    using IsCanceledFunc = std::function<bool ()>;
+
+    // sorted by address
+    using Erts = std::vector<const yactfr::EventRecordType *>;
+
+public:
+    explicit IncrErtSearch(DsFileState& dsFileState);
+
+    /*
+     * Searches the next event record with a type which `query` matches
+     * (an ErtNameSearchQuery or ErtIdSearchQuery instance) and goes to
+     * it if found.
+     *
+     * If `isCanceledFunc` is set and returns true during the search,
+     * this method returns false without changing the current position,
+     * remembering where it stopped for a subsequent search.
+     *
+     * Returns whether or not the search found an event record.
+     */
+    bool search(const SearchQuery& query, const IsCanceledFunc& isCanceledFunc = {});
+
+    static bool isSupportedQuery(const SearchQuery& query) noexcept
+    {
+        return dynamic_cast<const ErtNameSearchQuery *>(&query) ||
+               dynamic_cast<const ErtIdSearchQuery *>(&query);
+    }
+
+    /*
+     * Returns the event record types of `metadata` which `query` (an
+     * ErtNameSearchQuery or ErtIdSearchQuery instance) matches.
+     */
+    static Erts matchingErts(const SearchQuery& query, const Metadata& metadata);
+
+private:
+    boost::optional<DsFileState::ErSearchResult> _tryKnownResult(const Erts& erts,
+                                                                 DsFileState::ErPos& startPos) const;
+
+private:
+    DsFileState *_dsFileState;
+    const DsFileState::ErPos _initStartPos;
+    std::map<Erts, DsFileState::ErSearchResult> _results;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_INSPECT_COMMON_INCR_ERT_SEARCH_HPP
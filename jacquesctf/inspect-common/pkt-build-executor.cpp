@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+
+#include "pkt-build-executor.hpp"
+#include "data/er.hpp"
+
+namespace jacques {
+
+PktBuildExecutor::~PktBuildExecutor()
+{
+    if (_thread.joinable()) {
+        this->cancel();
+        _thread.join();
+    }
+}
+
+void PktBuildExecutor::start(std::unique_ptr<DsFile::PktBuild> build)
+{
+    assert(build);
+    assert(!_build);
+    _build = std::move(build);
+    _exc = nullptr;
+    _isDone = false;
+    _isCanceled = false;
+    _erCount = 0;
+    _erOffsetInPktBits = 0;
+    _ert = nullptr;
+    _thread = std::thread {[this] {
+        this->_run();
+    }};
+}
+
+void PktBuildExecutor::cancel() noexcept
+{
+    _isCanceled = true;
+}
+
+std::unique_ptr<DsFile::PktBuild> PktBuildExecutor::finish()
+{
+    assert(_build);
+    _thread.join();
+
+    auto build = std::move(_build);
+
+    if (_exc) {
+        std::rethrow_exception(_exc);
+    }
+
+    /*
+     * The build could complete right after the cancellation request:
+     * honor the request anyway, as the user expects it.
+     */
+    if (_isCanceled) {
+        throw PktBuildCanceled {};
+    }
+
+    return build;
+}
+
+void PktBuildExecutor::_run()
+{
+    _Listener listener {*this};
+
+    try {
+        _build->create(listener);
+    } catch (...) {
+        // rethrown by finish(), from the thread of the data stream file
+        _exc = std::current_exception();
+    }
+
+    _isDone = true;
+}
+
+void PktBuildExecutor::_Listener::_update(const Er& er)
+{
+    if (_executor->_isCanceled) {
+        // unwinds the packet creation (see DsFile::PktBuild::create())
+        throw PktBuildCanceled {};
+    }
+
+    _executor->_erOffsetInPktBits = er.segment().offsetInPktBits();
+    _executor->_ert = er.type();
+    _executor->_erCount = er.indexInPkt() + 1;
+}
+
+} // namespace jacques
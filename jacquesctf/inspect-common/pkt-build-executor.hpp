@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_INSPECT_COMMON_PKT_BUILD_EXECUTOR_HPP
+#define _JACQUES_INSPECT_COMMON_PKT_BUILD_EXECUTOR_HPP
+
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "aliases.hpp"
+#include "data/ds-file.hpp"
+#include "data/pkt-index-entry.hpp"
+#include "data/pkt-checkpoints-build-listener.hpp"
+
+namespace jacques {
+
+// thrown by PktBuildExecutor::finish() when the build was canceled
+class PktBuildCanceled final :
+    public std::exception
+{
+public:
+    const char *what() const noexcept override
+    {
+        return "Packet build canceled.";
+    }
+};
+
+/*
+ * Packet build executor.
+ *
+ * A packet build executor creates the packet of a packet build (see
+ * DsFile::PktBuild) on a background thread, so that the thread which
+ * owns the data stream file remains free to handle user input and to
+ * show the progress of the build meanwhile.
+ *
+ * There's at most one current build. isDone(), progress(), and cancel()
+ * are thread-safe.
+ */
+class PktBuildExecutor final :
+    boost::noncopyable
+{
+public:
+    // last decoded event record
+    struct Progress
+    {
+        // no value: no event record yet
+        boost::optional<Index> erIndexInPkt;
+
+        Index erOffsetInPktBits;
+
+        // may be `nullptr`
+        const yactfr::EventRecordType *ert;
+    };
+
+public:
+    explicit PktBuildExecutor() = default;
+
+    // cancels the current build, if any, and waits for it
+    ~PktBuildExecutor();
+
+    // starts the build `build`; there must be no current build
+    void start(std::unique_ptr<DsFile::PktBuild> build);
+
+    // requests the cancellation of the current build
+    void cancel() noexcept;
+
+    /*
+     * Waits for the current build to be done and returns it, ready for
+     * DsFile::addPkt().
+     *
+     * Throws PktBuildCanceled if the build was canceled, or the error
+     * which the build threw, if any. Either way, there's no current
+     * build afterwards.
+     */
+    std::unique_ptr<DsFile::PktBuild> finish();
+
+    bool hasBuild() const noexcept
+    {
+        return static_cast<bool>(_build);
+    }
+
+    // whether or not the current build is complete, failed, or canceled
+    bool isDone() const noexcept
+    {
+        return _isDone;
+    }
+
+    Progress progress() const noexcept
+    {
+        const Size erCount = _erCount;
+
+        return {
+            erCount == 0 ? boost::none : boost::make_optional(erCount - 1),
+            _erOffsetInPktBits, _ert,
+        };
+    }
+
+    const PktIndexEntry& pktIndexEntry() const noexcept
+    {
+        assert(_build);
+        return _build->pktIndexEntry();
+    }
+
+private:
+    // publishes the progress and cancels the build when requested
+    class _Listener final :
+        public PktCheckpointsBuildListener
+    {
+    public:
+        explicit _Listener(PktBuildExecutor& executor) noexcept :
+            _executor {&executor}
+        {
+        }
+
+    private:
+        void _update(const Er& er) override;
+
+    private:
+        PktBuildExecutor * const _executor;
+    };
+
+private:
+    void _run();
+
+private:
+    std::unique_ptr<DsFile::PktBuild> _build;
+    std::thread _thread;
+    std::exception_ptr _exc;
+    std::atomic_bool _isDone {false};
+    std::atomic_bool _isCanceled {false};
+    std::atomic<Size> _erCount {0};
+    std::atomic<Index> _erOffsetInPktBits {0};
+    std::atomic<const yactfr::EventRecordType *> _ert {nullptr};
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_INSPECT_COMMON_PKT_BUILD_EXECUTOR_HPP
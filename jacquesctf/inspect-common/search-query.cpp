@@ -52,7 +52,8 @@ TimestampSearchQuery::TimestampSearchQuery(const bool isDiff, const long long va
 
 ErtNameSearchQuery::ErtNameSearchQuery(std::string pattern) :
     SearchQuery {false},
-    _pattern {std::move(pattern)}
+    _pattern {std::move(pattern)},
+    _globPattern {_pattern}
 {
 }
 
@@ -303,8 +304,7 @@ std::unique_ptr<const SearchQuery> parseErtName(std::string::const_iterator& it,
     it = end;
 
     // normalize pattern (no consecutive `*`)
-    utils::normalizeGlobPattern(pattern);
-    return std::make_unique<const ErtNameSearchQuery>(std::move(pattern));
+    return std::make_unique<const ErtNameSearchQuery>(utils::normalizeGlobPattern(pattern));
 }
 
 } // namespace
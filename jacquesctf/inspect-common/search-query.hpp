@@ -13,6 +13,7 @@
 #include <boost/optional.hpp>
 
 #include "utils.hpp"
+#include "glob-pattern.hpp"
 
 namespace jacques {
 
@@ -127,11 +128,12 @@ public:
 
     bool matches(const std::string& candidate) const noexcept
     {
-        return utils::globMatch(_pattern, candidate);
+        return _globPattern.matches(candidate);
     }
 
 private:
     const std::string _pattern;
+    const GlobPattern _globPattern;
 };
 
 class ErtIdSearchQuery final :
@@ -20,6 +20,11 @@
 #include "list-pkts-cmd.hpp"
 #include "copy-pkts-cmd.hpp"
 #include "create-lttng-index-cmd.hpp"
+#include "stats-cmd.hpp"
+#include "export-cmd.hpp"
+#include "trim-cmd.hpp"
+#include "verify-cmd.hpp"
+#include "bench-cmd.hpp"
 
 #ifdef JACQUES_HAS_INSPECT_CMD
 # include "inspect-cmd/ui/inspect-cmd.hpp"
@@ -108,6 +113,149 @@ void printCliUsage(const char * const cmdName)
     std::puts("");
     std::puts("If PATH is a CTF data stream file, use this file.");
     std::puts("If PATH is a directory, use all the CTF data stream files found recursively.");
+    std::puts("");
+    std::puts("`stats` command");
+    std::puts("¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯");
+    std::puts("Usage: stats [--format=FMT] [--bucket-duration=NS] [--threads=N] PATH...");
+    std::puts("");
+    std::puts("Decode all the event records of the specified CTF data stream files and print,");
+    std::puts("per trace and event record type:");
+    std::puts("");
+    std::puts("* The event record count, and the total, minimum, average, and maximum");
+    std::puts("  event record sizes.");
+    std::puts("");
+    std::puts("* The event record count and rate within each time bucket.");
+    std::puts("");
+    std::puts("Also print, for each packet, the number of event records which the tracer");
+    std::puts("discarded since the previous packet of its data stream file.");
+    std::puts("");
+    std::puts("If PATH is a CTF data stream file, use this file.");
+    std::puts("If PATH is a directory, use all the CTF data stream files found recursively.");
+    std::puts("");
+    std::puts("With the CSV format, print three tables (event record types, rates, and");
+    std::puts("discarded event records), each one with a header, separated by an empty line.");
+    std::puts("");
+    std::puts("Options:");
+    std::puts("");
+    std::puts("  --bucket-duration=NS, -b NS  Set the time bucket duration to NS ns");
+    std::puts("                               (default: 1000000000)");
+    std::puts("  --format=FMT, -f FMT         Set the output format to FMT (`csv` (default)");
+    std::puts("                               or `json`)");
+    std::puts("  --threads=N, -j N            Decode with N threads (default: number of");
+    std::puts("                               hardware threads)");
+    std::puts("");
+    std::puts("`export` command");
+    std::puts("¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯");
+    std::puts("Usage: export [--format=FMT] [--name=PATTERN] [--id=ID] [--output=OUT]");
+    std::puts("              [--threads=N] PATH...");
+    std::puts("");
+    std::puts("Export the event records of the specified CTF data stream files, in data");
+    std::puts("stream file, packet, and event record order.");
+    std::puts("");
+    std::puts("If PATH is a CTF data stream file, use this file.");
+    std::puts("If PATH is a directory, use all the CTF data stream files found recursively.");
+    std::puts("");
+    std::puts("Output formats:");
+    std::puts("");
+    std::puts("`csv`:");
+    std::puts("    One row per event record field, with a header.");
+    std::puts("");
+    std::puts("`jsonl`:");
+    std::puts("    One JSON object per line per event record, its fields being an array of");
+    std::puts("    name and value pairs.");
+    std::puts("");
+    std::puts("Options:");
+    std::puts("");
+    std::puts("  --format=FMT, -f FMT       Set the output format to FMT (`csv` (default) or");
+    std::puts("                             `jsonl`)");
+    std::puts("  --id=ID, -i ID             Only export the event records having the type ID");
+    std::puts("  --name=PATTERN, -n PATTERN Only export the event records having a type name");
+    std::puts("                             which matches the globbing pattern PATTERN");
+    std::puts("  --output=OUT, -o OUT       Write to the file OUT instead of the standard");
+    std::puts("                             output");
+    std::puts("  --threads=N, -j N          Decode with N threads (default: number of");
+    std::puts("                             hardware threads)");
+    std::puts("");
+    std::puts("`trim` command");
+    std::puts("¯¯¯¯¯¯¯¯¯¯¯¯¯¯");
+    std::puts("Usage: trim [--begin=TIME] [--end=TIME] [--threads=N] TRACE-DIR OUT-DIR");
+    std::puts("");
+    std::puts("Copy the packets of all the CTF data stream files found recursively in");
+    std::puts("TRACE-DIR which overlap a given time range to the same relative paths within");
+    std::puts("OUT-DIR, as well as the CTF metadata files, and create an LTTng index file for");
+    std::puts("each new CTF data stream file.");
+    std::puts("");
+    std::puts("OUT-DIR must not exist or be empty.");
+    std::puts("");
+    std::puts("This command doesn't decode any packet content: it only copies whole packets.");
+    std::puts("");
+    std::puts("TIME is a number of nanoseconds from the clock origin (for example,");
+    std::puts("`1546300800500000000`), or a number of seconds from the clock origin if it");
+    std::puts("contains a fractional part (for example, `1546300800.5`).");
+    std::puts("");
+    std::puts("Options:");
+    std::puts("");
+    std::puts("  --begin=TIME, -b TIME  Set the beginning of the time range to TIME");
+    std::puts("  --end=TIME, -e TIME    Set the end of the time range to TIME");
+    std::puts("  --threads=N, -j N      Copy with N threads (default: number of hardware");
+    std::puts("                         threads)");
+    std::puts("");
+    std::puts("`verify` command");
+    std::puts("¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯");
+    std::puts("Usage: verify [--threads=N] PATH...");
+    std::puts("");
+    std::puts("Fully decode all the packets of the CTF data stream files PATH (or of all the");
+    std::puts("CTF data stream files found recursively in the directories PATH) and report:");
+    std::puts("");
+    std::puts("* Invalid packets.");
+    std::puts("* Decoding errors, with their offsets.");
+    std::puts("* Packet sequence number gaps.");
+    std::puts("* Discarded event records.");
+    std::puts("* Non-monotonic packet timestamps and clock values.");
+    std::puts("");
+    std::puts("Exit with status 1 if there's at least one problem.");
+    std::puts("");
+    std::puts("Options:");
+    std::puts("");
+    std::puts("  --threads=N, -j N  Decode with N threads (default: number of hardware");
+    std::puts("                     threads)");
+    std::puts("");
+    std::puts("`bench` command");
+    std::puts("¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯");
+    std::puts("Usage: bench [--streams=N] [--packets=N] [--packet-size=SIZE]");
+    std::puts("             [--ert-count=N] [--er-size=SIZE] [--corrupt=N] [--threads=N]");
+    std::puts("             [WORK-DIR]");
+    std::puts("");
+    std::puts("Write a synthetic CTF 1.8 trace, then time the main operations of Jacques CTF");
+    std::puts("on it (index building, packet checkpoint creation, packet region cache");
+    std::puts("fills, searches, and the `stats`, `export`, `verify`, `list-packets`,");
+    std::puts("`copy-packets`, `create-lttng-index`, and `trim` commands) and print, for each");
+    std::puts("one, its throughput in packets/s, event records/s, and MB/s, as well as the");
+    std::puts("peak resident set size of the process after it.");
+    std::puts("");
+    std::puts("Then compare, with micro-benchmarks, compiled globbing patterns to");
+    std::puts("utils::globMatch() (failing if they don't agree), and the allocation-free");
+    std::puts("formatting functions of table view cells to their former snprintf() based");
+    std::puts("versions.");
+    std::puts("");
+    std::puts("The synthetic trace is written to WORK-DIR/trace if WORK-DIR is specified (it");
+    std::puts("must not exist or be empty), or to a temporary directory which this command");
+    std::puts("removes otherwise. The same options always produce the same trace.");
+    std::puts("The `copy-packets`, `create-lttng-index`, and `trim` commands write their");
+    std::puts("output to WORK-DIR/copy, WORK-DIR/trace/index, and WORK-DIR/trim.");
+    std::puts("");
+    std::puts("Options:");
+    std::puts("");
+    std::puts("  --corrupt=N          Give an unknown type ID to an event record of N packets,");
+    std::puts("                       evenly spread (default: 0)");
+    std::puts("  --er-size=SIZE       Make each event record SIZE bytes long (default: 64;");
+    std::puts("                       minimum: 25)");
+    std::puts("  --ert-count=N        Create N event record types (default: 16)");
+    std::puts("  --packet-size=SIZE   Make each packet SIZE bytes long (default: 65536)");
+    std::puts("  --packets=N          Write N packets per data stream file (default: 256)");
+    std::puts("  --streams=N          Write N data stream files (default: 4)");
+    std::puts("  --threads=N, -j N    Use N threads for the parallel operations (default:");
+    std::puts("                       number of hardware threads)");
 }
 
 void printVersion()
@@ -131,6 +279,16 @@ void jacques(const int argc, const char *argv[])
         copyPktsCmd(*specCfg);
     } else if (const auto specCfg = dynamic_cast<const CreateLttngIndexCfg *>(cfg.get())) {
         createLttngIndexCmd(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const StatsCfg *>(cfg.get())) {
+        statsCmd(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const ExportCfg *>(cfg.get())) {
+        exportCmd(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const TrimCfg *>(cfg.get())) {
+        trimCmd(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const VerifyCfg *>(cfg.get())) {
+        verifyCmd(*specCfg);
+    } else if (const auto specCfg = dynamic_cast<const BenchCfg *>(cfg.get())) {
+        benchCmd(*specCfg);
     } else if (const auto specCfg = dynamic_cast<const InspectCfg *>(cfg.get())) {
 #ifdef JACQUES_HAS_INSPECT_CMD
         inspectCmd(*specCfg);
@@ -109,9 +109,9 @@ void listPktsCmd(const ListPktsCfg& cfg)
         printHeader(cfg.format());
     }
 
-    for (const auto& indexEntry : dsf.pktIndexEntries()) {
+    dsf.forEachPktIndexEntry([&cfg](const auto& indexEntry) {
         printRow(indexEntry, cfg.format());
-    }
+    });
 }
 
 } // namespace jacques
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <boost/endian/buffers.hpp>
+
+#include "lttng-index-writer.hpp"
+#include "cmd-error.hpp"
+
+namespace jacques {
+
+namespace bendian = boost::endian;
+
+namespace {
+
+struct LTTngIndexHeader {
+    bendian::big_uint32_buf_t magic;
+    bendian::big_uint32_buf_t indexMajor;
+    bendian::big_uint32_buf_t indexMinor;
+    bendian::big_uint32_buf_t indexEntrySizeBytes;
+};
+
+struct LTTngIndexEntryBase {
+    bendian::big_uint64_buf_t offsetBytes;
+    bendian::big_uint64_buf_t totalLenBits;
+    bendian::big_uint64_buf_t contentLenBits;
+    bendian::big_uint64_buf_t beginTs;
+    bendian::big_uint64_buf_t endTs;
+    bendian::big_uint64_buf_t discErCounterSnap;
+    bendian::big_uint64_buf_t dstId;
+};
+
+struct LTTngIndexEntry11Addon {
+    bendian::big_uint64_buf_t dsId;
+    bendian::big_uint64_buf_t seqNum;
+};
+
+static_assert(sizeof(LTTngIndexHeader) == 4 * 4,
+              "LTTng index header structure has the expected size.");
+static_assert(sizeof(LTTngIndexEntryBase) == 7 * 8,
+              "LTTng index entry base structure has the expected size.");
+static_assert(sizeof(LTTngIndexEntry11Addon) == 2 * 8,
+              "LTTng index entry v1.1 addon structure has the expected size.");
+
+template <typename DataT>
+void writeData(std::ofstream& os, const DataT& data)
+{
+    os.write(reinterpret_cast<const char *>(&data), sizeof(data));
+}
+
+} // namespace
+
+LttngIndexWriter::LttngIndexWriter(const boost::filesystem::path& path, const bool with11Addon) :
+    _with11Addon {with11Addon}
+{
+    _stream.exceptions(std::ios::badbit | std::ios::failbit);
+
+    try {
+        _stream.open(path.c_str(), std::ios::binary);
+
+        LTTngIndexHeader header;
+
+        header.magic = 0xc1f1dcc1U;
+        header.indexMajor = 1;
+        header.indexMinor = 0;
+        header.indexEntrySizeBytes = sizeof(LTTngIndexEntryBase);
+
+        if (_with11Addon) {
+            header.indexMinor = 1;
+            header.indexEntrySizeBytes = header.indexEntrySizeBytes.value() +
+                                         sizeof(LTTngIndexEntry11Addon);
+        }
+
+        writeData(_stream, header);
+    } catch (const std::ios_base::failure& exc) {
+        throw CmdError {exc.what()};
+    }
+}
+
+void LttngIndexWriter::write(const PktIndexEntry& indexEntry, const Index offsetBytes)
+{
+    LTTngIndexEntryBase entryBase;
+
+    entryBase.offsetBytes = offsetBytes;
+    entryBase.totalLenBits = indexEntry.effectiveTotalLen().bits();
+    entryBase.contentLenBits = indexEntry.effectiveContentLen().bits();
+    entryBase.beginTs = 0;
+
+    if (indexEntry.beginTs()) {
+        entryBase.beginTs = indexEntry.beginTs()->cycles();
+    }
+
+    entryBase.endTs = 0;
+
+    if (indexEntry.endTs()) {
+        entryBase.endTs = indexEntry.endTs()->cycles();
+    }
+
+    entryBase.discErCounterSnap = 0;
+
+    if (indexEntry.discErCounterSnap()) {
+        entryBase.discErCounterSnap = *indexEntry.discErCounterSnap();
+    }
+
+    entryBase.dstId = 0;
+
+    if (indexEntry.dst()) {
+        entryBase.dstId = indexEntry.dst()->id();
+    }
+
+    try {
+        writeData(_stream, entryBase);
+
+        if (_with11Addon) {
+            LTTngIndexEntry11Addon addon;
+
+            assert(indexEntry.dsId());
+            assert(indexEntry.seqNum());
+            addon.dsId = *indexEntry.dsId();
+            addon.seqNum = *indexEntry.seqNum();
+            writeData(_stream, addon);
+        }
+    } catch (const std::ios_base::failure& exc) {
+        throw CmdError {exc.what()};
+    }
+}
+
+void LttngIndexWriter::close()
+{
+    try {
+        _stream.close();
+    } catch (const std::ios_base::failure& exc) {
+        throw CmdError {exc.what()};
+    }
+}
+
+} // namespace jacques
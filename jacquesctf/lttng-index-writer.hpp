@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_LTTNG_INDEX_WRITER_HPP
+#define _JACQUES_LTTNG_INDEX_WRITER_HPP
+
+#include <fstream>
+#include <boost/core/noncopyable.hpp>
+#include <boost/filesystem.hpp>
+
+#include "aliases.hpp"
+#include "data/pkt-index-entry.hpp"
+
+namespace jacques {
+
+/*
+ * LTTng index file writer.
+ *
+ * All the methods throw CmdError on I/O error.
+ */
+class LttngIndexWriter final :
+    boost::noncopyable
+{
+public:
+    /*
+     * Creates the LTTng index file `path` and writes its header.
+     *
+     * If `with11Addon` is true, then the index is an LTTng 1.1 index,
+     * which also contains the data stream ID and sequence number of
+     * each packet.
+     */
+    explicit LttngIndexWriter(const boost::filesystem::path& path, bool with11Addon);
+
+    /*
+     * Returns whether or not the entries of an index of which the first
+     * one is `firstEntry` can have the LTTng 1.1 addon.
+     */
+    static bool canHave11Addon(const PktIndexEntry& firstEntry) noexcept
+    {
+        return firstEntry.dsId() && firstEntry.seqNum();
+    }
+
+    /*
+     * Writes an entry for the packet of `indexEntry`, considering that
+     * this packet is at the offset `offsetBytes` within its data stream
+     * file.
+     */
+    void write(const PktIndexEntry& indexEntry, Index offsetBytes);
+
+    // writes an entry for the packet of `indexEntry`, where it is
+    void write(const PktIndexEntry& indexEntry)
+    {
+        this->write(indexEntry, indexEntry.offsetInDsFileBytes());
+    }
+
+    void close();
+
+private:
+    std::ofstream _stream;
+    bool _with11Addon;
+};
+
+} // namespace jacques
+
+#endif // _JACQUES_LTTNG_INDEX_WRITER_HPP
@@ -0,0 +1,549 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <boost/core/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "cfg.hpp"
+#include "stats-cmd.hpp"
+#include "utils.hpp"
+#include "data/trace.hpp"
+#include "data/metadata-intern-table.hpp"
+#include "data/ds-file.hpp"
+#include "data/data-len.hpp"
+#include "data/pkt-unit-scanner.hpp"
+#include "data/ts.hpp"
+
+namespace jacques {
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+// statistics of a single event record type within a trace
+struct ErtStats
+{
+    const yactfr::DataStreamType *dst = nullptr;
+    Size count = 0;
+    Size totalLenBits = 0;
+    Size minLenBits = std::numeric_limits<Size>::max();
+    Size maxLenBits = 0;
+
+    // bucket index to event record count
+    std::map<long long, Size> buckets;
+};
+
+using ErtStatsMap = std::unordered_map<const yactfr::EventRecordType *, ErtStats>;
+
+// data stream files of `traces`, in order
+std::vector<const DsFile *> tracesDsFiles(const std::vector<std::unique_ptr<Trace>>& traces)
+{
+    std::vector<const DsFile *> dsFiles;
+
+    for (const auto& trace : traces) {
+        for (const auto& dsFile : trace->dsFiles()) {
+            dsFiles.push_back(dsFile.get());
+        }
+    }
+
+    return dsFiles;
+}
+
+// index of the trace of each data stream file of `traces`, in order
+std::vector<Index> dsFileTraceIndexes(const std::vector<std::unique_ptr<Trace>>& traces)
+{
+    std::vector<Index> traceIndexes;
+
+    for (Index traceIndex = 0; traceIndex < traces.size(); ++traceIndex) {
+        traceIndexes.insert(traceIndexes.end(), traces[traceIndex]->dsFiles().size(),
+                            traceIndex);
+    }
+
+    return traceIndexes;
+}
+
+class StatsCollector final :
+    boost::noncopyable
+{
+public:
+    explicit StatsCollector(const std::vector<std::unique_ptr<Trace>>& traces,
+                            const unsigned long long bucketDurationNs) :
+        _traceCount {traces.size()},
+        _bucketDurationNs {static_cast<long long>(bucketDurationNs)},
+        _dsFiles {tracesDsFiles(traces)},
+        _dsFileTraceIndexes {dsFileTraceIndexes(traces)},
+        _scanner {_dsFiles, 4_MiB}
+    {
+    }
+
+    // collects the statistics of all the units with `threadCount` threads
+    void collect(const Size threadCount)
+    {
+        // each worker has its own statistics: merge them when done
+        std::vector<std::vector<ErtStatsMap>> workerStats(_scanner.workerCount(threadCount));
+
+        for (auto& stats : workerStats) {
+            stats.resize(_traceCount);
+        }
+
+        _scanner.run(threadCount, [this, &workerStats](const Index unitIndex,
+                                                        const Index workerIndex,
+                                                        PktUnitScanner::WorkerIt& it) {
+            this->_scanUnit(workerStats[workerIndex], unitIndex, it);
+        });
+
+        _traceErtStats.resize(_traceCount);
+
+        for (const auto& stats : workerStats) {
+            for (Index traceIndex = 0; traceIndex < _traceCount; ++traceIndex) {
+                this->_merge(_traceErtStats[traceIndex], stats[traceIndex]);
+            }
+        }
+    }
+
+    // per trace
+    const std::vector<ErtStatsMap>& traceErtStats() const noexcept
+    {
+        return _traceErtStats;
+    }
+
+    Size erroneousPktCount() const noexcept
+    {
+        return _erroneousPktCount;
+    }
+
+private:
+    void _scanUnit(std::vector<ErtStatsMap>& stats, const Index unitIndex,
+                   PktUnitScanner::WorkerIt& it)
+    {
+        const auto& unit = _scanner.units()[unitIndex];
+        const auto& dsFile = _scanner.dsFile(unit);
+
+        for (auto pktIndex = unit.beginPktIndex; pktIndex < unit.endPktIndex; ++pktIndex) {
+            this->_scanPkt(stats[_dsFileTraceIndexes[unit.dsFileIndex]], dsFile, it,
+                           dsFile.decodedPktIndexEntry(pktIndex));
+        }
+    }
+
+    void _scanPkt(ErtStatsMap& stats, const DsFile& dsFile, PktUnitScanner::WorkerIt& workerIt,
+                  const PktIndexEntry& pktIndexEntry)
+    {
+        const auto isCorrelatable = dsFile.metadata().isCorrelatable();
+        Index erOffsetBits = 0;
+        const yactfr::EventRecordType *ert = nullptr;
+        boost::optional<long long> curNsFromOrigin;
+        boost::optional<long long> erNsFromOrigin;
+
+        try {
+            auto& it = workerIt.seekPkt(dsFile, pktIndexEntry);
+
+            while (it->kind() != yactfr::Element::Kind::PACKET_END) {
+                switch (it->kind()) {
+                case yactfr::Element::Kind::EVENT_RECORD_BEGINNING:
+                    erOffsetBits = it.offset();
+                    ert = nullptr;
+                    break;
+
+                case yactfr::Element::Kind::EVENT_RECORD_INFO:
+                    ert = it->asEventRecordInfoElement().type();
+
+                    // like Er: the last clock value before the info
+                    erNsFromOrigin = curNsFromOrigin;
+                    break;
+
+                case yactfr::Element::Kind::DEFAULT_CLOCK_VALUE:
+                    if (isCorrelatable) {
+                        assert(pktIndexEntry.dst());
+                        assert(pktIndexEntry.dst()->defaultClockType());
+                        curNsFromOrigin = Ts {
+                            it->asDefaultClockValueElement().cycles(),
+                            *pktIndexEntry.dst()->defaultClockType()
+                        }.nsFromOrigin();
+                    }
+
+                    break;
+
+                case yactfr::Element::Kind::EVENT_RECORD_END:
+                    if (ert) {
+                        this->_addEr(stats, *ert, pktIndexEntry.dst(),
+                                     it.offset() - erOffsetBits, erNsFromOrigin);
+                    }
+
+                    break;
+
+                default:
+                    break;
+                }
+
+                ++it;
+            }
+        } catch (const yactfr::DecodingError&) {
+            /*
+             * Keep what we have: the statistics stop at the first
+             * decoding error of the packet, like the inspection view.
+             *
+             * Any other error (I/O error, out of memory) makes the
+             * scanner cancel the scan and then rethrow it.
+             */
+            ++_erroneousPktCount;
+        }
+    }
+
+    void _addEr(ErtStatsMap& stats, const yactfr::EventRecordType& ert,
+                const yactfr::DataStreamType * const dst, const Size lenBits,
+                const boost::optional<long long>& nsFromOrigin)
+    {
+        auto& ertStats = stats[&ert];
+
+        ertStats.dst = dst;
+        ++ertStats.count;
+        ertStats.totalLenBits += lenBits;
+        ertStats.minLenBits = std::min(ertStats.minLenBits, lenBits);
+        ertStats.maxLenBits = std::max(ertStats.maxLenBits, lenBits);
+
+        if (nsFromOrigin) {
+            // floor division: the origin can follow the event record
+            auto bucket = *nsFromOrigin / _bucketDurationNs;
+
+            if (*nsFromOrigin < 0 && *nsFromOrigin % _bucketDurationNs != 0) {
+                --bucket;
+            }
+
+            ++ertStats.buckets[bucket];
+        }
+    }
+
+    static void _merge(ErtStatsMap& dst, const ErtStatsMap& src)
+    {
+        for (const auto& ertStatsPair : src) {
+            auto& dstStats = dst[ertStatsPair.first];
+            const auto& srcStats = ertStatsPair.second;
+
+            dstStats.dst = srcStats.dst;
+            dstStats.count += srcStats.count;
+            dstStats.totalLenBits += srcStats.totalLenBits;
+            dstStats.minLenBits = std::min(dstStats.minLenBits, srcStats.minLenBits);
+            dstStats.maxLenBits = std::max(dstStats.maxLenBits, srcStats.maxLenBits);
+
+            for (const auto& bucketCountPair : srcStats.buckets) {
+                dstStats.buckets[bucketCountPair.first] += bucketCountPair.second;
+            }
+        }
+    }
+
+private:
+    const Size _traceCount;
+    const long long _bucketDurationNs;
+    const std::vector<const DsFile *> _dsFiles;
+    const std::vector<Index> _dsFileTraceIndexes;
+
+    // same trade-off as the "find all" search
+    PktUnitScanner _scanner;
+
+    std::atomic<Size> _erroneousPktCount {0};
+    std::vector<ErtStatsMap> _traceErtStats;
+};
+
+// discarded event record count delta of a packet
+struct DiscErDelta
+{
+    Index natPktIndex;
+    unsigned long long count;
+};
+
+std::vector<DiscErDelta> discErDeltas(const DsFile& dsFile)
+{
+    std::vector<DiscErDelta> deltas;
+    boost::optional<unsigned long long> prevSnap;
+
+    for (Index pktIndex = 0; pktIndex < dsFile.pktCount(); ++pktIndex) {
+        const auto pktIndexEntry = dsFile.decodedPktIndexEntry(pktIndex);
+        const auto& snap = pktIndexEntry.discErCounterSnap();
+
+        /*
+         * A snapshot which is less than the previous one means the
+         * counter wrapped: we can't know by how much.
+         */
+        if (snap && prevSnap && *snap > *prevSnap) {
+            deltas.push_back({pktIndexEntry.natIndexInDsFile(), *snap - *prevSnap});
+        }
+
+        prevSnap = snap;
+    }
+
+    return deltas;
+}
+
+// event record types of `ertStats`, sorted by data stream type and ID
+std::vector<const yactfr::EventRecordType *> sortedErts(const ErtStatsMap& ertStats)
+{
+    std::vector<const yactfr::EventRecordType *> erts;
+
+    for (const auto& ertStatsPair : ertStats) {
+        erts.push_back(ertStatsPair.first);
+    }
+
+    std::sort(erts.begin(), erts.end(), [&ertStats](const auto a, const auto b) {
+        const auto aDst = ertStats.at(a).dst;
+        const auto bDst = ertStats.at(b).dst;
+        const auto aDstId = aDst ? aDst->id() : 0;
+        const auto bDstId = bDst ? bDst->id() : 0;
+
+        return std::make_pair(aDstId, a->id()) < std::make_pair(bDstId, b->id());
+    });
+
+    return erts;
+}
+
+std::string ertNameCsvField(const yactfr::EventRecordType& ert)
+{
+    return ert.name() ? utils::csvField(*ert.name()) : "";
+}
+
+std::string ertNameJson(const yactfr::EventRecordType& ert)
+{
+    return ert.name() ? utils::jsonStr(*ert.name()) : "null";
+}
+
+double avgLenBits(const ErtStats& ertStats)
+{
+    return static_cast<double>(ertStats.totalLenBits) / static_cast<double>(ertStats.count);
+}
+
+double bucketRate(const Size count, const unsigned long long bucketDurationNs)
+{
+    return static_cast<double>(count) * 1e9 / static_cast<double>(bucketDurationNs);
+}
+
+void printCsv(const std::vector<std::unique_ptr<Trace>>& traces,
+              const StatsCollector& collector, const unsigned long long bucketDurationNs)
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    // event record types
+    std::cout << "Trace directory,Data stream type ID,Event record type ID," <<
+                 "Event record type name,Count,Total size (bits),Min size (bits)," <<
+                 "Avg size (bits),Max size (bits)" << std::endl;
+
+    for (Index traceIndex = 0; traceIndex < traces.size(); ++traceIndex) {
+        const auto& ertStats = collector.traceErtStats()[traceIndex];
+        const auto traceDir = utils::csvField(traces[traceIndex]->metadataPath().parent_path().string());
+
+        for (const auto ert : sortedErts(ertStats)) {
+            const auto& stats = ertStats.at(ert);
+
+            std::cout << traceDir << ",";
+
+            if (stats.dst) {
+                std::cout << stats.dst->id();
+            }
+
+            std::cout << "," << ert->id() << "," << ertNameCsvField(*ert) << "," <<
+                         stats.count << "," << stats.totalLenBits << "," <<
+                         stats.minLenBits << "," << avgLenBits(stats) << "," <<
+                         stats.maxLenBits << std::endl;
+        }
+    }
+
+    // event record rates
+    std::cout << std::endl << "Trace directory,Data stream type ID,Event record type ID," <<
+                 "Event record type name,Bucket beginning (ns from origin),Count," <<
+                 "Rate (event records/s)" << std::endl;
+
+    for (Index traceIndex = 0; traceIndex < traces.size(); ++traceIndex) {
+        const auto& ertStats = collector.traceErtStats()[traceIndex];
+        const auto traceDir = utils::csvField(traces[traceIndex]->metadataPath().parent_path().string());
+
+        for (const auto ert : sortedErts(ertStats)) {
+            const auto& stats = ertStats.at(ert);
+
+            for (const auto& bucketCountPair : stats.buckets) {
+                std::cout << traceDir << ",";
+
+                if (stats.dst) {
+                    std::cout << stats.dst->id();
+                }
+
+                std::cout << "," << ert->id() << "," << ertNameCsvField(*ert) << "," <<
+                             bucketCountPair.first * static_cast<long long>(bucketDurationNs) <<
+                             "," << bucketCountPair.second << "," <<
+                             bucketRate(bucketCountPair.second, bucketDurationNs) << std::endl;
+            }
+        }
+    }
+
+    // discarded event records
+    std::cout << std::endl << "Data stream file path,Packet index," <<
+                 "Discarded event records" << std::endl;
+
+    for (const auto& trace : traces) {
+        for (const auto& dsFile : trace->dsFiles()) {
+            const auto path = utils::csvField(dsFile->path().string());
+
+            for (const auto& delta : discErDeltas(*dsFile)) {
+                std::cout << path << "," << delta.natPktIndex << "," << delta.count << std::endl;
+            }
+        }
+    }
+}
+
+void printJson(const std::vector<std::unique_ptr<Trace>>& traces,
+               const StatsCollector& collector, const unsigned long long bucketDurationNs)
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "{\"bucket-duration-ns\":" << bucketDurationNs <<
+                 ",\"erroneous-packet-count\":" << collector.erroneousPktCount() <<
+                 ",\"traces\":[";
+
+    for (Index traceIndex = 0; traceIndex < traces.size(); ++traceIndex) {
+        const auto& trace = *traces[traceIndex];
+        const auto& ertStats = collector.traceErtStats()[traceIndex];
+
+        if (traceIndex > 0) {
+            std::cout << ",";
+        }
+
+        std::cout << "{\"path\":" << utils::jsonStr(trace.metadataPath().parent_path().string()) <<
+                     ",\"event-record-types\":[";
+
+        auto isFirst = true;
+
+        for (const auto ert : sortedErts(ertStats)) {
+            const auto& stats = ertStats.at(ert);
+
+            if (!isFirst) {
+                std::cout << ",";
+            }
+
+            isFirst = false;
+            std::cout << "{\"data-stream-type-id\":";
+
+            if (stats.dst) {
+                std::cout << stats.dst->id();
+            } else {
+                std::cout << "null";
+            }
+
+            std::cout << ",\"id\":" << ert->id() << ",\"name\":" << ertNameJson(*ert) <<
+                         ",\"count\":" << stats.count <<
+                         ",\"total-size-bits\":" << stats.totalLenBits <<
+                         ",\"min-size-bits\":" << stats.minLenBits <<
+                         ",\"avg-size-bits\":" << avgLenBits(stats) <<
+                         ",\"max-size-bits\":" << stats.maxLenBits << ",\"buckets\":[";
+
+            auto isFirstBucket = true;
+
+            for (const auto& bucketCountPair : stats.buckets) {
+                if (!isFirstBucket) {
+                    std::cout << ",";
+                }
+
+                isFirstBucket = false;
+                std::cout << "{\"beginning-ns-from-origin\":" <<
+                             bucketCountPair.first * static_cast<long long>(bucketDurationNs) <<
+                             ",\"count\":" << bucketCountPair.second <<
+                             ",\"rate\":" << bucketRate(bucketCountPair.second, bucketDurationNs) <<
+                             "}";
+            }
+
+            std::cout << "]}";
+        }
+
+        std::cout << "],\"data-stream-files\":[";
+        isFirst = true;
+
+        for (const auto& dsFile : trace.dsFiles()) {
+            if (!isFirst) {
+                std::cout << ",";
+            }
+
+            isFirst = false;
+            std::cout << "{\"path\":" << utils::jsonStr(dsFile->path().string()) <<
+                         ",\"packet-count\":" << dsFile->pktCount() <<
+                         ",\"discarded-event-records\":[";
+
+            auto isFirstDelta = true;
+
+            for (const auto& delta : discErDeltas(*dsFile)) {
+                if (!isFirstDelta) {
+                    std::cout << ",";
+                }
+
+                isFirstDelta = false;
+                std::cout << "{\"packet-index\":" << delta.natPktIndex <<
+                             ",\"count\":" << delta.count << "}";
+            }
+
+            std::cout << "]}";
+        }
+
+        std::cout << "]}";
+    }
+
+    std::cout << "]}" << std::endl;
+}
+
+} // namespace
+
+void statsCmd(const StatsCfg& cfg)
+{
+    // trace directory to set of data stream file paths
+    std::map<bfs::path, std::vector<bfs::path>> groupedDsFilePaths;
+
+    for (auto& dsfPath : cfg.paths()) {
+        groupedDsFilePaths[dsfPath.parent_path()].push_back(dsfPath);
+    }
+
+    // parse the distinct metadata of all the traces in parallel
+    {
+        std::vector<bfs::path> metadataPaths;
+
+        for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+            metadataPaths.push_back(traceDirDsFilePathsPair.first / "metadata");
+        }
+
+        MetadataInternTable::instance().preload(metadataPaths, cfg.threadCount());
+    }
+
+    std::vector<std::unique_ptr<Trace>> traces;
+
+    for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+        traces.push_back(std::make_unique<Trace>(traceDirDsFilePathsPair.second));
+
+        for (auto& dsf : traces.back()->dsFiles()) {
+            dsf->buildIndex();
+        }
+    }
+
+    StatsCollector collector {traces, cfg.bucketDurationNs()};
+
+    collector.collect(cfg.threadCount());
+
+    if (cfg.format() == StatsCfg::Fmt::JSON) {
+        printJson(traces, collector, cfg.bucketDurationNs());
+    } else {
+        printCsv(traces, collector, cfg.bucketDurationNs());
+
+        if (collector.erroneousPktCount() > 0) {
+            std::cerr << "WARNING: " << collector.erroneousPktCount() <<
+                         " packet(s) could not be fully decoded." << std::endl;
+        }
+    }
+}
+
+} // namespace jacques
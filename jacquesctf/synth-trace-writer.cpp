@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "synth-trace-writer.hpp"
+#include "io-error.hpp"
+
+namespace jacques {
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+/*
+ * Layout of a synthetic packet (all integers are little-endian and
+ * byte-aligned, so that there's no padding between fields):
+ *
+ *     Packet header:
+ *         u32 magic
+ *         u32 stream_id
+ *
+ *     Packet context:
+ *         u64 timestamp_begin
+ *         u64 timestamp_end
+ *         u64 packet_size
+ *         u64 content_size
+ *         u64 events_discarded
+ *         u64 packet_seq_num
+ *
+ *     Event records:
+ *         u32 id
+ *         u64 timestamp
+ *         u64 seq
+ *         u32 value
+ *         string msg
+ *
+ *     Padding (zeros)
+ */
+constexpr Size erHeaderLenBytes = 4 + 8;
+constexpr Size erFixedPayloadLenBytes = 8 + 4;
+
+static_assert(minSynthErLenBytes == erHeaderLenBytes + erFixedPayloadLenBytes + 1,
+              "Minimal synthetic event record length is the length of an empty string one.");
+
+// no event record type has this ID
+constexpr std::uint32_t corruptErtId = 0xffffffffU;
+
+// timestamp (ns) increment between two event records of a stream
+constexpr std::uint64_t erTsStep = 1000;
+
+std::string metadataText(const SynthTraceParams& params)
+{
+    std::ostringstream ss;
+
+    ss << "/* CTF 1.8 */\n\n" <<
+          "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n" <<
+          "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n" <<
+          "typealias integer { size = 64; align = 8; signed = false; } := uint64_t;\n" <<
+          "typealias integer {\n" <<
+          "    size = 64; align = 8; signed = false; map = clock.default.value;\n" <<
+          "} := uint64_clock_default_t;\n\n" <<
+          "trace {\n" <<
+          "    major = 1;\n" <<
+          "    minor = 8;\n" <<
+          "    byte_order = le;\n" <<
+          "    packet.header := struct {\n" <<
+          "        uint32_t magic;\n" <<
+          "        uint32_t stream_id;\n" <<
+          "    };\n" <<
+          "};\n\n" <<
+          "clock {\n" <<
+          "    name = default;\n" <<
+          "    freq = 1000000000;\n" <<
+          "    offset_s = 1546300800;\n" <<
+          "};\n\n" <<
+          "stream {\n" <<
+          "    id = 0;\n" <<
+          "    packet.context := struct {\n" <<
+          "        uint64_clock_default_t timestamp_begin;\n" <<
+          "        uint64_clock_default_t timestamp_end;\n" <<
+          "        uint64_t packet_size;\n" <<
+          "        uint64_t content_size;\n" <<
+          "        uint64_t events_discarded;\n" <<
+          "        uint64_t packet_seq_num;\n" <<
+          "    };\n" <<
+          "    event.header := struct {\n" <<
+          "        uint32_t id;\n" <<
+          "        uint64_clock_default_t timestamp;\n" <<
+          "    };\n" <<
+          "};\n";
+
+    for (Index ertId = 0; ertId < params.ertCount; ++ertId) {
+        ss << "\nevent {\n" <<
+              "    name = \"bench:event_" << ertId << "\";\n" <<
+              "    id = " << ertId << ";\n" <<
+              "    stream_id = 0;\n" <<
+              "    fields := struct {\n" <<
+              "        uint64_t seq;\n" <<
+              "        uint32_t value;\n" <<
+              "        string msg;\n" <<
+              "    };\n" <<
+              "};\n";
+    }
+
+    return ss.str();
+}
+
+// writes the `lenBytes` least significant bytes of `val` (little-endian)
+void writeLe(std::uint8_t * const buf, const std::uint64_t val, const Size lenBytes) noexcept
+{
+    for (Index i = 0; i < lenBytes; ++i) {
+        buf[i] = static_cast<std::uint8_t>(val >> (i * 8));
+    }
+}
+
+// 64-bit linear congruential generator (MMIX constants)
+class Lcg final
+{
+public:
+    explicit Lcg(const std::uint64_t seed) noexcept :
+        _state {seed}
+    {
+    }
+
+    std::uint64_t next() noexcept
+    {
+        _state = _state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return _state >> 16;
+    }
+
+private:
+    std::uint64_t _state;
+};
+
+class DsFileWriter final
+{
+public:
+    explicit DsFileWriter(const SynthTraceParams& params, const Index dsFileIndex) :
+        _params {&params},
+        _dsFileIndex {dsFileIndex},
+        _erCountPerPkt {(params.pktLenBytes - synthPktPreambleLenBytes) / params.erLenBytes},
+        _rng {dsFileIndex + 1},
+        _pktBuf(params.pktLenBytes),
+        _ts {dsFileIndex}
+    {
+        assert(_erCountPerPkt > 0);
+    }
+
+    /*
+     * Writes the packets of this data stream file to `path`, corrupting
+     * the packets of which the global index (across all the data stream
+     * files) is such that `isCorruptFunc()` returns true.
+     */
+    template <typename IsCorruptFuncT>
+    void write(const bfs::path& path, IsCorruptFuncT&& isCorruptFunc)
+    {
+        std::ofstream stream;
+
+        stream.exceptions(std::ios::badbit | std::ios::failbit);
+
+        try {
+            stream.open(path.c_str(), std::ios::binary);
+
+            for (Index pktIndex = 0; pktIndex < _params->pktCountPerDsFile; ++pktIndex) {
+                const auto globalPktIndex = _dsFileIndex * _params->pktCountPerDsFile + pktIndex;
+
+                this->_fillPkt(pktIndex, isCorruptFunc(globalPktIndex));
+                stream.write(reinterpret_cast<const char *>(_pktBuf.data()), _pktBuf.size());
+            }
+
+            stream.close();
+        } catch (const std::ios_base::failure&) {
+            throw IOError {path, "Cannot write file."};
+        }
+    }
+
+    Size erCount() const noexcept
+    {
+        return _erCountPerPkt * _params->pktCountPerDsFile;
+    }
+
+private:
+    void _fillPkt(const Index pktIndex, const bool isCorrupt)
+    {
+        const auto buf = _pktBuf.data();
+        const auto contentLenBytes = synthPktPreambleLenBytes +
+                                     _erCountPerPkt * _params->erLenBytes;
+        const auto msgLen = _params->erLenBytes - minSynthErLenBytes;
+        const auto beginTs = _ts;
+        auto at = buf + synthPktPreambleLenBytes;
+
+        for (Index erIndex = 0; erIndex < _erCountPerPkt; ++erIndex) {
+            const auto rand = _rng.next();
+            auto ertId = static_cast<std::uint32_t>(rand % _params->ertCount);
+
+            if (isCorrupt && erIndex == _erCountPerPkt / 2) {
+                ertId = corruptErtId;
+            }
+
+            writeLe(at, ertId, 4);
+            writeLe(at + 4, _ts, 8);
+            writeLe(at + 12, _seq, 8);
+            writeLe(at + 20, rand >> 8, 4);
+            at += erHeaderLenBytes + erFixedPayloadLenBytes;
+
+            for (Index i = 0; i < msgLen; ++i) {
+                *at = static_cast<std::uint8_t>('a' + (_seq + i) % 26);
+                ++at;
+            }
+
+            *at = 0;
+            ++at;
+            _ts += erTsStep;
+            ++_seq;
+        }
+
+        assert(at == buf + contentLenBytes);
+        std::fill(at, buf + _pktBuf.size(), 0);
+        writeLe(buf, 0xc1fc1fc1U, 4);
+        writeLe(buf + 4, 0, 4);
+        writeLe(buf + 8, beginTs, 8);
+        writeLe(buf + 16, _ts - erTsStep, 8);
+        writeLe(buf + 24, _params->pktLenBytes * 8, 8);
+        writeLe(buf + 32, contentLenBytes * 8, 8);
+        writeLe(buf + 40, 0, 8);
+        writeLe(buf + 48, pktIndex, 8);
+    }
+
+private:
+    const SynthTraceParams *_params;
+    Index _dsFileIndex;
+    Size _erCountPerPkt;
+    Lcg _rng;
+    std::vector<std::uint8_t> _pktBuf;
+
+    // starts at the data stream file index to interleave data streams
+    std::uint64_t _ts;
+
+    std::uint64_t _seq = 0;
+};
+
+} // namespace
+
+SynthTraceInfo writeSynthTrace(const bfs::path& traceDir, const SynthTraceParams& params)
+{
+    assert(params.dsFileCount > 0);
+    assert(params.pktCountPerDsFile > 0);
+    assert(params.ertCount > 0);
+    assert(params.erLenBytes >= minSynthErLenBytes);
+    assert(params.pktLenBytes >= synthPktPreambleLenBytes + params.erLenBytes);
+
+    {
+        const auto metadataPath = traceDir / "metadata";
+        std::ofstream stream;
+
+        stream.exceptions(std::ios::badbit | std::ios::failbit);
+
+        try {
+            stream.open(metadataPath.c_str());
+            stream << metadataText(params);
+            stream.close();
+        } catch (const std::ios_base::failure&) {
+            throw IOError {metadataPath, "Cannot write file."};
+        }
+    }
+
+    const auto pktCount = params.dsFileCount * params.pktCountPerDsFile;
+
+    /*
+     * Corrupt exactly `params.corruptPktCount` packets, evenly spread:
+     * the packet `globalPktIndex` is corrupt when it's the first one
+     * after a multiple of `pktCount / params.corruptPktCount`.
+     */
+    const auto isCorruptFunc = [&params, pktCount](const Index globalPktIndex) {
+        return (globalPktIndex + 1) * params.corruptPktCount / pktCount >
+               globalPktIndex * params.corruptPktCount / pktCount;
+    };
+
+    SynthTraceInfo info {pktCount, 0, pktCount * params.pktLenBytes};
+
+    for (Index dsFileIndex = 0; dsFileIndex < params.dsFileCount; ++dsFileIndex) {
+        DsFileWriter writer {params, dsFileIndex};
+
+        writer.write(traceDir / ("stream_" + std::to_string(dsFileIndex)), isCorruptFunc);
+        info.erCount += writer.erCount();
+    }
+
+    return info;
+}
+
+} // namespace jacques
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#ifndef _JACQUES_SYNTH_TRACE_WRITER_HPP
+#define _JACQUES_SYNTH_TRACE_WRITER_HPP
+
+#include <boost/filesystem.hpp>
+
+#include "aliases.hpp"
+
+namespace jacques {
+
+// shape of a synthetic trace
+struct SynthTraceParams
+{
+    // number of data stream files
+    Size dsFileCount;
+
+    // number of packets per data stream file
+    Size pktCountPerDsFile;
+
+    // total length of each packet
+    Size pktLenBytes;
+
+    // number of event record types
+    Size ertCount;
+
+    // total length of each event record (at least minErLenBytes)
+    Size erLenBytes;
+
+    /*
+     * Number of packets, evenly spread over all the data stream files,
+     * of which an event record has an unknown type ID (decoding error).
+     */
+    Size corruptPktCount;
+};
+
+// what writeSynthTrace() wrote
+struct SynthTraceInfo
+{
+    Size pktCount;
+    Size erCount;
+    Size dsFilesLenBytes;
+};
+
+// length of the packet header and context of a synthetic packet
+constexpr Size synthPktPreambleLenBytes = 56;
+
+// minimal length of a synthetic event record (empty string field)
+constexpr Size minSynthErLenBytes = 25;
+
+/*
+ * Writes a synthetic CTF 1.8 trace having the shape `params` to the
+ * existing directory `traceDir`: a `metadata` file and
+ * `params.dsFileCount` data stream files named `stream_N`.
+ *
+ * The trace is deterministic: the same parameters always produce the
+ * same files.
+ *
+ * `params.pktLenBytes` must be at least `synthPktPreambleLenBytes +
+ * params.erLenBytes`.
+ *
+ * Throws IOError on I/O error.
+ */
+SynthTraceInfo writeSynthTrace(const boost::filesystem::path& traceDir,
+                               const SynthTraceParams& params);
+
+} // namespace jacques
+
+#endif // _JACQUES_SYNTH_TRACE_WRITER_HPP
@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <sstream>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <boost/core/noncopyable.hpp>
+
+#ifdef __linux__
+# include <sys/sendfile.h>
+#endif
+
+#include "cfg.hpp"
+#include "trim-cmd.hpp"
+#include "cmd-error.hpp"
+#include "io-error.hpp"
+#include "lttng-index-writer.hpp"
+#include "data/trace.hpp"
+#include "data/metadata-intern-table.hpp"
+#include "data/ds-file.hpp"
+
+#if defined(__linux__) && defined(__GLIBC__) && \
+        (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+# define JACQUES_HAS_COPY_FILE_RANGE
+#endif
+
+namespace jacques {
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+/*
+ * Path of `path` relative to the directory `baseDir`, `path` being
+ * somewhere within `baseDir`.
+ */
+bfs::path relPath(const bfs::path& path, const bfs::path& baseDir)
+{
+    std::vector<bfs::path> baseDirParts;
+
+    for (const auto& part : baseDir) {
+        if (part != ".") {
+            baseDirParts.push_back(part);
+        }
+    }
+
+    auto it = path.begin();
+
+    for (Index i = 0; i < baseDirParts.size(); ++i) {
+        while (it != path.end() && *it == ".") {
+            ++it;
+        }
+
+        assert(it != path.end());
+        assert(*it == baseDirParts[i]);
+        ++it;
+    }
+
+    bfs::path rel;
+
+    for (; it != path.end(); ++it) {
+        rel /= *it;
+    }
+
+    return rel;
+}
+
+// RAII file descriptor
+class Fd final :
+    boost::noncopyable
+{
+public:
+    explicit Fd(const bfs::path& path, const int flags) :
+        _fd {::open(path.c_str(), flags, 0644)}
+    {
+        if (_fd < 0) {
+            throw IOError {path, std::string {"Cannot open file: "} + std::strerror(errno)};
+        }
+    }
+
+    ~Fd()
+    {
+        ::close(_fd);
+    }
+
+    int fd() const noexcept
+    {
+        return _fd;
+    }
+
+private:
+    int _fd;
+};
+
+/*
+ * Copies the `len` bytes at the offset `offset` of the file `src` to
+ * the current position of the file `dst`.
+ *
+ * Tries copy_file_range(), which doesn't copy anything through user
+ * space (and can even share the extents on some file systems), then
+ * sendfile(), and finally falls back to reading and writing.
+ */
+void copyRange(const Fd& src, const bfs::path& srcPath, const Index offset, const Size len,
+               const Fd& dst, const bfs::path& dstPath)
+{
+    auto curOffset = static_cast<off_t>(offset);
+    auto remLen = len;
+
+#ifdef JACQUES_HAS_COPY_FILE_RANGE
+    while (remLen > 0) {
+        loff_t srcOffset = curOffset;
+        const auto ret = ::copy_file_range(src.fd(), &srcOffset, dst.fd(), nullptr, remLen, 0);
+
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP) {
+                // not supported here: try the next method
+                break;
+            }
+
+            throw IOError {dstPath, std::string {"Cannot copy data: "} + std::strerror(errno)};
+        }
+
+        if (ret == 0) {
+            throw IOError {srcPath, "Unexpected end of file."};
+        }
+
+        curOffset += ret;
+        remLen -= static_cast<Size>(ret);
+    }
+#endif
+
+#ifdef __linux__
+    while (remLen > 0) {
+        const auto ret = ::sendfile(dst.fd(), src.fd(), &curOffset, remLen);
+
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == ENOSYS || errno == EINVAL) {
+                // not supported here: try the next method
+                break;
+            }
+
+            throw IOError {dstPath, std::string {"Cannot copy data: "} + std::strerror(errno)};
+        }
+
+        if (ret == 0) {
+            throw IOError {srcPath, "Unexpected end of file."};
+        }
+
+        remLen -= static_cast<Size>(ret);
+    }
+#endif
+
+    if (remLen == 0) {
+        return;
+    }
+
+    std::vector<char> buf(std::min(remLen, static_cast<Size>(1 << 20)));
+
+    while (remLen > 0) {
+        const auto readRet = ::pread(src.fd(), buf.data(),
+                                     std::min(remLen, static_cast<Size>(buf.size())),
+                                     curOffset);
+
+        if (readRet < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            throw IOError {srcPath, std::string {"Cannot read file: "} + std::strerror(errno)};
+        }
+
+        if (readRet == 0) {
+            throw IOError {srcPath, "Unexpected end of file."};
+        }
+
+        Index bufOffset = 0;
+
+        while (bufOffset < static_cast<Index>(readRet)) {
+            const auto writeRet = ::write(dst.fd(), buf.data() + bufOffset,
+                                          static_cast<Size>(readRet) - bufOffset);
+
+            if (writeRet < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                throw IOError {dstPath, std::string {"Cannot write file: "} +
+                                        std::strerror(errno)};
+            }
+
+            bufOffset += static_cast<Index>(writeRet);
+        }
+
+        curOffset += readRet;
+        remLen -= static_cast<Size>(readRet);
+    }
+}
+
+/*
+ * Trims the data stream file `dsFile` to the packets which overlap the
+ * time range of `cfg`, writing the resulting data stream file and its
+ * LTTng index under the output directory.
+ */
+void trimDsFile(DsFile& dsFile, const TrimCfg& cfg)
+{
+    if (dsFile.isCompressed()) {
+        std::ostringstream ss;
+
+        ss << "Cannot trim compressed data stream file `" << dsFile.path().string() << "`.";
+        throw CmdError {ss.str()};
+    }
+
+    dsFile.buildIndex();
+
+    // bisect: never decode a packet
+    const auto range = dsFile.pktIndexRangeOverlappingNsFromOrigin(cfg.beginNsFromOrigin(),
+                                                                   cfg.endNsFromOrigin());
+
+    if (range.first == range.second) {
+        // nothing to keep
+        return;
+    }
+
+    const auto outDir = cfg.outDir() / relPath(dsFile.path().parent_path(), cfg.traceDir());
+    const auto outPath = outDir / dsFile.path().filename();
+    const auto indexDir = outDir / "index";
+
+    bfs::create_directories(indexDir);
+
+    const Fd src {dsFile.path(), O_RDONLY};
+    const Fd dst {outPath, O_WRONLY | O_CREAT | O_TRUNC};
+    LttngIndexWriter indexWriter {
+        indexDir / (dsFile.path().filename().string() + ".idx"),
+        LttngIndexWriter::canHave11Addon(dsFile.decodedPktIndexEntry(range.first))
+    };
+
+    // copy runs of contiguous packets at once
+    Index runOffsetBytes = 0;
+    Size runLenBytes = 0;
+    Index outOffsetBytes = 0;
+
+    for (auto pktIndex = range.first; pktIndex < range.second; ++pktIndex) {
+        const auto entry = dsFile.decodedPktIndexEntry(pktIndex);
+        const auto lenBytes = entry.effectiveTotalLen().bytes();
+
+        if (runLenBytes > 0 && entry.offsetInDsFileBytes() != runOffsetBytes + runLenBytes) {
+            copyRange(src, dsFile.path(), runOffsetBytes, runLenBytes, dst, outPath);
+            runLenBytes = 0;
+        }
+
+        if (runLenBytes == 0) {
+            runOffsetBytes = entry.offsetInDsFileBytes();
+        }
+
+        runLenBytes += lenBytes;
+        indexWriter.write(entry, outOffsetBytes);
+        outOffsetBytes += lenBytes;
+    }
+
+    copyRange(src, dsFile.path(), runOffsetBytes, runLenBytes, dst, outPath);
+    indexWriter.close();
+}
+
+} // namespace
+
+void trimCmd(const TrimCfg& cfg)
+{
+    // trace directory to set of data stream file paths
+    std::map<bfs::path, std::vector<bfs::path>> groupedDsFilePaths;
+
+    for (auto& dsfPath : cfg.dsFilePaths()) {
+        groupedDsFilePaths[dsfPath.parent_path()].push_back(dsfPath);
+    }
+
+    // parse the distinct metadata of all the traces in parallel
+    {
+        std::vector<bfs::path> metadataPaths;
+
+        for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+            metadataPaths.push_back(traceDirDsFilePathsPair.first / "metadata");
+        }
+
+        MetadataInternTable::instance().preload(metadataPaths, cfg.threadCount());
+    }
+
+    std::vector<std::unique_ptr<Trace>> traces;
+    std::vector<DsFile *> dsFiles;
+
+    for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+        const auto& traceDir = traceDirDsFilePathsPair.first;
+        const auto outDir = cfg.outDir() / relPath(traceDir, cfg.traceDir());
+
+        traces.push_back(std::make_unique<Trace>(traceDirDsFilePathsPair.second));
+
+        for (auto& dsf : traces.back()->dsFiles()) {
+            dsFiles.push_back(dsf.get());
+        }
+
+        // copy metadata, even if no packet of this trace remains
+        bfs::create_directories(outDir);
+        bfs::copy_file(traceDir / "metadata", outDir / "metadata");
+    }
+
+    // one data stream file per unit: each one has its own output file
+    auto threadCount = static_cast<Size>(cfg.threadCount());
+
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    threadCount = std::max(std::min(threadCount, static_cast<Size>(dsFiles.size())),
+                           static_cast<Size>(1));
+
+    std::atomic<Index> nextDsFile {0};
+    std::atomic_bool isCanceled {false};
+    std::mutex excMutex;
+    std::exception_ptr exc;
+    std::vector<std::thread> threads;
+
+    for (Index i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&] {
+            while (!isCanceled) {
+                const auto dsFileIndex = nextDsFile++;
+
+                if (dsFileIndex >= dsFiles.size()) {
+                    break;
+                }
+
+                try {
+                    trimDsFile(*dsFiles[dsFileIndex], cfg);
+                } catch (...) {
+                    // keep the first error and stop
+                    std::lock_guard<std::mutex> lock {excMutex};
+
+                    if (!exc) {
+                        exc = std::current_exception();
+                    }
+
+                    isCanceled = true;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (exc) {
+        std::rethrow_exception(exc);
+    }
+}
+
+} // namespace jacques
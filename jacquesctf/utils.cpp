@@ -56,70 +56,141 @@ std::pair<std::string, std::string> formatPath(const bfs::path& path, const Size
 
 namespace {
 
-inline long long abs(const long long val) noexcept
+// "00" to "99", to write two digits at once
+constexpr char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*
+ * Writes the decimal digits of `val`, at least `minDigits` of them,
+ * backwards from `bufEnd` (excluded), and returns a pointer to the
+ * first written digit.
+ */
+char *writeDigitsBackwards(char *bufEnd, unsigned long long val,
+                           const unsigned int minDigits) noexcept
 {
-    return std::abs(val);
+    const auto end = bufEnd;
+
+    while (val >= 100) {
+        const auto pair = &digitPairs[(val % 100) * 2];
+
+        val /= 100;
+        *--bufEnd = pair[1];
+        *--bufEnd = pair[0];
+    }
+
+    if (val >= 10) {
+        const auto pair = &digitPairs[val * 2];
+
+        *--bufEnd = pair[1];
+        *--bufEnd = pair[0];
+    } else {
+        *--bufEnd = static_cast<char>('0' + val);
+    }
+
+    while (static_cast<unsigned int>(end - bufEnd) < minDigits) {
+        *--bufEnd = '0';
+    }
+
+    return bufEnd;
 }
 
-inline unsigned long long abs(const unsigned long long val) noexcept
+/*
+ * Writes `val` with at least `minDigits` digits and the separator `sep`
+ * every three digits, followed by a null character, to `buf`, and
+ * returns the number of written characters (excluding the null
+ * character).
+ */
+Size writeSepUInt(char * const buf, const unsigned long long val, const char sep,
+                  const unsigned int minDigits = 0) noexcept
 {
-    return val;
+    std::array<char, 32> digits;
+    const auto digitsEnd = digits.data() + digits.size();
+    const auto digitsBegin = writeDigitsBackwards(digitsEnd, val, minDigits);
+    const auto digitCount = static_cast<Size>(digitsEnd - digitsBegin);
+    auto bufAt = buf;
+
+    for (Index i = 0; i < digitCount; ++i) {
+        if (i > 0 && (digitCount - i) % 3 == 0) {
+            *bufAt++ = sep;
+        }
+
+        *bufAt++ = digitsBegin[i];
+    }
+
+    *bufAt = '\0';
+    return static_cast<Size>(bufAt - buf);
 }
 
-template <typename ValT>
-std::string sepNumber(const ValT val, const char sep, const char * const fmt)
+unsigned long long absVal(const long long val) noexcept
 {
-    /*
-     * 1. Convert absolute value to string.
-     *
-     * 2. Create return string, iterate first string in reverse order,
-     *    and append separator every three characters.
-     *
-     * 3. Remove trailing separator if any.
-     *
-     * 4. Append `-` if the value is negative.
-     *
-     * 5. Reverse the whole string.
-     */
-    std::array<char, 64> buf;
-    const auto count = std::sprintf(buf.data(), fmt, abs(val));
-    Index i = 0;
-    std::string ret;
-
-    ret.reserve(count + count / 3 + 1);
+    // also valid for the minimum value
+    return (val < 0) ? 0ULL - static_cast<unsigned long long>(val) :
+           static_cast<unsigned long long>(val);
+}
 
-    for (auto at = count - 1; at >= 0; --at, ++i) {
-        const auto ch = buf[at];
+} // namespace
 
-        if (i % 3 == 0 && i != 0) {
-            ret += sep;
-        }
+Size formatUInt(char * const buf, const unsigned long long val,
+                const unsigned int minDigits) noexcept
+{
+    std::array<char, 32> digits;
+    const auto digitsEnd = digits.data() + digits.size();
+    const auto digitsBegin = writeDigitsBackwards(digitsEnd, val, minDigits);
+    const auto len = static_cast<Size>(digitsEnd - digitsBegin);
+
+    std::memcpy(buf, digitsBegin, len);
+    buf[len] = '\0';
+    return len;
+}
 
-        ret += ch;
+Size formatInt(char * const buf, const long long val) noexcept
+{
+    if (val < 0) {
+        buf[0] = '-';
+        return formatUInt(buf + 1, absVal(val)) + 1;
     }
 
-    if (ret.back() == sep) {
-        ret.pop_back();
-    }
+    return formatUInt(buf, absVal(val));
+}
 
+Size sepNumber(char * const buf, const long long val, const char sep) noexcept
+{
     if (val < 0) {
-        ret += '-';
+        buf[0] = '-';
+        return writeSepUInt(buf + 1, absVal(val), sep) + 1;
     }
 
-    std::reverse(ret.begin(), ret.end());
-    return ret;
+    return writeSepUInt(buf, absVal(val), sep);
 }
 
-} // namespace
+Size sepNumber(char * const buf, const unsigned long long val, const char sep) noexcept
+{
+    return writeSepUInt(buf, val, sep);
+}
 
 std::string sepNumber(const long long val, const char sep)
 {
-    return sepNumber(val, sep, "%lld");
+    std::array<char, 32> buf;
+
+    sepNumber(buf.data(), val, sep);
+    return buf.data();
 }
 
 std::string sepNumber(const unsigned long long val, const char sep)
 {
-    return sepNumber(val, sep, "%llu");
+    std::array<char, 32> buf;
+
+    sepNumber(buf.data(), val, sep);
+    return buf.data();
 }
 
 std::string wrapText(const std::string& text, const Size lineLen)
@@ -170,8 +241,8 @@ std::string normalizeGlobPattern(const std::string& pattern)
 
     normPat.reserve(pattern.size());
 
-    for (const auto patCh : pattern) {
-        switch (patCh) {
+    for (auto it = pattern.begin(); it != pattern.end(); ++it) {
+        switch (*it) {
         case '*':
             if (gotStar) {
                 // avoid consecutive stars
@@ -181,13 +252,24 @@ std::string normalizeGlobPattern(const std::string& pattern)
             gotStar = true;
             break;
 
+        case '\\':
+            // copy escaped character as is: an escaped star isn't a star
+            gotStar = false;
+
+            if (it + 1 != pattern.end()) {
+                normPat += *it;
+                ++it;
+            }
+
+            break;
+
         default:
             gotStar = false;
             break;
         }
 
         /* Copy single character. */
-        normPat += patCh;
+        normPat += *it;
     }
 
     return normPat;
@@ -292,36 +374,57 @@ endOfPattern:
     return p[-1] == '*' && atEndOfPattern(p, pattern);
 }
 
-std::pair<std::string, std::string> formatLen(const Size lenBits, const LenFmtMode fmtMode,
-                                              const boost::optional<char>& sep)
+const char *formatLen(char * const buf, const Size lenBits, const LenFmtMode fmtMode,
+                      const boost::optional<char>& sep) noexcept
 {
-    std::array<char, 64> buf;
     const char *unit = nullptr;
     const auto sizeBytes = lenBits / 8;
     const auto extraBits = lenBits & 7;
+    auto bufAt = buf;
 
     switch (fmtMode) {
     case LenFmtMode::FULL_FLOOR:
     case LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS:
     {
         unit = "B";
-        double val = static_cast<double>(sizeBytes);
+        unsigned long long divisor = 1;
 
         if (sizeBytes >= 1024 * 1024 * 1024) {
-            val = static_cast<double>(sizeBytes) / (1024. * 1024 * 1024);
+            divisor = 1024 * 1024 * 1024;
             unit = "GiB";
         } else if (sizeBytes >= 1024 * 1024) {
-            val = static_cast<double>(sizeBytes) / (1024. * 1024);
+            divisor = 1024 * 1024;
             unit = "MiB";
         } else if (sizeBytes >= 1024) {
-            val = static_cast<double>(sizeBytes) / 1024.;
+            divisor = 1024;
             unit = "KiB";
         }
 
+        /*
+         * Thousandths of the value, rounded to nearest, ties to even,
+         * like printf()'s `%.3f` does with the exact binary value.
+         */
+        auto whole = sizeBytes / divisor;
+        const auto num = (sizeBytes % divisor) * 1000;
+        auto thousandths = num / divisor;
+        const auto twiceRem = (num % divisor) * 2;
+
+        if (twiceRem > divisor || (twiceRem == divisor && (thousandths & 1))) {
+            ++thousandths;
+
+            if (thousandths == 1000) {
+                ++whole;
+                thousandths = 0;
+            }
+        }
+
+        bufAt += formatUInt(bufAt, whole);
+        *bufAt++ = '.';
+        bufAt += formatUInt(bufAt, thousandths, 3);
+
         if (fmtMode == LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS && extraBits > 0) {
-            std::sprintf(buf.data(), "%.3f+%llu", val, extraBits);
-        } else {
-            std::sprintf(buf.data(), "%.3f", val);
+            *bufAt++ = '+';
+            bufAt += formatUInt(bufAt, extraBits);
         }
 
         break;
@@ -331,22 +434,15 @@ std::pair<std::string, std::string> formatLen(const Size lenBits, const LenFmtMo
     case LenFmtMode::BYTES_FLOOR_WITH_EXTRA_BITS:
         unit = "B";
 
-        if (fmtMode == LenFmtMode::BYTES_FLOOR_WITH_EXTRA_BITS && extraBits > 0) {
-            if (sep) {
-                const auto sepNum = sepNumber(static_cast<long long>(sizeBytes), *sep);
-
-                std::sprintf(buf.data(), "%s+%llu", sepNum.c_str(), extraBits);
-            } else {
-                std::sprintf(buf.data(), "%llu+%llu", sizeBytes, extraBits);
-            }
+        if (sep) {
+            bufAt += writeSepUInt(bufAt, sizeBytes, *sep);
         } else {
-            if (sep) {
-                const auto sepNum = sepNumber(static_cast<long long>(sizeBytes), *sep);
+            bufAt += formatUInt(bufAt, sizeBytes);
+        }
 
-                std::strcpy(buf.data(), sepNum.c_str());
-            } else {
-                std::sprintf(buf.data(), "%llu", sizeBytes);
-            }
+        if (fmtMode == LenFmtMode::BYTES_FLOOR_WITH_EXTRA_BITS && extraBits > 0) {
+            *bufAt++ = '+';
+            bufAt += formatUInt(bufAt, extraBits);
         }
 
         break;
@@ -355,38 +451,55 @@ std::pair<std::string, std::string> formatLen(const Size lenBits, const LenFmtMo
         unit = "b";
 
         if (sep) {
-            const auto sepNum = sepNumber(static_cast<long long>(lenBits), *sep);
-
-            std::strcpy(buf.data(), sepNum.c_str());
+            bufAt += writeSepUInt(bufAt, lenBits, *sep);
         } else {
-            std::sprintf(buf.data(), "%llu", lenBits);
+            bufAt += formatUInt(bufAt, lenBits);
         }
 
         break;
     }
 
+    *bufAt = '\0';
     assert(unit);
+    return unit;
+}
+
+std::pair<std::string, std::string> formatLen(const Size lenBits, const LenFmtMode fmtMode,
+                                              const boost::optional<char>& sep)
+{
+    std::array<char, 64> buf;
+    const auto unit = formatLen(buf.data(), lenBits, fmtMode, sep);
+
     return {buf.data(), unit};
 }
 
-std::pair<std::string, std::string> formatNs(long long ns, const boost::optional<char>& sep)
+std::pair<Size, Size> formatNs(char * const secsBuf, char * const nsBuf, const long long ns,
+                               const boost::optional<char>& sep) noexcept
 {
-    constexpr auto nsInS = 1'000'000'000LL;
-    const auto absNs = std::abs(ns);
-    const auto absSOnly = (absNs / nsInS);
+    constexpr auto nsInS = 1'000'000'000ULL;
+    const auto absNs = absVal(ns);
+    const auto absSOnly = absNs / nsInS;
     const auto nsOnly = absNs % nsInS;
-    std::string sStr;
+    auto secsBufAt = secsBuf;
 
     if (ns < 0) {
-        sStr = "-";
+        *secsBufAt++ = '-';
     }
 
-    sStr += sep ? sepNumber(absSOnly, *sep) : std::to_string(absSOnly);
+    secsBufAt += sep ? writeSepUInt(secsBufAt, absSOnly, *sep) : formatUInt(secsBufAt, absSOnly);
+
+    const auto nsLen = sep ? writeSepUInt(nsBuf, nsOnly, *sep, 9) : formatUInt(nsBuf, nsOnly);
+
+    return {static_cast<Size>(secsBufAt - secsBuf), nsLen};
+}
 
-    const auto nsStr = sep ? sepNumber(nsOnly, *sep, "%09llu") :
-                       std::to_string(nsOnly);
+std::pair<std::string, std::string> formatNs(const long long ns, const boost::optional<char>& sep)
+{
+    std::array<char, 32> secsBuf;
+    std::array<char, 32> nsBuf;
 
-    return {sStr, nsStr};
+    formatNs(secsBuf.data(), nsBuf.data(), ns, sep);
+    return {secsBuf.data(), nsBuf.data()};
 }
 
 void printTextParseError(std::ostream& os, const std::string& path,
@@ -452,6 +565,90 @@ std::string escapeStr(const std::string& str)
     return outStr;
 }
 
+void appendJsonStr(std::string& out, const char * const str, const Size len)
+{
+    out += '"';
+
+    for (Index i = 0; i < len; ++i) {
+        const auto ich = str[i];
+        const auto uch = static_cast<std::uint8_t>(ich);
+
+        switch (ich) {
+        case '"':
+            out += "\\\"";
+            break;
+
+        case '\\':
+            out += "\\\\";
+            break;
+
+        case '\n':
+            out += "\\n";
+            break;
+
+        case '\r':
+            out += "\\r";
+            break;
+
+        case '\t':
+            out += "\\t";
+            break;
+
+        default:
+            if (uch < 32) {
+                std::array<char, 8> buf;
+
+                std::sprintf(buf.data(), "\\u%04x", static_cast<unsigned int>(uch));
+                out += buf.data();
+            } else {
+                out += ich;
+            }
+        }
+    }
+
+    out += '"';
+}
+
+std::string jsonStr(const std::string& str)
+{
+    std::string outStr;
+
+    appendJsonStr(outStr, str.data(), str.size());
+    return outStr;
+}
+
+void appendCsvField(std::string& out, const char * const str, const Size len)
+{
+    const auto end = str + len;
+
+    if (std::find_if(str, end, [](const char ch) {
+        return ch == ',' || ch == '"' || ch == '\r' || ch == '\n';
+    }) == end) {
+        out.append(str, len);
+        return;
+    }
+
+    out += '"';
+
+    for (auto ch = str; ch != end; ++ch) {
+        if (*ch == '"') {
+            out += '"';
+        }
+
+        out += *ch;
+    }
+
+    out += '"';
+}
+
+std::string csvField(const std::string& str)
+{
+    std::string outStr;
+
+    appendCsvField(outStr, str.data(), str.size());
+    return outStr;
+}
+
 bool isHiddenFile(const bfs::path& path)
 {
     return !path.filename().string().empty() && path.filename().string()[0] == '.';
@@ -49,6 +49,9 @@ std::string normalizeGlobPattern(const std::string& pattern);
 /*
  * Returns whether or not `candidate` matches the globbing pattern
  * `pattern`. Only the `*` special character works as of this version.
+ *
+ * `pattern` must be normalized (see normalizeGlobPattern()). To match
+ * many candidates, prefer a compiled GlobPattern.
  */
 bool globMatch(const std::string& pattern, const std::string& candidate);
 
@@ -68,6 +71,26 @@ std::vector<std::string> wrapTextLines(const std::string& text, Size lineLen);
  */
 std::string escapeStr(const std::string& str);
 
+/*
+ * Returns the JSON string literal (including the double quotes) of the
+ * UTF-8 string `str`.
+ */
+std::string jsonStr(const std::string& str);
+
+/*
+ * Returns `str` as a CSV field, double-quoting it only when needed.
+ */
+std::string csvField(const std::string& str);
+
+/*
+ * Like jsonStr() and csvField(), but append to `out` the encoded
+ * version of the `len` characters at `str`.
+ *
+ * The export command uses them for each field of each event record.
+ */
+void appendJsonStr(std::string& out, const char *str, Size len);
+void appendCsvField(std::string& out, const char *str, Size len);
+
 /*
  * Creates a string which has "thousands separators" from a value,
  * like so:
@@ -78,6 +101,21 @@ std::string escapeStr(const std::string& str);
 std::string sepNumber(long long val, char sep = ' ');
 std::string sepNumber(unsigned long long val, char sep = ' ');
 
+/*
+ * Allocation-free versions of the formatting functions: they write to
+ * the caller-provided buffer `buf` (32 characters are always enough)
+ * and return the number of written characters, excluding the
+ * terminating null character.
+ *
+ * Table views use them for each visible cell on each redraw.
+ */
+Size sepNumber(char *buf, long long val, char sep = ' ') noexcept;
+Size sepNumber(char *buf, unsigned long long val, char sep = ' ') noexcept;
+Size formatInt(char *buf, long long val) noexcept;
+
+// zero-pads to at least `minDigits` digits
+Size formatUInt(char *buf, unsigned long long val, unsigned int minDigits = 0) noexcept;
+
 /*
  * Returns whether or not the path `path` identifies a hidden
  * file/directory.
@@ -124,6 +162,22 @@ std::pair<std::string, std::string> formatLen(Size lenBits,
 std::pair<std::string, std::string> formatNs(long long ns,
                                              const boost::optional<char>& sep = boost::none);
 
+/*
+ * Like formatLen() above, but writes the quantity to `buf` (32
+ * characters are always enough) and returns the (static) unit string.
+ */
+const char *formatLen(char *buf, Size lenBits,
+                      LenFmtMode fmtMode = LenFmtMode::FULL_FLOOR_WITH_EXTRA_BITS,
+                      const boost::optional<char>& sep = boost::none) noexcept;
+
+/*
+ * Like formatNs() above, but writes the seconds and nanoseconds parts
+ * to `secsBuf` and `nsBuf` (32 characters each are always enough) and
+ * returns their lengths.
+ */
+std::pair<Size, Size> formatNs(char *secsBuf, char *nsBuf, long long ns,
+                               const boost::optional<char>& sep = boost::none) noexcept;
+
 void printTextParseError(std::ostream& os, const std::string& path,
                          const yactfr::TextParseError& error);
 
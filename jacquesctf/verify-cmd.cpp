@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2019 Philippe Proulx <eepp.ca> - All Rights Reserved
+ *
+ * Unauthorized copying of this file, via any medium, is strictly
+ * prohibited. Proprietary and confidential.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <boost/optional.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <yactfr/yactfr.hpp>
+
+#include "cfg.hpp"
+#include "verify-cmd.hpp"
+#include "cmd-error.hpp"
+#include "io-error.hpp"
+#include "data/trace.hpp"
+#include "data/metadata-intern-table.hpp"
+#include "data/ds-file.hpp"
+#include "data/data-len.hpp"
+#include "data/pkt-unit-scanner.hpp"
+
+namespace jacques {
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+// problem found within a packet of a data stream file
+struct Problem
+{
+    Index dsFileIndex;
+    Index pktIndex;
+    std::string msg;
+};
+
+/*
+ * Finds the problems of data stream files which need to decode the
+ * packets.
+ *
+ * Like the "find all" search, the verifier uses a packet unit scanner
+ * (see PktUnitScanner).
+ */
+class Verifier final :
+    boost::noncopyable
+{
+public:
+    explicit Verifier(const std::vector<const DsFile *>& dsFiles) :
+        _scanner {dsFiles, 4_MiB},
+        _unitProblems(_scanner.units().size())
+    {
+    }
+
+    // decodes all the packets with `threadCount` threads
+    void verify(const Size threadCount)
+    {
+        _scanner.run(threadCount, [this](const Index unitIndex, Index,
+                                         PktUnitScanner::WorkerIt& it) {
+            this->_verifyUnit(unitIndex, it);
+        });
+    }
+
+    // all the problems, sorted by data stream file and packet
+    std::vector<Problem> problems() const
+    {
+        std::vector<Problem> problems;
+
+        for (const auto& unitProblems : _unitProblems) {
+            problems.insert(problems.end(), unitProblems.begin(), unitProblems.end());
+        }
+
+        return problems;
+    }
+
+    Size decodedLenBytes() const noexcept
+    {
+        return _decodedLenBytes;
+    }
+
+private:
+    void _verifyUnit(const Index unitIndex, PktUnitScanner::WorkerIt& it)
+    {
+        const auto& unit = _scanner.units()[unitIndex];
+        const auto& dsFile = _scanner.dsFile(unit);
+
+        for (auto pktIndex = unit.beginPktIndex; pktIndex < unit.endPktIndex; ++pktIndex) {
+            const auto pktIndexEntry = dsFile.decodedPktIndexEntry(pktIndex);
+
+            if (pktIndexEntry.isInvalid()) {
+                // already reported from the index
+                continue;
+            }
+
+            this->_verifyPkt(_unitProblems[unitIndex], unit.dsFileIndex, dsFile, it,
+                             pktIndexEntry);
+            _decodedLenBytes += pktIndexEntry.effectiveTotalLen().bytes();
+        }
+    }
+
+    void _verifyPkt(std::vector<Problem>& problems, const Index dsFileIndex,
+                    const DsFile& dsFile, PktUnitScanner::WorkerIt& workerIt,
+                    const PktIndexEntry& pktIndexEntry)
+    {
+        boost::optional<unsigned long long> prevCycles;
+        const auto addProblem = [&](std::string msg) {
+            problems.push_back({dsFileIndex, pktIndexEntry.indexInDsFile(), std::move(msg)});
+        };
+
+        try {
+            auto& it = workerIt.seekPkt(dsFile, pktIndexEntry);
+
+            while (it->kind() != yactfr::Element::Kind::PACKET_END) {
+                if (it->kind() == yactfr::Element::Kind::DEFAULT_CLOCK_VALUE) {
+                    const auto cycles = it->asDefaultClockValueElement().cycles();
+
+                    if (prevCycles && cycles < *prevCycles) {
+                        std::ostringstream ss;
+
+                        ss << "Clock value goes backward at offset " << it.offset() <<
+                              " bits (" << *prevCycles << " to " << cycles << " cycles).";
+                        addProblem(ss.str());
+                    }
+
+                    prevCycles = cycles;
+                }
+
+                ++it;
+            }
+        } catch (const yactfr::DecodingError& exc) {
+            std::ostringstream ss;
+
+            ss << "Decoding error at offset " << exc.offset() << " bits: " <<
+                  exc.reason();
+            addProblem(ss.str());
+        } catch (const IOError& exc) {
+            // an unreadable packet is a problem of this packet too
+            addProblem(exc.what());
+        }
+    }
+
+private:
+    // same trade-off as the "find all" search
+    PktUnitScanner _scanner;
+
+    // per unit of `_scanner`
+    std::vector<std::vector<Problem>> _unitProblems;
+
+    std::atomic<Size> _decodedLenBytes {0};
+};
+
+/*
+ * Appends to `problems` the problems of the data stream file `dsFile`
+ * which its index reveals: invalid packets, sequence number gaps,
+ * discarded event records, and packet timestamps going backward.
+ */
+void addIndexProblems(std::vector<Problem>& problems, const Index dsFileIndex,
+                      const DsFile& dsFile)
+{
+    boost::optional<PktIndexEntry> prevEntry;
+
+    const auto addProblem = [&](const PktIndexEntry& entry, std::string msg) {
+        problems.push_back({dsFileIndex, entry.indexInDsFile(), std::move(msg)});
+    };
+
+    for (Index pktIndex = 0; pktIndex < dsFile.pktCount(); ++pktIndex) {
+        const auto entry = dsFile.decodedPktIndexEntry(pktIndex);
+
+        if (entry.isInvalid()) {
+            addProblem(entry, "Invalid packet (its header or context is erroneous, or it "
+                              "doesn't fit in the file).");
+        }
+
+        if (entry.beginTs() && entry.endTs() && *entry.endTs() < *entry.beginTs()) {
+            std::ostringstream ss;
+
+            ss << "End timestamp (" << entry.endTs()->nsFromOrigin() <<
+                  " ns) is less than beginning timestamp (" <<
+                  entry.beginTs()->nsFromOrigin() << " ns).";
+            addProblem(entry, ss.str());
+        }
+
+        if (prevEntry) {
+            if (prevEntry->seqNum() && entry.seqNum() &&
+                    *entry.seqNum() != *prevEntry->seqNum() + 1) {
+                std::ostringstream ss;
+
+                ss << "Sequence number gap: " << *prevEntry->seqNum() << " to " <<
+                      *entry.seqNum() << ".";
+                addProblem(entry, ss.str());
+            }
+
+            if (prevEntry->discErCounterSnap() && entry.discErCounterSnap() &&
+                    *entry.discErCounterSnap() != *prevEntry->discErCounterSnap()) {
+                std::ostringstream ss;
+
+                if (*entry.discErCounterSnap() > *prevEntry->discErCounterSnap()) {
+                    ss << *entry.discErCounterSnap() - *prevEntry->discErCounterSnap() <<
+                          " discarded event record(s).";
+                } else {
+                    ss << "Discarded event record counter wrapped (" <<
+                          *prevEntry->discErCounterSnap() << " to " <<
+                          *entry.discErCounterSnap() << ").";
+                }
+
+                addProblem(entry, ss.str());
+            }
+
+            if (prevEntry->endTs() && entry.beginTs() &&
+                    *entry.beginTs() < *prevEntry->endTs()) {
+                std::ostringstream ss;
+
+                ss << "Beginning timestamp (" << entry.beginTs()->nsFromOrigin() <<
+                      " ns) is less than the end timestamp of the previous packet (" <<
+                      prevEntry->endTs()->nsFromOrigin() << " ns).";
+                addProblem(entry, ss.str());
+            }
+        }
+
+        prevEntry.emplace(entry);
+    }
+}
+
+} // namespace
+
+void verifyCmd(const VerifyCfg& cfg)
+{
+    // trace directory to set of data stream file paths
+    std::map<bfs::path, std::vector<bfs::path>> groupedDsFilePaths;
+
+    for (auto& dsfPath : cfg.paths()) {
+        groupedDsFilePaths[dsfPath.parent_path()].push_back(dsfPath);
+    }
+
+    // parse the distinct metadata of all the traces in parallel
+    {
+        std::vector<bfs::path> metadataPaths;
+
+        for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+            metadataPaths.push_back(traceDirDsFilePathsPair.first / "metadata");
+        }
+
+        MetadataInternTable::instance().preload(metadataPaths, cfg.threadCount());
+    }
+
+    std::vector<std::unique_ptr<Trace>> traces;
+    std::vector<const DsFile *> dsFiles;
+
+    for (const auto& traceDirDsFilePathsPair : groupedDsFilePaths) {
+        traces.push_back(std::make_unique<Trace>(traceDirDsFilePathsPair.second));
+
+        for (auto& dsf : traces.back()->dsFiles()) {
+            dsf->buildIndex();
+            dsFiles.push_back(dsf.get());
+        }
+    }
+
+    Verifier verifier {dsFiles};
+
+    verifier.verify(cfg.threadCount());
+
+    std::vector<Problem> problems;
+
+    for (Index dsFileIndex = 0; dsFileIndex < dsFiles.size(); ++dsFileIndex) {
+        addIndexProblems(problems, dsFileIndex, *dsFiles[dsFileIndex]);
+    }
+
+    {
+        const auto decodingProblems = verifier.problems();
+
+        problems.insert(problems.end(), decodingProblems.begin(), decodingProblems.end());
+    }
+
+    /*
+     * Stable sort: within a given packet, the index problems, which
+     * come first in `problems`, remain before the decoding problems.
+     */
+    std::stable_sort(problems.begin(), problems.end(), [](const auto& a, const auto& b) {
+        return std::make_pair(a.dsFileIndex, a.pktIndex) <
+               std::make_pair(b.dsFileIndex, b.pktIndex);
+    });
+
+    for (const auto& problem : problems) {
+        const auto& dsFile = *dsFiles[problem.dsFileIndex];
+        const auto pktIndexEntry = dsFile.decodedPktIndexEntry(problem.pktIndex);
+
+        std::cout << dsFile.path().string() << ": packet " <<
+                     pktIndexEntry.natIndexInDsFile() << " (offset " <<
+                     pktIndexEntry.offsetInDsFileBytes() << " bytes): " <<
+                     problem.msg << std::endl;
+    }
+
+    Size pktCount = 0;
+
+    for (const auto dsFile : dsFiles) {
+        pktCount += dsFile->pktCount();
+    }
+
+    std::cout << "Verified " << dsFiles.size() << " data stream file(s), " << pktCount <<
+                 " packet(s), " << verifier.decodedLenBytes() << " byte(s): " <<
+                 problems.size() << " problem(s)." << std::endl;
+
+    if (!problems.empty()) {
+        std::ostringstream ss;
+
+        ss << "Found " << problems.size() << " problem(s).";
+        throw CmdError {ss.str()};
+    }
+}
+
+} // namespace jacques